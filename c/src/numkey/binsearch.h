@@ -48,6 +48,10 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // Account for Endianness
 
 //!< \cond
@@ -365,6 +369,247 @@ define_get_src_offset(uint64_t)
 #define COL_HAS_SUB_END_BLOCK(T) \
     return (((*(src + *pos) >> rshift) & bitmask) == search);
 
+#define SCAN_SUB_VARS(T) \
+    SUB_ITEM_VARS(T) \
+    const T mask = (T)(bitmask << rshift); \
+    const T value = (T)(search << rshift); \
+    if ((T)(search & (T)~bitmask) != 0) \
+    { \
+        return pos; \
+    }
+
+#define SCAN_RUN_LOOP_BLOCK(O, T) \
+    while ((pos < last) && ((bytes_##O##_to_##T(src, get_address(blklen, blkpos, pos)) & mask) == value)) \
+    { \
+        ++pos; \
+    } \
+    return pos;
+
+#define FILL_RUN_START_BLOCK \
+    uint64_t i, end = *pos; \
+    if (*pos < last) \
+    { \
+        end = ((last - *pos) > n) ? (*pos + n) : last;
+
+#define FILL_RUN_END_BLOCK \
+    } \
+    for (i = *pos; i < end; i++) \
+    { \
+        out[(i - *pos)] = i; \
+    } \
+    n = (end - *pos); \
+    *pos = end; \
+    return n;
+
+#if defined(__SSE2__)
+#define SCAN_SET1_uint8_t(x) _mm_set1_epi8((char)(x)) //!< Broadcast a uint8_t value to a SSE2 register.
+#define SCAN_SET1_uint16_t(x) _mm_set1_epi16((short)(x)) //!< Broadcast a uint16_t value to a SSE2 register.
+#define SCAN_SET1_uint32_t(x) _mm_set1_epi32((int)(x)) //!< Broadcast a uint32_t value to a SSE2 register.
+#define SCAN_SET1_uint64_t(x) _mm_set1_epi64x((long long)(x)) //!< Broadcast a uint64_t value to a SSE2 register.
+#endif
+
+#if defined(__SSE2__)
+#define SCAN_RUN_SIMD_BLOCK(T) \
+    const __m128i vmask = SCAN_SET1_##T(mask); \
+    const __m128i vvalue = SCAN_SET1_##T(value); \
+    unsigned int eq; \
+    while ((pos + (64 / sizeof(T))) <= last) \
+    { \
+        eq = (unsigned int)_mm_movemask_epi8(_mm_and_si128( \
+                 _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128((const __m128i *)(const void *)(src + pos)), vmask), vvalue), \
+                               _mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128((const __m128i *)(const void *)(src + pos + (16 / sizeof(T)))), vmask), vvalue)), \
+                 _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128((const __m128i *)(const void *)(src + pos + (32 / sizeof(T)))), vmask), vvalue), \
+                               _mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128((const __m128i *)(const void *)(src + pos + (48 / sizeof(T)))), vmask), vvalue)))); \
+        if (eq != 0xFFFF) \
+        { \
+            break; \
+        } \
+        pos += (64 / sizeof(T)); \
+    } \
+    while ((pos + (16 / sizeof(T))) <= last) \
+    { \
+        eq = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128((const __m128i *)(const void *)(src + pos)), vmask), vvalue)); \
+        if (eq != 0xFFFF) \
+        { \
+            return (pos + ((uint64_t)__builtin_ctz(~eq) / sizeof(T))); \
+        } \
+        pos += (16 / sizeof(T)); \
+    }
+#else
+#define SCAN_RUN_SIMD_BLOCK(T)
+#endif
+
+#define BINSEARCH_BATCH 16 //!< Number of searches advanced in lockstep by the batch functions.
+
+#if defined(__GNUC__) && !defined(BINSEARCH_NO_PREFETCH)
+#define binsearch_prefetch(p) __builtin_prefetch(p) //!< Prefetch the cache line containing the specified address.
+#else
+#define binsearch_prefetch(p) //!< Prefetch not supported.
+#endif
+
+#define FIND_BATCH_START_LOOP_BLOCK(T) \
+    uint64_t pos[BINSEARCH_BATCH]; \
+    uint64_t i, j, m, len, half, middle; \
+    T x; \
+    for (i = 0; i < n; i += BINSEARCH_BATCH) \
+    { \
+        m = ((n - i) < BINSEARCH_BATCH) ? (n - i) : BINSEARCH_BATCH; \
+        for (j = 0; j < m; j++) \
+        { \
+            pos[j] = first; \
+            out[(i + j)] = last; \
+        } \
+        if (first >= last) \
+        { \
+            continue; \
+        } \
+        for (len = (last - first); len > 1; len -= half) \
+        { \
+            half = (len >> 1); \
+            for (j = 0; j < m; j++) \
+            { \
+                middle = (pos[j] + half);
+
+#define FIND_FIRST_BATCH_INNER_CHECK \
+                pos[j] = (x < search[(i + j)]) ? middle : pos[j]; \
+                middle = (pos[j] + ((len - half) >> 1));
+
+#define FIND_LAST_BATCH_INNER_CHECK \
+                pos[j] = (x <= search[(i + j)]) ? middle : pos[j]; \
+                middle = (pos[j] + ((len - half) >> 1));
+
+#define PREFETCH_MIDDLE_TASK \
+                binsearch_prefetch(src + get_address(blklen, blkpos, middle));
+
+#define COL_PREFETCH_MIDDLE_TASK \
+                binsearch_prefetch(src + middle);
+
+#define FIND_BATCH_END_INNER_LOOP_BLOCK \
+            } \
+        } \
+        for (j = 0; j < m; j++) \
+        { \
+            middle = pos[j];
+
+#define FIND_FIRST_BATCH_NEXT_BLOCK \
+            if ((x < search[(i + j)]) && (++middle < last)) \
+            {
+
+#define FIND_LAST_BATCH_NEXT_BLOCK \
+            if ((x > search[(i + j)]) && (middle > first)) \
+            { \
+                --middle;
+
+#define FIND_BATCH_END_LOOP_BLOCK \
+            } \
+            if ((middle < last) && (x == search[(i + j)])) \
+            { \
+                out[(i + j)] = middle; \
+            } \
+        } \
+    }
+
+#define FIND_BL_START_LOOP_BLOCK(T) \
+    uint64_t middle, half, len, pos = *first, notfound = *last; \
+    T x; \
+    if (*first < *last) \
+    { \
+        for (len = (*last - *first); len > 1; len -= half) \
+        { \
+            half = (len >> 1); \
+            middle = (pos + half);
+
+#define PREFETCH_BL_TASK \
+            binsearch_prefetch(src + get_address(blklen, blkpos, (pos + ((len - half) >> 1)))); \
+            binsearch_prefetch(src + get_address(blklen, blkpos, (middle + ((len - half) >> 1))));
+
+#define COL_PREFETCH_BL_TASK \
+            binsearch_prefetch(src + pos + ((len - half) >> 1)); \
+            binsearch_prefetch(src + middle + ((len - half) >> 1));
+
+#define FIND_FIRST_BL_INNER_CHECK \
+            pos = (x < search) ? middle : pos; \
+        } \
+        middle = pos;
+
+#define FIND_LAST_BL_INNER_CHECK \
+            pos = (x <= search) ? middle : pos; \
+        } \
+        middle = pos;
+
+#define FIND_FIRST_BL_END_LOOP_BLOCK \
+        pos += (uint64_t)(x < search); \
+        *first = pos; \
+        *last = pos; \
+    } \
+    middle = pos;
+
+#define FIND_LAST_BL_END_LOOP_BLOCK \
+        pos += (uint64_t)(x <= search); \
+        *first = pos; \
+        *last = pos; \
+    } \
+    middle = pos; \
+    --middle;
+
+#define FIND_RANGE_START_LOOP_BLOCK(T) \
+    uint64_t middle, ufirst, ulast; \
+    T x; \
+    while (*first < *last) \
+    { \
+        middle = get_middle_point(*first, *last);
+
+#define FIND_RANGE_SPLIT_BLOCK \
+        if (x < search) \
+        { \
+            *first = middle; \
+            ++(*first); \
+            continue; \
+        } \
+        if (x > search) \
+        { \
+            *last = middle; \
+            continue; \
+        } \
+        ufirst = middle; \
+        ++ufirst; \
+        ulast = *last; \
+        *last = middle; \
+        while (*first < *last) \
+        { \
+            middle = get_middle_point(*first, *last);
+
+#define FIND_RANGE_LOWER_CHECK \
+            if (x < search) \
+            { \
+                *first = middle; \
+                ++(*first); \
+            } \
+            else \
+            { \
+                *last = middle; \
+            } \
+        } \
+        while (ufirst < ulast) \
+        { \
+            middle = get_middle_point(ufirst, ulast);
+
+#define FIND_RANGE_END_LOOP_BLOCK \
+            if (x > search) \
+            { \
+                ulast = middle; \
+            } \
+            else \
+            { \
+                ufirst = middle; \
+                ++ufirst; \
+            } \
+        } \
+        *last = ufirst; \
+        return (*last - *first); \
+    } \
+    return 0;
+
 /**
  * Generic function to search for the first occurrence of an unsigned integer
  * on a memory mapped binary file containing adjacent blocks of sorted binary data.
@@ -520,278 +765,1093 @@ define_find_last_sub(le, uint32_t)
 define_find_last_sub(le, uint64_t)
 
 /**
- * Generic function to check if the next item still matches the search value.
+ * Generic function to search for the first occurrence of an unsigned integer
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data,
+ * using a branchless binary search.
  *
  * @param O Endiannes: be or le.
- * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
  */
-#define define_has_next(O, T) \
-/** Check if the next occurrence of an unsigned integer on a memory mapped
-binary file containing adjacent blocks of sorted binary data still matches the search value.
+#define define_find_first_bl(O, T) \
+/** Search for the first occurrence of an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data.
+This is a drop-in replacement of find_first_O_T (same results and same updates of first and last):
+the search range is halved a fixed number of times with conditional moves instead of branches,
+and the two candidate items of the next step are prefetched, so it does not suffer from branch mispredictions on random searches.
 The values in the file must be encoded in "O" format and sorted in ascending order.
-This function can be used after find_first_##T to get the next elements that still satisfy the search.
-The item returned by find_first_##T should be set as the "pos" parameter in this function.
 @param src       Memory mapped file address.
 @param blklen    Length of the binary block in bytes.
 @param blkpos    Indicates the position of the number to search inside a binary block.
-@param pos       Pointer to the current item position. This will be updated to point to the next position.
+@param first     Pointer to the element from where to start the search (min value = 0).
 @param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
 @param search    Unsigned number to search (type T).
-@return 1 if the next item is valid, 0 otherwise.
+@return Item number if found or last if not found.
  */ \
-static inline bool has_next_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t *pos, uint64_t last, T search) \
+static inline uint64_t find_first_bl_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t *first, uint64_t *last, T search) \
 { \
-HAS_NEXT_START_BLOCK \
-HAS_END_BLOCK(O, T) \
+FIND_BL_START_LOOP_BLOCK(T) \
+PREFETCH_BL_TASK \
+GET_ITEM_TASK(O, T) \
+FIND_FIRST_BL_INNER_CHECK \
+GET_ITEM_TASK(O, T) \
+FIND_FIRST_BL_END_LOOP_BLOCK \
+GET_ITEM_TASK(O, T) \
+FIND_END_LOOP_BLOCK \
 }
 
-define_has_next(be, uint8_t)
-define_has_next(be, uint16_t)
-define_has_next(be, uint32_t)
-define_has_next(be, uint64_t)
-define_has_next(le, uint8_t)
-define_has_next(le, uint16_t)
-define_has_next(le, uint32_t)
-define_has_next(le, uint64_t)
+define_find_first_bl(be, uint8_t)
+define_find_first_bl(be, uint16_t)
+define_find_first_bl(be, uint32_t)
+define_find_first_bl(be, uint64_t)
+define_find_first_bl(le, uint8_t)
+define_find_first_bl(le, uint16_t)
+define_find_first_bl(le, uint32_t)
+define_find_first_bl(le, uint64_t)
 
 /**
- * Generic function to check if the next item still matches the search value.
+ * Generic function to search for the first occurrence of an unsigned integer
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data,
+ * using a branchless binary search.
  *
  * @param O Endiannes: be or le.
- * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
  */
-#define define_has_next_sub(O, T) \
-/** Check if the next occurrence of an unsigned integer on a memory mapped
-binary file containing adjacent blocks of sorted binary data still matches the search value.
+#define define_find_first_bl_sub(O, T) \
+/** Search for the first occurrence of an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data.
+This is a drop-in replacement of find_first_sub_O_T (same results and same updates of first and last):
+the search range is halved a fixed number of times with conditional moves instead of branches,
+and the two candidate items of the next step are prefetched, so it does not suffer from branch mispredictions on random searches.
 The values in the file must be encoded in "O" format and sorted in ascending order.
-This function can be used after find_first_sub_##T to get the next elements that still satisfy the search.
-The item returned by find_first_sub_##T should be set as the "pos" parameter in this function.
 @param src       Memory mapped file address.
 @param blklen    Length of the binary block in bytes.
 @param blkpos    Indicates the position of the number to search inside a binary block.
 @param bitstart  First bit position to consider (usually 0).
 @param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
-@param pos       Pointer to the current item position. This will be updated to point to the next position.
+@param first     Pointer to the element from where to start the search (min value = 0).
 @param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
 @param search    Unsigned number to search (type T).
-@return 1 if the next item is valid, 0 otherwise.
+@return Item number if found or last if not found.
  */ \
-static inline bool has_next_sub_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t *pos, uint64_t last, T search) \
+static inline uint64_t find_first_bl_sub_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
 { \
-HAS_NEXT_START_BLOCK \
 SUB_ITEM_VARS(T) \
-HAS_SUB_END_BLOCK(O, T) \
+FIND_BL_START_LOOP_BLOCK(T) \
+PREFETCH_BL_TASK \
+GET_SUB_ITEM_TASK(O, T) \
+FIND_FIRST_BL_INNER_CHECK \
+GET_SUB_ITEM_TASK(O, T) \
+FIND_FIRST_BL_END_LOOP_BLOCK \
+GET_SUB_ITEM_TASK(O, T) \
+FIND_END_LOOP_BLOCK \
 }
 
-define_has_next_sub(be, uint8_t)
-define_has_next_sub(be, uint16_t)
-define_has_next_sub(be, uint32_t)
-define_has_next_sub(be, uint64_t)
-define_has_next_sub(le, uint8_t)
-define_has_next_sub(le, uint16_t)
-define_has_next_sub(le, uint32_t)
-define_has_next_sub(le, uint64_t)
+define_find_first_bl_sub(be, uint8_t)
+define_find_first_bl_sub(be, uint16_t)
+define_find_first_bl_sub(be, uint32_t)
+define_find_first_bl_sub(be, uint64_t)
+define_find_first_bl_sub(le, uint8_t)
+define_find_first_bl_sub(le, uint16_t)
+define_find_first_bl_sub(le, uint32_t)
+define_find_first_bl_sub(le, uint64_t)
 
 /**
- * Generic function to check if the previous item still matches the search value.
+ * Generic function to search for the last occurrence of an unsigned integer
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data,
+ * using a branchless binary search.
  *
  * @param O Endiannes: be or le.
- * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
  */
-#define define_has_prev(O, T) \
-/** Check if the previous occurrence of an unsigned integer on a memory mapped
-binary file containing adjacent blocks of sorted binary data still matches the search value.
+#define define_find_last_bl(O, T) \
+/** Search for the last occurrence of an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data.
+This is a drop-in replacement of find_last_O_T (same results and same updates of first and last):
+the search range is halved a fixed number of times with conditional moves instead of branches,
+and the two candidate items of the next step are prefetched, so it does not suffer from branch mispredictions on random searches.
 The values in the file must be encoded in "O" format and sorted in ascending order.
-This function can be used after find_last_##T to get the previous elements that still satisfy the search.
-The item returned by find_last_##T should be set as the "pos" parameter in this function.
 @param src       Memory mapped file address.
 @param blklen    Length of the binary block in bytes.
 @param blkpos    Indicates the position of the number to search inside a binary block.
-@param first     First element of the range to search (min value = 0).
-@param pos       Pointer to the current item position. This will be updated to point to the previous position.
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
 @param search    Unsigned number to search (type T).
-@return 1 if the next item is valid, 0 otherwise.
+@return Item number if found or last if not found.
  */ \
-static inline bool has_prev_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t first, uint64_t *pos, T search) \
+static inline uint64_t find_last_bl_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t *first, uint64_t *last, T search) \
 { \
-HAS_PREV_START_BLOCK \
-HAS_END_BLOCK(O, T) \
+FIND_BL_START_LOOP_BLOCK(T) \
+PREFETCH_BL_TASK \
+GET_ITEM_TASK(O, T) \
+FIND_LAST_BL_INNER_CHECK \
+GET_ITEM_TASK(O, T) \
+FIND_LAST_BL_END_LOOP_BLOCK \
+GET_ITEM_TASK(O, T) \
+FIND_END_LOOP_BLOCK \
 }
 
-define_has_prev(be, uint8_t)
-define_has_prev(be, uint16_t)
-define_has_prev(be, uint32_t)
-define_has_prev(be, uint64_t)
-define_has_prev(le, uint8_t)
-define_has_prev(le, uint16_t)
-define_has_prev(le, uint32_t)
-define_has_prev(le, uint64_t)
+define_find_last_bl(be, uint8_t)
+define_find_last_bl(be, uint16_t)
+define_find_last_bl(be, uint32_t)
+define_find_last_bl(be, uint64_t)
+define_find_last_bl(le, uint8_t)
+define_find_last_bl(le, uint16_t)
+define_find_last_bl(le, uint32_t)
+define_find_last_bl(le, uint64_t)
 
 /**
- * Generic function to check if the previous item still matches the search value.
+ * Generic function to search for the last occurrence of an unsigned integer
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data,
+ * using a branchless binary search.
  *
  * @param O Endiannes: be or le.
- * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
  */
-#define define_has_prev_sub(O, T) \
-/** Check if the previous occurrence of an unsigned integer on a memory mapped
-binary file containing adjacent blocks of sorted binary data still matches the search value.
+#define define_find_last_bl_sub(O, T) \
+/** Search for the last occurrence of an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data.
+This is a drop-in replacement of find_last_sub_O_T (same results and same updates of first and last):
+the search range is halved a fixed number of times with conditional moves instead of branches,
+and the two candidate items of the next step are prefetched, so it does not suffer from branch mispredictions on random searches.
 The values in the file must be encoded in "O" format and sorted in ascending order.
-This function can be used after find_last_sub_##T to get the previous elements that still satisfy the search.
-The item returned by find_last_sub_##T should be set as the "pos" parameter in this function.
 @param src       Memory mapped file address.
 @param blklen    Length of the binary block in bytes.
 @param blkpos    Indicates the position of the number to search inside a binary block.
 @param bitstart  First bit position to consider (usually 0).
 @param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
-@param first     First element of the range to search (min value = 0).
-@param pos       Pointer to the current item position. This will be updated to point to the previous position.
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
 @param search    Unsigned number to search (type T).
-@return 1 if the next item is valid, 0 otherwise.
+@return Item number if found or last if not found.
  */ \
-static inline bool has_prev_sub_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t first, uint64_t *pos, T search) \
+static inline uint64_t find_last_bl_sub_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
 { \
-HAS_PREV_START_BLOCK \
 SUB_ITEM_VARS(T) \
-HAS_SUB_END_BLOCK(O, T) \
+FIND_BL_START_LOOP_BLOCK(T) \
+PREFETCH_BL_TASK \
+GET_SUB_ITEM_TASK(O, T) \
+FIND_LAST_BL_INNER_CHECK \
+GET_SUB_ITEM_TASK(O, T) \
+FIND_LAST_BL_END_LOOP_BLOCK \
+GET_SUB_ITEM_TASK(O, T) \
+FIND_END_LOOP_BLOCK \
 }
 
-define_has_prev_sub(be, uint8_t)
-define_has_prev_sub(be, uint16_t)
-define_has_prev_sub(be, uint32_t)
-define_has_prev_sub(be, uint64_t)
-define_has_prev_sub(le, uint8_t)
-define_has_prev_sub(le, uint16_t)
-define_has_prev_sub(le, uint32_t)
-define_has_prev_sub(le, uint64_t)
-
-// --- COLUMN MODE ---
+define_find_last_bl_sub(be, uint8_t)
+define_find_last_bl_sub(be, uint16_t)
+define_find_last_bl_sub(be, uint32_t)
+define_find_last_bl_sub(be, uint64_t)
+define_find_last_bl_sub(le, uint8_t)
+define_find_last_bl_sub(le, uint16_t)
+define_find_last_bl_sub(le, uint32_t)
+define_find_last_bl_sub(le, uint64_t)
 
 /**
- * Generic function to search for the first occurrence of an unsigned integer
- * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ * Generic function to search for the range of items matching an unsigned integer
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data.
  *
+ * @param O Endiannes: be or le.
  * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
  */
-#define define_col_find_first(T) \
-/** Search for the first occurrence of an unsigned integer on a memory buffer
-containing contiguos blocks of unsigned integers of the same type.
-The values must be encoded in Little-Endian format and sorted in ascending order.
+#define define_find_range(O, T) \
+/** Search for the range of items matching an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data.
+This is equivalent to find_first_O_T followed by find_last_O_T, but the common part of the two searches
+is executed only once, until the first matching item is found, then the search splits in the two bounds.
+The values in the file must be encoded in "O" format and sorted in ascending order.
 @param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
 @param first     Pointer to the element from where to start the search (min value = 0).
+                 This will be set to the first matching item, or to the insertion position if not found.
 @param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+                 This will be set to the item after the last matching one, or to the insertion position if not found.
 @param search    Unsigned number to search (type T).
-@return item number if notfound or (last + 1) if not notfound.
+@return Number of matching items (last - first).
  */ \
-static inline uint64_t col_find_first_##T(const T *src, uint64_t *first, uint64_t *last, T search) \
+static inline uint64_t find_range_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t *first, uint64_t *last, T search) \
 { \
-FIND_START_LOOP_BLOCK(T) \
-COL_GET_ITEM_TASK \
-FIND_FIRST_INNER_CHECK \
-COL_GET_ITEM_TASK \
-FIND_END_LOOP_BLOCK \
+FIND_RANGE_START_LOOP_BLOCK(T) \
+GET_ITEM_TASK(O, T) \
+FIND_RANGE_SPLIT_BLOCK \
+GET_ITEM_TASK(O, T) \
+FIND_RANGE_LOWER_CHECK \
+GET_ITEM_TASK(O, T) \
+FIND_RANGE_END_LOOP_BLOCK \
 }
 
-define_col_find_first(uint8_t)
-define_col_find_first(uint16_t)
-define_col_find_first(uint32_t)
-define_col_find_first(uint64_t)
+define_find_range(be, uint8_t)
+define_find_range(be, uint16_t)
+define_find_range(be, uint32_t)
+define_find_range(be, uint64_t)
+define_find_range(le, uint8_t)
+define_find_range(le, uint16_t)
+define_find_range(le, uint32_t)
+define_find_range(le, uint64_t)
 
 /**
- * Generic function to search for the first occurrence of an unsigned integer
- * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ * Generic function to search for the range of items matching an unsigned integer
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data.
  *
- * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
  */
-#define define_col_find_first_sub(T) \
-/** Search for the first occurrence of an unsigned integer on a memory buffer
-containing contiguos blocks of unsigned integers of the same type.
-The values must be encoded in Little-Endian format and sorted in ascending order.
+#define define_find_range_sub(O, T) \
+/** Search for the range of items matching an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data.
+This is equivalent to find_first_sub_O_T followed by find_last_sub_O_T, but the common part of the two searches
+is executed only once, until the first matching item is found, then the search splits in the two bounds.
+The values in the file must be encoded in "O" format and sorted in ascending order.
 @param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
 @param bitstart  First bit position to consider (usually 0).
 @param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
 @param first     Pointer to the element from where to start the search (min value = 0).
+                 This will be set to the first matching item, or to the insertion position if not found.
 @param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+                 This will be set to the item after the last matching one, or to the insertion position if not found.
 @param search    Unsigned number to search (type T).
-@return item number if notfound or (last + 1) if not notfound.
+@return Number of matching items (last - first).
  */ \
-static inline uint64_t col_find_first_sub_##T(const T *src, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
+static inline uint64_t find_range_sub_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
 { \
 SUB_ITEM_VARS(T) \
-FIND_START_LOOP_BLOCK(T) \
-COL_GET_SUB_ITEM_TASK \
-FIND_FIRST_INNER_CHECK \
-COL_GET_SUB_ITEM_TASK \
-FIND_END_LOOP_BLOCK \
+FIND_RANGE_START_LOOP_BLOCK(T) \
+GET_SUB_ITEM_TASK(O, T) \
+FIND_RANGE_SPLIT_BLOCK \
+GET_SUB_ITEM_TASK(O, T) \
+FIND_RANGE_LOWER_CHECK \
+GET_SUB_ITEM_TASK(O, T) \
+FIND_RANGE_END_LOOP_BLOCK \
 }
 
-define_col_find_first_sub(uint8_t)
-define_col_find_first_sub(uint16_t)
-define_col_find_first_sub(uint32_t)
-define_col_find_first_sub(uint64_t)
+define_find_range_sub(be, uint8_t)
+define_find_range_sub(be, uint16_t)
+define_find_range_sub(be, uint32_t)
+define_find_range_sub(be, uint64_t)
+define_find_range_sub(le, uint8_t)
+define_find_range_sub(le, uint16_t)
+define_find_range_sub(le, uint32_t)
+define_find_range_sub(le, uint64_t)
 
 /**
- * Generic function to search for the last occurrence of an unsigned integer
+ * Generic function to search for the first occurrence of a batch of unsigned integers
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_find_first_batch(O, T) \
+/** Search for the first occurrence of each unsigned integer of a batch on a memory mapped
+binary file containing adjacent blocks of sorted binary data.
+The searches of BINSEARCH_BATCH values are executed in lockstep, prefetching the next probe of each search,
+so the memory accesses of independent searches are overlapped.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param first     Element from where to start the searches (min value = 0).
+@param last      Element (up to but not including) where to end the searches (max value = nrows).
+@param search    Array of n unsigned numbers to search (type T).
+@param out       Array of n results: item number if found or last if not found (as returned by find_first_O_T).
+@param n         Number of values to search.
+ */ \
+static inline void find_first_batch_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t first, uint64_t last, const T *search, uint64_t *out, uint64_t n) \
+{ \
+FIND_BATCH_START_LOOP_BLOCK(T) \
+GET_ITEM_TASK(O, T) \
+FIND_FIRST_BATCH_INNER_CHECK \
+PREFETCH_MIDDLE_TASK \
+FIND_BATCH_END_INNER_LOOP_BLOCK \
+GET_ITEM_TASK(O, T) \
+FIND_FIRST_BATCH_NEXT_BLOCK \
+GET_ITEM_TASK(O, T) \
+FIND_BATCH_END_LOOP_BLOCK \
+}
+
+define_find_first_batch(be, uint8_t)
+define_find_first_batch(be, uint16_t)
+define_find_first_batch(be, uint32_t)
+define_find_first_batch(be, uint64_t)
+define_find_first_batch(le, uint8_t)
+define_find_first_batch(le, uint16_t)
+define_find_first_batch(le, uint32_t)
+define_find_first_batch(le, uint64_t)
+
+/**
+ * Generic function to search for the last occurrence of a batch of unsigned integers
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_find_last_batch(O, T) \
+/** Search for the last occurrence of each unsigned integer of a batch on a memory mapped
+binary file containing adjacent blocks of sorted binary data.
+The searches of BINSEARCH_BATCH values are executed in lockstep, prefetching the next probe of each search,
+so the memory accesses of independent searches are overlapped.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param first     Element from where to start the searches (min value = 0).
+@param last      Element (up to but not including) where to end the searches (max value = nrows).
+@param search    Array of n unsigned numbers to search (type T).
+@param out       Array of n results: item number if found or last if not found (as returned by find_last_O_T).
+@param n         Number of values to search.
+ */ \
+static inline void find_last_batch_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t first, uint64_t last, const T *search, uint64_t *out, uint64_t n) \
+{ \
+FIND_BATCH_START_LOOP_BLOCK(T) \
+GET_ITEM_TASK(O, T) \
+FIND_LAST_BATCH_INNER_CHECK \
+PREFETCH_MIDDLE_TASK \
+FIND_BATCH_END_INNER_LOOP_BLOCK \
+GET_ITEM_TASK(O, T) \
+FIND_LAST_BATCH_NEXT_BLOCK \
+GET_ITEM_TASK(O, T) \
+FIND_BATCH_END_LOOP_BLOCK \
+}
+
+define_find_last_batch(be, uint8_t)
+define_find_last_batch(be, uint16_t)
+define_find_last_batch(be, uint32_t)
+define_find_last_batch(be, uint64_t)
+define_find_last_batch(le, uint8_t)
+define_find_last_batch(le, uint16_t)
+define_find_last_batch(le, uint32_t)
+define_find_last_batch(le, uint64_t)
+
+/**
+ * Generic function to check if the next item still matches the search value.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_has_next(O, T) \
+/** Check if the next occurrence of an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data still matches the search value.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+This function can be used after find_first_##T to get the next elements that still satisfy the search.
+The item returned by find_first_##T should be set as the "pos" parameter in this function.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param pos       Pointer to the current item position. This will be updated to point to the next position.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return 1 if the next item is valid, 0 otherwise.
+ */ \
+static inline bool has_next_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t *pos, uint64_t last, T search) \
+{ \
+HAS_NEXT_START_BLOCK \
+HAS_END_BLOCK(O, T) \
+}
+
+define_has_next(be, uint8_t)
+define_has_next(be, uint16_t)
+define_has_next(be, uint32_t)
+define_has_next(be, uint64_t)
+define_has_next(le, uint8_t)
+define_has_next(le, uint16_t)
+define_has_next(le, uint32_t)
+define_has_next(le, uint64_t)
+
+/**
+ * Generic function to check if the next item still matches the search value.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_has_next_sub(O, T) \
+/** Check if the next occurrence of an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data still matches the search value.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+This function can be used after find_first_sub_##T to get the next elements that still satisfy the search.
+The item returned by find_first_sub_##T should be set as the "pos" parameter in this function.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param pos       Pointer to the current item position. This will be updated to point to the next position.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return 1 if the next item is valid, 0 otherwise.
+ */ \
+static inline bool has_next_sub_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t *pos, uint64_t last, T search) \
+{ \
+HAS_NEXT_START_BLOCK \
+SUB_ITEM_VARS(T) \
+HAS_SUB_END_BLOCK(O, T) \
+}
+
+define_has_next_sub(be, uint8_t)
+define_has_next_sub(be, uint16_t)
+define_has_next_sub(be, uint32_t)
+define_has_next_sub(be, uint64_t)
+define_has_next_sub(le, uint8_t)
+define_has_next_sub(le, uint16_t)
+define_has_next_sub(le, uint32_t)
+define_has_next_sub(le, uint64_t)
+
+/**
+ * Generic function to check if the previous item still matches the search value.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_has_prev(O, T) \
+/** Check if the previous occurrence of an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data still matches the search value.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+This function can be used after find_last_##T to get the previous elements that still satisfy the search.
+The item returned by find_last_##T should be set as the "pos" parameter in this function.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param first     First element of the range to search (min value = 0).
+@param pos       Pointer to the current item position. This will be updated to point to the previous position.
+@param search    Unsigned number to search (type T).
+@return 1 if the next item is valid, 0 otherwise.
+ */ \
+static inline bool has_prev_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t first, uint64_t *pos, T search) \
+{ \
+HAS_PREV_START_BLOCK \
+HAS_END_BLOCK(O, T) \
+}
+
+define_has_prev(be, uint8_t)
+define_has_prev(be, uint16_t)
+define_has_prev(be, uint32_t)
+define_has_prev(be, uint64_t)
+define_has_prev(le, uint8_t)
+define_has_prev(le, uint16_t)
+define_has_prev(le, uint32_t)
+define_has_prev(le, uint64_t)
+
+/**
+ * Generic function to check if the previous item still matches the search value.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_has_prev_sub(O, T) \
+/** Check if the previous occurrence of an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data still matches the search value.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+This function can be used after find_last_sub_##T to get the previous elements that still satisfy the search.
+The item returned by find_last_sub_##T should be set as the "pos" parameter in this function.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param first     First element of the range to search (min value = 0).
+@param pos       Pointer to the current item position. This will be updated to point to the previous position.
+@param search    Unsigned number to search (type T).
+@return 1 if the next item is valid, 0 otherwise.
+ */ \
+static inline bool has_prev_sub_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t first, uint64_t *pos, T search) \
+{ \
+HAS_PREV_START_BLOCK \
+SUB_ITEM_VARS(T) \
+HAS_SUB_END_BLOCK(O, T) \
+}
+
+define_has_prev_sub(be, uint8_t)
+define_has_prev_sub(be, uint16_t)
+define_has_prev_sub(be, uint32_t)
+define_has_prev_sub(be, uint64_t)
+define_has_prev_sub(le, uint8_t)
+define_has_prev_sub(le, uint16_t)
+define_has_prev_sub(le, uint32_t)
+define_has_prev_sub(le, uint64_t)
+
+/**
+ * Generic function to find the end of a run of items matching an unsigned integer
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_scan_run(O, T) \
+/** Find the end of the run of items matching an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data, starting from the specified position.
+This is equivalent to calling has_next_O_T until it returns false, without the per-item call overhead.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param pos       First item to check (e.g. the item returned by find_first_O_T).
+@param last      Element (up to but not including) where to end the scan (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return Position of the first item not matching the search value (pos if the item at pos does not match), or last.
+ */ \
+static inline uint64_t scan_run_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t pos, uint64_t last, T search) \
+{ \
+const T mask = (T)~(T)0; \
+const T value = search; \
+SCAN_RUN_LOOP_BLOCK(O, T) \
+}
+
+define_scan_run(be, uint8_t)
+define_scan_run(be, uint16_t)
+define_scan_run(be, uint32_t)
+define_scan_run(be, uint64_t)
+define_scan_run(le, uint8_t)
+define_scan_run(le, uint16_t)
+define_scan_run(le, uint32_t)
+define_scan_run(le, uint64_t)
+
+/**
+ * Generic function to find the end of a run of items matching an unsigned integer
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_scan_run_sub(O, T) \
+/** Find the end of the run of items matching an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data, starting from the specified position.
+This is equivalent to calling has_next_sub_O_T until it returns false, without the per-item call overhead.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param pos       First item to check (e.g. the item returned by find_first_sub_O_T).
+@param last      Element (up to but not including) where to end the scan (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return Position of the first item not matching the search value (pos if the item at pos does not match), or last.
+ */ \
+static inline uint64_t scan_run_sub_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t pos, uint64_t last, T search) \
+{ \
+SCAN_SUB_VARS(T) \
+SCAN_RUN_LOOP_BLOCK(O, T) \
+}
+
+define_scan_run_sub(be, uint8_t)
+define_scan_run_sub(be, uint16_t)
+define_scan_run_sub(be, uint32_t)
+define_scan_run_sub(be, uint64_t)
+define_scan_run_sub(le, uint8_t)
+define_scan_run_sub(le, uint16_t)
+define_scan_run_sub(le, uint32_t)
+define_scan_run_sub(le, uint64_t)
+
+/**
+ * Generic function to collect the positions of a run of items matching an unsigned integer
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_fill_run(O, T) \
+/** Collect up to n positions of the run of items matching an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data, starting from the specified position.
+The function can be called again with the updated position until it returns less than n items.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param pos       Pointer to the first item to check (e.g. the item returned by find_first_O_T).
+                 This will be updated to point to the item after the last collected one.
+@param last      Element (up to but not including) where to end the scan (max value = nrows).
+@param search    Unsigned number to search (type T).
+@param out       Array of at least n elements to store the positions of the matching items.
+@param n         Maximum number of positions to collect.
+@return Number of collected positions.
+ */ \
+static inline uint64_t fill_run_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t *pos, uint64_t last, T search, uint64_t *out, uint64_t n) \
+{ \
+FILL_RUN_START_BLOCK \
+        end = scan_run_##O##_##T(src, blklen, blkpos, *pos, end, search); \
+FILL_RUN_END_BLOCK \
+}
+
+define_fill_run(be, uint8_t)
+define_fill_run(be, uint16_t)
+define_fill_run(be, uint32_t)
+define_fill_run(be, uint64_t)
+define_fill_run(le, uint8_t)
+define_fill_run(le, uint16_t)
+define_fill_run(le, uint32_t)
+define_fill_run(le, uint64_t)
+
+/**
+ * Generic function to collect the positions of a run of items matching an unsigned integer
+ * on a memory mapped binary file containing adjacent blocks of sorted binary data.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_fill_run_sub(O, T) \
+/** Collect up to n positions of the run of items matching an unsigned integer on a memory mapped
+binary file containing adjacent blocks of sorted binary data, starting from the specified position.
+The function can be called again with the updated position until it returns less than n items.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param pos       Pointer to the first item to check (e.g. the item returned by find_first_sub_O_T).
+                 This will be updated to point to the item after the last collected one.
+@param last      Element (up to but not including) where to end the scan (max value = nrows).
+@param search    Unsigned number to search (type T).
+@param out       Array of at least n elements to store the positions of the matching items.
+@param n         Maximum number of positions to collect.
+@return Number of collected positions.
+ */ \
+static inline uint64_t fill_run_sub_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t *pos, uint64_t last, T search, uint64_t *out, uint64_t n) \
+{ \
+FILL_RUN_START_BLOCK \
+        end = scan_run_sub_##O##_##T(src, blklen, blkpos, bitstart, bitend, *pos, end, search); \
+FILL_RUN_END_BLOCK \
+}
+
+define_fill_run_sub(be, uint8_t)
+define_fill_run_sub(be, uint16_t)
+define_fill_run_sub(be, uint32_t)
+define_fill_run_sub(be, uint64_t)
+define_fill_run_sub(le, uint8_t)
+define_fill_run_sub(le, uint16_t)
+define_fill_run_sub(le, uint32_t)
+define_fill_run_sub(le, uint64_t)
+
+// --- COLUMN MODE ---
+
+/**
+ * Generic function to search for the first occurrence of an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_col_find_first(T) \
+/** Search for the first occurrence of an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return item number if notfound or (last + 1) if not notfound.
+ */ \
+static inline uint64_t col_find_first_##T(const T *src, uint64_t *first, uint64_t *last, T search) \
+{ \
+FIND_START_LOOP_BLOCK(T) \
+COL_GET_ITEM_TASK \
+FIND_FIRST_INNER_CHECK \
+COL_GET_ITEM_TASK \
+FIND_END_LOOP_BLOCK \
+}
+
+define_col_find_first(uint8_t)
+define_col_find_first(uint16_t)
+define_col_find_first(uint32_t)
+define_col_find_first(uint64_t)
+
+/**
+ * Generic function to search for the first occurrence of an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_col_find_first_sub(T) \
+/** Search for the first occurrence of an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return item number if notfound or (last + 1) if not notfound.
+ */ \
+static inline uint64_t col_find_first_sub_##T(const T *src, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
+{ \
+SUB_ITEM_VARS(T) \
+FIND_START_LOOP_BLOCK(T) \
+COL_GET_SUB_ITEM_TASK \
+FIND_FIRST_INNER_CHECK \
+COL_GET_SUB_ITEM_TASK \
+FIND_END_LOOP_BLOCK \
+}
+
+define_col_find_first_sub(uint8_t)
+define_col_find_first_sub(uint16_t)
+define_col_find_first_sub(uint32_t)
+define_col_find_first_sub(uint64_t)
+
+/**
+ * Generic function to search for the last occurrence of an unsigned integer
  * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
  *
- * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_col_find_last(T) \
+/** Search for the last occurrence of an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return Item number if notfound or (last + 1) if not notfound.
+*/ \
+static inline uint64_t col_find_last_##T(const T *src, uint64_t *first, uint64_t *last, T search) \
+{ \
+FIND_START_LOOP_BLOCK(T) \
+COL_GET_ITEM_TASK \
+FIND_LAST_INNER_CHECK \
+COL_GET_ITEM_TASK \
+FIND_END_LOOP_BLOCK \
+}
+
+define_col_find_last(uint8_t)
+define_col_find_last(uint16_t)
+define_col_find_last(uint32_t)
+define_col_find_last(uint64_t)
+
+/**
+ * Generic function to search for the last occurrence of an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_col_find_last_sub(T) \
+/** Search for the last occurrence of an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return Item number if notfound or (last + 1) if not notfound.
+*/ \
+static inline uint64_t col_find_last_sub_##T(const T *src, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
+{ \
+SUB_ITEM_VARS(T) \
+FIND_START_LOOP_BLOCK(T) \
+COL_GET_SUB_ITEM_TASK \
+FIND_LAST_INNER_CHECK \
+COL_GET_SUB_ITEM_TASK \
+FIND_END_LOOP_BLOCK \
+}
+
+define_col_find_last_sub(uint8_t)
+define_col_find_last_sub(uint16_t)
+define_col_find_last_sub(uint32_t)
+define_col_find_last_sub(uint64_t)
+
+/**
+ * Generic function to search for the first occurrence of an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type,
+ * using a branchless binary search.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_col_find_first_bl(T) \
+/** Search for the first occurrence of an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+This is a drop-in replacement of col_find_first_T (same results and same updates of first and last):
+the search range is halved a fixed number of times with conditional moves instead of branches,
+and the two candidate items of the next step are prefetched, so it does not suffer from branch mispredictions on random searches.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return Item number if found or last if not found.
+ */ \
+static inline uint64_t col_find_first_bl_##T(const T *src, uint64_t *first, uint64_t *last, T search) \
+{ \
+FIND_BL_START_LOOP_BLOCK(T) \
+COL_PREFETCH_BL_TASK \
+COL_GET_ITEM_TASK \
+FIND_FIRST_BL_INNER_CHECK \
+COL_GET_ITEM_TASK \
+FIND_FIRST_BL_END_LOOP_BLOCK \
+COL_GET_ITEM_TASK \
+FIND_END_LOOP_BLOCK \
+}
+
+define_col_find_first_bl(uint8_t)
+define_col_find_first_bl(uint16_t)
+define_col_find_first_bl(uint32_t)
+define_col_find_first_bl(uint64_t)
+
+/**
+ * Generic function to search for the first occurrence of an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type,
+ * using a branchless binary search.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_col_find_first_bl_sub(T) \
+/** Search for the first occurrence of an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+This is a drop-in replacement of col_find_first_sub_T (same results and same updates of first and last):
+the search range is halved a fixed number of times with conditional moves instead of branches,
+and the two candidate items of the next step are prefetched, so it does not suffer from branch mispredictions on random searches.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return Item number if found or last if not found.
+ */ \
+static inline uint64_t col_find_first_bl_sub_##T(const T *src, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
+{ \
+SUB_ITEM_VARS(T) \
+FIND_BL_START_LOOP_BLOCK(T) \
+COL_PREFETCH_BL_TASK \
+COL_GET_SUB_ITEM_TASK \
+FIND_FIRST_BL_INNER_CHECK \
+COL_GET_SUB_ITEM_TASK \
+FIND_FIRST_BL_END_LOOP_BLOCK \
+COL_GET_SUB_ITEM_TASK \
+FIND_END_LOOP_BLOCK \
+}
+
+define_col_find_first_bl_sub(uint8_t)
+define_col_find_first_bl_sub(uint16_t)
+define_col_find_first_bl_sub(uint32_t)
+define_col_find_first_bl_sub(uint64_t)
+
+/**
+ * Generic function to search for the last occurrence of an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type,
+ * using a branchless binary search.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_col_find_last_bl(T) \
+/** Search for the last occurrence of an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+This is a drop-in replacement of col_find_last_T (same results and same updates of first and last):
+the search range is halved a fixed number of times with conditional moves instead of branches,
+and the two candidate items of the next step are prefetched, so it does not suffer from branch mispredictions on random searches.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return Item number if found or last if not found.
+ */ \
+static inline uint64_t col_find_last_bl_##T(const T *src, uint64_t *first, uint64_t *last, T search) \
+{ \
+FIND_BL_START_LOOP_BLOCK(T) \
+COL_PREFETCH_BL_TASK \
+COL_GET_ITEM_TASK \
+FIND_LAST_BL_INNER_CHECK \
+COL_GET_ITEM_TASK \
+FIND_LAST_BL_END_LOOP_BLOCK \
+COL_GET_ITEM_TASK \
+FIND_END_LOOP_BLOCK \
+}
+
+define_col_find_last_bl(uint8_t)
+define_col_find_last_bl(uint16_t)
+define_col_find_last_bl(uint32_t)
+define_col_find_last_bl(uint64_t)
+
+/**
+ * Generic function to search for the last occurrence of an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type,
+ * using a branchless binary search.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
  */
-#define define_col_find_last(T) \
+#define define_col_find_last_bl_sub(T) \
 /** Search for the last occurrence of an unsigned integer on a memory buffer
 containing contiguos blocks of unsigned integers of the same type.
+This is a drop-in replacement of col_find_last_sub_T (same results and same updates of first and last):
+the search range is halved a fixed number of times with conditional moves instead of branches,
+and the two candidate items of the next step are prefetched, so it does not suffer from branch mispredictions on random searches.
 The values must be encoded in Little-Endian format and sorted in ascending order.
 @param src       Memory mapped file address.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
 @param first     Pointer to the element from where to start the search (min value = 0).
 @param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
 @param search    Unsigned number to search (type T).
-@return Item number if notfound or (last + 1) if not notfound.
-*/ \
-static inline uint64_t col_find_last_##T(const T *src, uint64_t *first, uint64_t *last, T search) \
+@return Item number if found or last if not found.
+ */ \
+static inline uint64_t col_find_last_bl_sub_##T(const T *src, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
 { \
-FIND_START_LOOP_BLOCK(T) \
+SUB_ITEM_VARS(T) \
+FIND_BL_START_LOOP_BLOCK(T) \
+COL_PREFETCH_BL_TASK \
+COL_GET_SUB_ITEM_TASK \
+FIND_LAST_BL_INNER_CHECK \
+COL_GET_SUB_ITEM_TASK \
+FIND_LAST_BL_END_LOOP_BLOCK \
+COL_GET_SUB_ITEM_TASK \
+FIND_END_LOOP_BLOCK \
+}
+
+define_col_find_last_bl_sub(uint8_t)
+define_col_find_last_bl_sub(uint16_t)
+define_col_find_last_bl_sub(uint32_t)
+define_col_find_last_bl_sub(uint64_t)
+
+/**
+ * Generic function to search for the range of items matching an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_col_find_range(T) \
+/** Search for the range of items matching an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+This is equivalent to col_find_first_T followed by col_find_last_T, but the common part of the two searches
+is executed only once, until the first matching item is found, then the search splits in the two bounds.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param first     Pointer to the element from where to start the search (min value = 0).
+                 This will be set to the first matching item, or to the insertion position if not found.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+                 This will be set to the item after the last matching one, or to the insertion position if not found.
+@param search    Unsigned number to search (type T).
+@return Number of matching items (last - first).
+ */ \
+static inline uint64_t col_find_range_##T(const T *src, uint64_t *first, uint64_t *last, T search) \
+{ \
+FIND_RANGE_START_LOOP_BLOCK(T) \
 COL_GET_ITEM_TASK \
-FIND_LAST_INNER_CHECK \
+FIND_RANGE_SPLIT_BLOCK \
 COL_GET_ITEM_TASK \
-FIND_END_LOOP_BLOCK \
+FIND_RANGE_LOWER_CHECK \
+COL_GET_ITEM_TASK \
+FIND_RANGE_END_LOOP_BLOCK \
 }
 
-define_col_find_last(uint8_t)
-define_col_find_last(uint16_t)
-define_col_find_last(uint32_t)
-define_col_find_last(uint64_t)
+define_col_find_range(uint8_t)
+define_col_find_range(uint16_t)
+define_col_find_range(uint32_t)
+define_col_find_range(uint64_t)
 
 /**
- * Generic function to search for the last occurrence of an unsigned integer
+ * Generic function to search for the range of items matching an unsigned integer
  * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
  *
- * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
  */
-#define define_col_find_last_sub(T) \
-/** Search for the last occurrence of an unsigned integer on a memory buffer
+#define define_col_find_range_sub(T) \
+/** Search for the range of items matching an unsigned integer on a memory buffer
 containing contiguos blocks of unsigned integers of the same type.
+This is equivalent to col_find_first_sub_T followed by col_find_last_sub_T, but the common part of the two searches
+is executed only once, until the first matching item is found, then the search splits in the two bounds.
 The values must be encoded in Little-Endian format and sorted in ascending order.
 @param src       Memory mapped file address.
 @param bitstart  First bit position to consider (usually 0).
 @param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
 @param first     Pointer to the element from where to start the search (min value = 0).
+                 This will be set to the first matching item, or to the insertion position if not found.
 @param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+                 This will be set to the item after the last matching one, or to the insertion position if not found.
 @param search    Unsigned number to search (type T).
-@return Item number if notfound or (last + 1) if not notfound.
-*/ \
-static inline uint64_t col_find_last_sub_##T(const T *src, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
+@return Number of matching items (last - first).
+ */ \
+static inline uint64_t col_find_range_sub_##T(const T *src, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
 { \
 SUB_ITEM_VARS(T) \
-FIND_START_LOOP_BLOCK(T) \
+FIND_RANGE_START_LOOP_BLOCK(T) \
 COL_GET_SUB_ITEM_TASK \
-FIND_LAST_INNER_CHECK \
+FIND_RANGE_SPLIT_BLOCK \
 COL_GET_SUB_ITEM_TASK \
-FIND_END_LOOP_BLOCK \
+FIND_RANGE_LOWER_CHECK \
+COL_GET_SUB_ITEM_TASK \
+FIND_RANGE_END_LOOP_BLOCK \
 }
 
-define_col_find_last_sub(uint8_t)
-define_col_find_last_sub(uint16_t)
-define_col_find_last_sub(uint32_t)
-define_col_find_last_sub(uint64_t)
+define_col_find_range_sub(uint8_t)
+define_col_find_range_sub(uint16_t)
+define_col_find_range_sub(uint32_t)
+define_col_find_range_sub(uint64_t)
+
+/**
+ * Generic function to search for the first occurrence of a batch of unsigned integers
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_col_find_first_batch(T) \
+/** Search for the first occurrence of each unsigned integer of a batch on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+The searches of BINSEARCH_BATCH values are executed in lockstep, prefetching the next probe of each search,
+so the memory accesses of independent searches are overlapped.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param first     Element from where to start the searches (min value = 0).
+@param last      Element (up to but not including) where to end the searches (max value = nrows).
+@param search    Array of n unsigned numbers to search (type T).
+@param out       Array of n results: item number if found or last if not found (as returned by col_find_first_T).
+@param n         Number of values to search.
+ */ \
+static inline void col_find_first_batch_##T(const T *src, uint64_t first, uint64_t last, const T *search, uint64_t *out, uint64_t n) \
+{ \
+FIND_BATCH_START_LOOP_BLOCK(T) \
+COL_GET_ITEM_TASK \
+FIND_FIRST_BATCH_INNER_CHECK \
+COL_PREFETCH_MIDDLE_TASK \
+FIND_BATCH_END_INNER_LOOP_BLOCK \
+COL_GET_ITEM_TASK \
+FIND_FIRST_BATCH_NEXT_BLOCK \
+COL_GET_ITEM_TASK \
+FIND_BATCH_END_LOOP_BLOCK \
+}
+
+define_col_find_first_batch(uint8_t)
+define_col_find_first_batch(uint16_t)
+define_col_find_first_batch(uint32_t)
+define_col_find_first_batch(uint64_t)
+
+/**
+ * Generic function to search for the last occurrence of a batch of unsigned integers
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_col_find_last_batch(T) \
+/** Search for the last occurrence of each unsigned integer of a batch on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+The searches of BINSEARCH_BATCH values are executed in lockstep, prefetching the next probe of each search,
+so the memory accesses of independent searches are overlapped.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param first     Element from where to start the searches (min value = 0).
+@param last      Element (up to but not including) where to end the searches (max value = nrows).
+@param search    Array of n unsigned numbers to search (type T).
+@param out       Array of n results: item number if found or last if not found (as returned by col_find_last_T).
+@param n         Number of values to search.
+ */ \
+static inline void col_find_last_batch_##T(const T *src, uint64_t first, uint64_t last, const T *search, uint64_t *out, uint64_t n) \
+{ \
+FIND_BATCH_START_LOOP_BLOCK(T) \
+COL_GET_ITEM_TASK \
+FIND_LAST_BATCH_INNER_CHECK \
+COL_PREFETCH_MIDDLE_TASK \
+FIND_BATCH_END_INNER_LOOP_BLOCK \
+COL_GET_ITEM_TASK \
+FIND_LAST_BATCH_NEXT_BLOCK \
+COL_GET_ITEM_TASK \
+FIND_BATCH_END_LOOP_BLOCK \
+}
+
+define_col_find_last_batch(uint8_t)
+define_col_find_last_batch(uint16_t)
+define_col_find_last_batch(uint32_t)
+define_col_find_last_batch(uint64_t)
 
 /**
  * Generic function to check if the next item still matches the search value.
@@ -911,6 +1971,300 @@ define_col_has_prev_sub(uint16_t)
 define_col_has_prev_sub(uint32_t)
 define_col_has_prev_sub(uint64_t)
 
+/**
+ * Generic function to find the end of a run of items matching a masked unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_col_scan_run_mask(T) \
+/** Find the end of the run of items that, masked with "mask", are equal to "value",
+on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+When SSE2 is available, 64 bytes (a cache line) are compared per iteration: the masked items are compared byte by byte with the value,
+so the same code works for every type, and the first mismatching byte gives the end of the run.
+@param src       Memory mapped file address.
+@param pos       First item to check.
+@param last      Element (up to but not including) where to end the scan (max value = nrows).
+@param mask      Bit mask to apply to each item.
+@param value     Masked value to match.
+@return Position of the first item not matching the value (pos if the item at pos does not match), or last.
+ */ \
+static inline uint64_t col_scan_run_mask_##T(const T *src, uint64_t pos, uint64_t last, T mask, T value) \
+{ \
+    SCAN_RUN_SIMD_BLOCK(T) \
+    while ((pos < last) && ((src[pos] & mask) == value)) \
+    { \
+        ++pos; \
+    } \
+    return pos; \
+}
+
+define_col_scan_run_mask(uint8_t)
+define_col_scan_run_mask(uint16_t)
+define_col_scan_run_mask(uint32_t)
+define_col_scan_run_mask(uint64_t)
+
+/**
+ * Generic function to find the end of a run of items matching an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_col_scan_run(T) \
+/** Find the end of the run of items matching an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type, starting from the specified position.
+This is equivalent to calling col_has_next_T until it returns false, but it uses SIMD compares when available.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param pos       First item to check (e.g. the item returned by col_find_first_T).
+@param last      Element (up to but not including) where to end the scan (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return Position of the first item not matching the search value (pos if the item at pos does not match), or last.
+ */ \
+static inline uint64_t col_scan_run_##T(const T *src, uint64_t pos, uint64_t last, T search) \
+{ \
+    return col_scan_run_mask_##T(src, pos, last, (T)~(T)0, search); \
+}
+
+define_col_scan_run(uint8_t)
+define_col_scan_run(uint16_t)
+define_col_scan_run(uint32_t)
+define_col_scan_run(uint64_t)
+
+/**
+ * Generic function to find the end of a run of items matching an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_col_scan_run_sub(T) \
+/** Find the end of the run of items matching an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type, starting from the specified position.
+This is equivalent to calling col_has_next_sub_T until it returns false, but it uses SIMD compares when available.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param pos       First item to check (e.g. the item returned by col_find_first_sub_T).
+@param last      Element (up to but not including) where to end the scan (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return Position of the first item not matching the search value (pos if the item at pos does not match), or last.
+ */ \
+static inline uint64_t col_scan_run_sub_##T(const T *src, uint8_t bitstart, uint8_t bitend, uint64_t pos, uint64_t last, T search) \
+{ \
+SCAN_SUB_VARS(T) \
+    return col_scan_run_mask_##T(src, pos, last, mask, value); \
+}
+
+define_col_scan_run_sub(uint8_t)
+define_col_scan_run_sub(uint16_t)
+define_col_scan_run_sub(uint32_t)
+define_col_scan_run_sub(uint64_t)
+
+/**
+ * Generic function to collect the positions of a run of items matching an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_col_fill_run(T) \
+/** Collect up to n positions of the run of items matching an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type, starting from the specified position.
+The function can be called again with the updated position until it returns less than n items.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param pos       Pointer to the first item to check (e.g. the item returned by col_find_first_T).
+                 This will be updated to point to the item after the last collected one.
+@param last      Element (up to but not including) where to end the scan (max value = nrows).
+@param search    Unsigned number to search (type T).
+@param out       Array of at least n elements to store the positions of the matching items.
+@param n         Maximum number of positions to collect.
+@return Number of collected positions.
+ */ \
+static inline uint64_t col_fill_run_##T(const T *src, uint64_t *pos, uint64_t last, T search, uint64_t *out, uint64_t n) \
+{ \
+FILL_RUN_START_BLOCK \
+        end = col_scan_run_##T(src, *pos, end, search); \
+FILL_RUN_END_BLOCK \
+}
+
+define_col_fill_run(uint8_t)
+define_col_fill_run(uint16_t)
+define_col_fill_run(uint32_t)
+define_col_fill_run(uint64_t)
+
+/**
+ * Generic function to collect the positions of a run of items matching an unsigned integer
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t
+ */
+#define define_col_fill_run_sub(T) \
+/** Collect up to n positions of the run of items matching an unsigned integer on a memory buffer
+containing contiguos blocks of unsigned integers of the same type, starting from the specified position.
+The function can be called again with the updated position until it returns less than n items.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param pos       Pointer to the first item to check (e.g. the item returned by col_find_first_sub_T).
+                 This will be updated to point to the item after the last collected one.
+@param last      Element (up to but not including) where to end the scan (max value = nrows).
+@param search    Unsigned number to search (type T).
+@param out       Array of at least n elements to store the positions of the matching items.
+@param n         Maximum number of positions to collect.
+@return Number of collected positions.
+ */ \
+static inline uint64_t col_fill_run_sub_##T(const T *src, uint8_t bitstart, uint8_t bitend, uint64_t *pos, uint64_t last, T search, uint64_t *out, uint64_t n) \
+{ \
+FILL_RUN_START_BLOCK \
+        end = col_scan_run_sub_##T(src, bitstart, bitend, *pos, end, search); \
+FILL_RUN_END_BLOCK \
+}
+
+define_col_fill_run_sub(uint8_t)
+define_col_fill_run_sub(uint16_t)
+define_col_fill_run_sub(uint32_t)
+define_col_fill_run_sub(uint64_t)
+
+// --- COLUMN MODE 128 BIT ---
+
+#define COL_GET_ITEM128_TASK(P) \
+        xlo = src[(2 * (P))]; \
+        xhi = src[(2 * (P)) + 1];
+
+/**
+ * Search for the first occurrence of an unsigned 128 bit integer on a memory buffer containing contiguos 16 byte items.
+ * Each item is stored as two uint64_t words, the low word first (i.e. a Little-Endian unsigned 128 bit integer),
+ * as produced by sort_uint128_t() or by an array of numkey128_t.
+ * The items must be sorted in ascending order.
+ *
+ * @param src       Memory mapped file address.
+ * @param first     Pointer to the element from where to start the search (min value = 0).
+ * @param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+ * @param shi       High 64 bits of the unsigned number to search.
+ * @param slo       Low 64 bits of the unsigned number to search.
+ *
+ * @return item number if found or (last + 1) if not found.
+ */
+static inline uint64_t col_find_first_uint128_t(const uint64_t *src, uint64_t *first, uint64_t *last, uint64_t shi, uint64_t slo)
+{
+    uint64_t middle, notfound = *last;
+    uint64_t xhi, xlo;
+    while (*first < *last)
+    {
+        middle = get_middle_point(*first, *last);
+        COL_GET_ITEM128_TASK(middle)
+        if ((xhi < shi) || ((xhi == shi) && (xlo < slo)))
+        {
+            *first = middle;
+            ++(*first);
+        }
+        else
+        {
+            *last = middle;
+        }
+    }
+    middle = *first;
+    if (middle < notfound)
+    {
+        COL_GET_ITEM128_TASK(middle)
+        if ((xhi == shi) && (xlo == slo))
+        {
+            return middle;
+        }
+    }
+    if (*first > 0)
+    {
+        --(*first);
+    }
+    return notfound;
+}
+
+/**
+ * Search for the last occurrence of an unsigned 128 bit integer on a memory buffer containing contiguos 16 byte items.
+ * Each item is stored as two uint64_t words, the low word first (i.e. a Little-Endian unsigned 128 bit integer).
+ * The items must be sorted in ascending order.
+ *
+ * @param src       Memory mapped file address.
+ * @param first     Pointer to the element from where to start the search (min value = 0).
+ * @param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+ * @param shi       High 64 bits of the unsigned number to search.
+ * @param slo       Low 64 bits of the unsigned number to search.
+ *
+ * @return Item number if found or (last + 1) if not found.
+ */
+static inline uint64_t col_find_last_uint128_t(const uint64_t *src, uint64_t *first, uint64_t *last, uint64_t shi, uint64_t slo)
+{
+    uint64_t middle, notfound = *last;
+    uint64_t xhi, xlo;
+    while (*first < *last)
+    {
+        middle = get_middle_point(*first, *last);
+        COL_GET_ITEM128_TASK(middle)
+        if ((xhi > shi) || ((xhi == shi) && (xlo > slo)))
+        {
+            *last = middle;
+        }
+        else
+        {
+            *first = middle;
+            ++(*first);
+        }
+    }
+    middle = *first;
+    if (middle > 0)
+    {
+        --middle;
+        COL_GET_ITEM128_TASK(middle)
+        if ((xhi == shi) && (xlo == slo))
+        {
+            return middle;
+        }
+    }
+    if (*first > 0)
+    {
+        --(*first);
+    }
+    return notfound;
+}
+
+/**
+ * Check if the next 128 bit item still matches the search value.
+ * The item returned by col_find_first_uint128_t should be set as the "pos" parameter in this function.
+ *
+ * @param src       Memory mapped file address.
+ * @param pos       Pointer to the current item position. This will be updated to point to the next position.
+ * @param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+ * @param shi       High 64 bits of the unsigned number to search.
+ * @param slo       Low 64 bits of the unsigned number to search.
+ *
+ * @return 1 if the next item is valid, 0 otherwise.
+ */
+static inline bool col_has_next_uint128_t(const uint64_t *src, uint64_t *pos, uint64_t last, uint64_t shi, uint64_t slo)
+{
+    HAS_NEXT_START_BLOCK
+    return ((src[(2 * (*pos)) + 1] == shi) && (src[(2 * (*pos))] == slo));
+}
+
+/**
+ * Check if the previous 128 bit item still matches the search value.
+ * The item returned by col_find_last_uint128_t should be set as the "pos" parameter in this function.
+ *
+ * @param src       Memory mapped file address.
+ * @param first     First element of the range to search (min value = 0).
+ * @param pos       Pointer to the current item position. This will be updated to point to the previous position.
+ * @param shi       High 64 bits of the unsigned number to search.
+ * @param slo       Low 64 bits of the unsigned number to search.
+ *
+ * @return 1 if the previous item is valid, 0 otherwise.
+ */
+static inline bool col_has_prev_uint128_t(const uint64_t *src, uint64_t first, uint64_t *pos, uint64_t shi, uint64_t slo)
+{
+    HAS_PREV_START_BLOCK
+    return ((src[(2 * (*pos)) + 1] == shi) && (src[(2 * (*pos))] == slo));
+}
+
 // --- FILE ---
 
 static inline void parse_col_offset(mmfile_t *mf)
@@ -1039,4 +2393,219 @@ static inline int munmap_binfile(mmfile_t mf)
     return close(mf.fd);
 }
 
+// --- COMPOSITE KEYS ---
+
+/**
+ * Generic function to advance in lockstep a set of independent bound searches
+ * on a memory buffer containing contiguos blocks of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_col_bound_batch(T) \
+/** Advance in lockstep a set of independent lower or upper bound searches on a memory buffer
+containing contiguos blocks of unsigned integers of the same type.
+Each step halves the range of every search and prefetches its next probe,
+so the memory accesses of independent searches are overlapped.
+The values must be encoded in Little-Endian format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param key       Array of m unsigned numbers to search (type T).
+@param pos       Array of m positions: first element of each range on input, bound on output.
+@param len       Array of m range lengths (last - first). The values are modified by the function.
+@param m         Number of searches.
+@param upper     If true, search the upper bound (first item greater than the key), otherwise the lower bound (first item not less than the key).
+ */ \
+static inline void col_bound_batch_##T(const T *src, const T *key, uint64_t *pos, uint64_t *len, uint64_t m, bool upper) \
+{ \
+    uint64_t j, half, middle; \
+    bool active = true; \
+    while (active) \
+    { \
+        active = false; \
+        for (j = 0; j < m; j++) \
+        { \
+            if (len[j] > 1) \
+            { \
+                half = (len[j] >> 1); \
+                middle = (pos[j] + half); \
+                pos[j] = ((src[middle] < key[j]) || (upper && (src[middle] == key[j]))) ? middle : pos[j]; \
+                len[j] -= half; \
+                binsearch_prefetch(src + pos[j] + (len[j] >> 1)); \
+                active = true; \
+            } \
+        } \
+    } \
+    for (j = 0; j < m; j++) \
+    { \
+        if (len[j] == 1) \
+        { \
+            pos[j] += (uint64_t)((src[pos[j]] < key[j]) || (upper && (src[pos[j]] == key[j]))); \
+        } \
+    } \
+}
+
+define_col_bound_batch(uint8_t)
+define_col_bound_batch(uint16_t)
+define_col_bound_batch(uint32_t)
+define_col_bound_batch(uint64_t)
+
+/**
+ * Generic function to narrow a batch of row ranges to the rows matching the values of a column.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_col_range_batch_step(T) \
+/** Narrow a batch of row ranges to the rows matching the values of a column.
+@param mf        Structure containing the memory mapped file.
+@param col       Column index.
+@param search    Array of m values to search (the first value of each tuple to process).
+@param stride    Distance between the values of two consecutive tuples (number of columns of each tuple).
+@param rfirst    Array of m range starts, updated with the first matching row (or the insertion position).
+@param rlast     Array of m range ends, updated with the row after the last matching one (or the insertion position).
+@param m         Number of ranges (max BINSEARCH_BATCH).
+ */ \
+static inline void col_range_batch_step_##T(const mmfile_t *mf, uint8_t col, const uint64_t *search, uint8_t stride, uint64_t *rfirst, uint64_t *rlast, uint64_t m) \
+{ \
+    const T *src = get_src_offset_##T(mf->src, mf->index[col]); \
+    T key[BINSEARCH_BATCH]; \
+    uint64_t pos[BINSEARCH_BATCH], len[BINSEARCH_BATCH]; \
+    uint64_t j; \
+    for (j = 0; j < m; j++) \
+    { \
+        key[j] = (T)search[(j * stride)]; \
+        pos[j] = (search[(j * stride)] > (T)~(T)0) ? rlast[j] : rfirst[j]; /* values out of type range are never found */ \
+        len[j] = (rlast[j] - pos[j]); \
+    } \
+    col_bound_batch_##T(src, key, pos, len, m, false); \
+    for (j = 0; j < m; j++) \
+    { \
+        rfirst[j] = pos[j]; \
+        len[j] = (rlast[j] - pos[j]); \
+    } \
+    col_bound_batch_##T(src, key, pos, len, m, true); \
+    for (j = 0; j < m; j++) \
+    { \
+        rlast[j] = pos[j]; \
+    } \
+}
+
+define_col_range_batch_step(uint8_t)
+define_col_range_batch_step(uint16_t)
+define_col_range_batch_step(uint32_t)
+define_col_range_batch_step(uint64_t)
+
+/**
+ * Search for the range of rows matching a composite key (tuple of values) on a memory mapped file in column mode.
+ * The columns are resolved in order: the range matching the first value is searched on the first column,
+ * then the range is narrowed by searching the second value on the second column, and so on.
+ * Each column must be sorted in ascending order within the rows matching the previous values
+ * (e.g. a NumKey column followed by an effective date column).
+ *
+ * @param mf     Structure containing the memory mapped file.
+ * @param cols   Array of ncols column indexes (less than mf->ncols), in resolution order.
+ * @param ncols  Number of values in the composite key.
+ * @param search Array of ncols values to search (converted to the column type).
+ * @param first  Pointer to the row from where to start the search (min value = 0).
+ *               This will be set to the first matching row, or to the insertion position if not found.
+ * @param last   Pointer to the row (up to but not including) where to end the search (max value = nrows).
+ *               This will be set to the row after the last matching one, or to the insertion position if not found.
+ *
+ * @return Number of matching rows (last - first).
+ *         Columns with a type other than uint8_t, uint16_t, uint32_t or uint64_t never match.
+ */
+static inline uint64_t col_find_range_cols(const mmfile_t *mf, const uint8_t *cols, uint8_t ncols, const uint64_t *search, uint64_t *first, uint64_t *last)
+{
+    uint8_t c;
+    for (c = 0; (c < ncols) && (*first < *last); c++)
+    {
+        switch ((cols[c] < mf->ncols) ? mf->ctbytes[cols[c]] : 0) // an invalid column gives an empty range
+        {
+        case 1:
+            if (search[c] > UINT8_MAX)
+            {
+                *first = *last; // never found
+                break;
+            }
+            (void) col_find_range_uint8_t(get_src_offset_uint8_t(mf->src, mf->index[cols[c]]), first, last, (uint8_t)search[c]);
+            break;
+        case 2:
+            if (search[c] > UINT16_MAX)
+            {
+                *first = *last; // never found
+                break;
+            }
+            (void) col_find_range_uint16_t(get_src_offset_uint16_t(mf->src, mf->index[cols[c]]), first, last, (uint16_t)search[c]);
+            break;
+        case 4:
+            if (search[c] > UINT32_MAX)
+            {
+                *first = *last; // never found
+                break;
+            }
+            (void) col_find_range_uint32_t(get_src_offset_uint32_t(mf->src, mf->index[cols[c]]), first, last, (uint32_t)search[c]);
+            break;
+        case 8:
+            (void) col_find_range_uint64_t(get_src_offset_uint64_t(mf->src, mf->index[cols[c]]), first, last, search[c]);
+            break;
+        default:
+            *last = *first;
+            break;
+        }
+    }
+    return (*last - *first);
+}
+
+/**
+ * Search for the ranges of rows matching a batch of composite keys (tuples of values) on a memory mapped file in column mode.
+ * This is equivalent to calling col_find_range_cols for each tuple, but BINSEARCH_BATCH tuples are resolved in lockstep,
+ * column by column, prefetching the next probe of each search, so the memory accesses of independent searches are overlapped.
+ *
+ * @param mf     Structure containing the memory mapped file.
+ * @param cols   Array of ncols column indexes (less than mf->ncols), in resolution order.
+ * @param ncols  Number of values in each composite key.
+ * @param search Array of (n * ncols) values to search: the values of the first tuple, followed by the values of the second tuple, and so on.
+ * @param first  Row from where to start the searches (min value = 0).
+ * @param last   Row (up to but not including) where to end the searches (max value = nrows).
+ * @param rfirst Array of n results: first matching row, or insertion position if not found.
+ * @param rlast  Array of n results: row after the last matching one, or insertion position if not found.
+ * @param n      Number of tuples to search.
+ */
+static inline void col_find_range_cols_batch(const mmfile_t *mf, const uint8_t *cols, uint8_t ncols, const uint64_t *search, uint64_t first, uint64_t last, uint64_t *rfirst, uint64_t *rlast, uint64_t n)
+{
+    uint64_t i, j, m;
+    uint8_t c;
+    for (i = 0; i < n; i += BINSEARCH_BATCH)
+    {
+        m = ((n - i) < BINSEARCH_BATCH) ? (n - i) : BINSEARCH_BATCH;
+        for (j = 0; j < m; j++)
+        {
+            rfirst[(i + j)] = first;
+            rlast[(i + j)] = (first < last) ? last : first;
+        }
+        for (c = 0; c < ncols; c++)
+        {
+            switch ((cols[c] < mf->ncols) ? mf->ctbytes[cols[c]] : 0) // an invalid column gives empty ranges
+            {
+            case 1:
+                col_range_batch_step_uint8_t(mf, cols[c], (search + (i * ncols) + c), ncols, (rfirst + i), (rlast + i), m);
+                break;
+            case 2:
+                col_range_batch_step_uint16_t(mf, cols[c], (search + (i * ncols) + c), ncols, (rfirst + i), (rlast + i), m);
+                break;
+            case 4:
+                col_range_batch_step_uint32_t(mf, cols[c], (search + (i * ncols) + c), ncols, (rfirst + i), (rlast + i), m);
+                break;
+            case 8:
+                col_range_batch_step_uint64_t(mf, cols[c], (search + (i * ncols) + c), ncols, (rfirst + i), (rlast + i), m);
+                break;
+            default:
+                for (j = 0; j < m; j++)
+                {
+                    rlast[(i + j)] = rfirst[(i + j)];
+                }
+                break;
+            }
+        }
+    }
+}
+
 #endif  // NUMKEY_BINSEARCH_H
@@ -0,0 +1,347 @@
+// NumKey
+//
+// bitpack.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file bitpack.h
+ * @brief Compressed sorted NumKey column.
+ *
+ * The functions provided here allows to store a sorted column of NumKey codes (or any sorted uint64_t values)
+ * in blocks of NKBITPACK_BLOCK keys compressed with frame-of-reference and bit-packing:
+ * each key is stored as the difference from the first (minimum) key of its block, shifted right by the number of
+ * trailing zero bits common to all the differences of the block (e.g. the NumKey LENGTH bits when all the numbers
+ * have the same length), using only the bits required by the largest difference.
+ * The first key of every block is also stored in a skip index, so a search binary-searches the skip index
+ * and then decodes only the keys it needs from a single block.
+ *
+ * The column is serialized as a single blob of uint64_t words that can be memory-mapped
+ * (e.g. with mmap_binfile) and used directly with bitpack_load, without any parsing or allocation:
+ *
+ *   - header (NKBITPACK_HEADER_WORDS): magic "NKPACK1", nkeys, nblocks, nwords;
+ *   - skip index (nblocks): first key of each block;
+ *   - block info (nblocks): offset of the block data in words (<< 16) | shift (<< 8) | number of bits per key;
+ *   - data (nwords + NKBITPACK_PADWORDS): bit-packed key differences (2 words per bit per block).
+ */
+
+#ifndef NUMKEY_BITPACK_H
+#define NUMKEY_BITPACK_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binsearch.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define NKBITPACK_MAGIC        0x00314b4341504b4e //!< Magic number "NKPACK1" in LE.
+#define NKBITPACK_HEADER_WORDS 4                  //!< Number of uint64_t words in the header.
+#define NKBITPACK_BLOCK        128                //!< Number of keys per block.
+#define NKBITPACK_PADWORDS     2                  //!< Number of zero words after the data, so the unpack kernels can always read two consecutive words.
+#define NKBITPACK_BITSMASK     0xFF               //!< Bit mask for the number of bits in the block info.
+#define NKBITPACK_SHIFTSHIFT   8                  //!< Position of the difference shift in the block info.
+#define NKBITPACK_OFFSETSHIFT  16                 //!< Position of the data offset in the block info.
+
+/**
+ * Read-only view of a serialized compressed column.
+ */
+typedef struct bitpack_t
+{
+    const uint64_t *base; //!< First key of each block (skip index).
+    const uint64_t *info; //!< Data offset in words, difference shift and number of bits of each block.
+    const uint64_t *data; //!< Bit-packed key differences.
+    uint64_t nkeys;       //!< Number of keys.
+    uint64_t nblocks;     //!< Number of blocks.
+    uint64_t nwords;      //!< Number of data words (excluding the padding).
+} bitpack_t;
+
+/**
+ * Returns the number of bits required to store the specified value.
+ */
+static inline uint8_t bitpack_bits(uint64_t v)
+{
+#if defined(__GNUC__)
+    return (v == 0) ? 0 : (uint8_t)(64 - __builtin_clzll(v));
+#else
+    uint8_t b = 0;
+    while (v != 0)
+    {
+        v >>= 1;
+        b++;
+    }
+    return b;
+#endif
+}
+
+/**
+ * Returns the bit mask for values of the specified number of bits (0 to 64).
+ */
+static inline uint64_t bitpack_mask(uint8_t bits)
+{
+    return (bits >= 64) ? ~(uint64_t)0 : (((uint64_t)1 << bits) - 1);
+}
+
+/**
+ * Returns the packed value at the specified bit position (the value may cross a word boundary).
+ */
+static inline uint64_t bitpack_read(const uint64_t *data, uint64_t pos, uint64_t mask)
+{
+    uint64_t w = (pos >> 6);
+    uint64_t s = (pos & 63);
+    return (((data[w] >> s) | ((data[(w + 1)] << 1) << (63 - s))) & mask); // the double shift avoids the undefined shift by 64
+}
+
+/**
+ * Initialize a compressed column view from a serialized blob (e.g. a memory-mapped file).
+ * The blob is not copied and it must be kept valid while the view is used.
+ *
+ * @param src  Address of the serialized blob (8-byte aligned).
+ * @param size Size of the blob in bytes.
+ * @param bp   View to initialize.
+ *
+ * @return False if the blob is not a valid serialized compressed column, true otherwise.
+ */
+static inline bool bitpack_load(const uint8_t *src, uint64_t size, bitpack_t *bp)
+{
+    const uint64_t *p = (const uint64_t *)src;
+    if ((size < (NKBITPACK_HEADER_WORDS * sizeof(uint64_t))) || (p[0] != NKBITPACK_MAGIC))
+    {
+        return false;
+    }
+    bp->nkeys = p[1];
+    bp->nblocks = p[2];
+    bp->nwords = p[3];
+    if (((size / sizeof(uint64_t)) < (NKBITPACK_HEADER_WORDS + (2 * bp->nblocks) + bp->nwords + NKBITPACK_PADWORDS))
+            || (bp->nblocks != ((bp->nkeys + NKBITPACK_BLOCK - 1) / NKBITPACK_BLOCK)))
+    {
+        return false;
+    }
+    p += NKBITPACK_HEADER_WORDS;
+    bp->base = p;
+    p += bp->nblocks;
+    bp->info = p;
+    p += bp->nblocks;
+    bp->data = p;
+    return true;
+}
+
+/**
+ * Returns the number of keys in the specified block.
+ */
+static inline uint64_t bitpack_block_size(const bitpack_t *bp, uint64_t blk)
+{
+    uint64_t end = ((blk + 1) * NKBITPACK_BLOCK);
+    return (((end < bp->nkeys) ? end : bp->nkeys) - (blk * NKBITPACK_BLOCK));
+}
+
+/**
+ * Decode all the NKBITPACK_BLOCK keys of a block (the items after the end of the last block are undefined).
+ * With AVX2 four keys are extracted at once with gather and variable shift instructions.
+ *
+ * @param bp  Compressed column view.
+ * @param blk Block number.
+ * @param out Output buffer of NKBITPACK_BLOCK items.
+ */
+static inline void bitpack_unpack_block(const bitpack_t *bp, uint64_t blk, uint64_t *out)
+{
+    const uint64_t base = bp->base[blk];
+    const uint8_t bits = (uint8_t)(bp->info[blk] & NKBITPACK_BITSMASK);
+    const uint8_t shift = (uint8_t)((bp->info[blk] >> NKBITPACK_SHIFTSHIFT) & NKBITPACK_BITSMASK);
+    const uint64_t *data = (bp->data + (bp->info[blk] >> NKBITPACK_OFFSETSHIFT));
+    const uint64_t mask = bitpack_mask(bits);
+    uint64_t i = 0;
+#if defined(__AVX2__)
+    const __m256i vbase = _mm256_set1_epi64x((long long)base);
+    const __m256i vmask = _mm256_set1_epi64x((long long)mask);
+    const __m128i vshift = _mm_cvtsi64_si128((long long)shift);
+    const __m256i vstep = _mm256_set1_epi64x((long long)(4 * bits));
+    const __m256i v63 = _mm256_set1_epi64x(63);
+    const __m256i v64 = _mm256_set1_epi64x(64);
+    __m256i pos = _mm256_set_epi64x((long long)(3 * bits), (long long)(2 * bits), (long long)bits, 0);
+    for (i = 0; i < NKBITPACK_BLOCK; i += 4)
+    {
+        __m256i w = _mm256_srli_epi64(pos, 6);
+        __m256i s = _mm256_and_si256(pos, v63);
+        __m256i lo = _mm256_i64gather_epi64((const long long *)data, w, 8);
+        __m256i hi = _mm256_i64gather_epi64((const long long *)(data + 1), w, 8);
+        __m256i v = _mm256_or_si256(_mm256_srlv_epi64(lo, s), _mm256_sllv_epi64(hi, _mm256_sub_epi64(v64, s))); // shift by 64 returns 0
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_add_epi64(vbase, _mm256_sll_epi64(_mm256_and_si256(v, vmask), vshift)));
+        pos = _mm256_add_epi64(pos, vstep);
+    }
+#else
+    for (i = 0; i < NKBITPACK_BLOCK; i++)
+    {
+        out[i] = (base + (bitpack_read(data, (i * bits), mask) << shift));
+    }
+#endif
+}
+
+/**
+ * Returns the key at the specified position without decoding the whole block.
+ *
+ * @param bp Compressed column view.
+ * @param i  Key position (it must be less than nkeys).
+ *
+ * @return Key value.
+ */
+static inline uint64_t bitpack_get(const bitpack_t *bp, uint64_t i)
+{
+    uint64_t blk = (i / NKBITPACK_BLOCK);
+    uint8_t bits = (uint8_t)(bp->info[blk] & NKBITPACK_BITSMASK);
+    uint8_t shift = (uint8_t)((bp->info[blk] >> NKBITPACK_SHIFTSHIFT) & NKBITPACK_BITSMASK);
+    return (bp->base[blk] + (bitpack_read(bp->data + (bp->info[blk] >> NKBITPACK_OFFSETSHIFT), ((i % NKBITPACK_BLOCK) * bits), bitpack_mask(bits)) << shift));
+}
+
+/**
+ * Returns the position of the first key equal to the search key.
+ * The skip index is binary-searched to find the only block that can contain the first occurrence of the key,
+ * then the packed differences of that block are binary-searched in place, decoding only the visited keys.
+ *
+ * @param bp     Compressed column view.
+ * @param search Key to search.
+ *
+ * @return Position of the first key equal to the search key, or nkeys if not found.
+ */
+static inline uint64_t bitpack_find_first(const bitpack_t *bp, uint64_t search)
+{
+    uint64_t first = 0, last = bp->nblocks, middle = 0;
+    while (first < last)
+    {
+        middle = get_middle_point(first, last);
+        if (bp->base[middle] < search)
+        {
+            first = (middle + 1);
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    // first is the number of blocks starting with a key smaller than the search key
+    if (first == 0)
+    {
+        return ((bp->nblocks > 0) && (bp->base[0] == search)) ? 0 : bp->nkeys;
+    }
+    const uint64_t blk = (first - 1);
+    const uint64_t bsize = bitpack_block_size(bp, blk);
+    const uint8_t bits = (uint8_t)(bp->info[blk] & NKBITPACK_BITSMASK);
+    const uint8_t shift = (uint8_t)((bp->info[blk] >> NKBITPACK_SHIFTSHIFT) & NKBITPACK_BITSMASK);
+    const uint64_t *data = (bp->data + (bp->info[blk] >> NKBITPACK_OFFSETSHIFT));
+    const uint64_t mask = bitpack_mask(bits);
+    const uint64_t diff = (search - bp->base[blk]);
+    uint64_t bfirst = 1, blast = bsize, x = 0; // the first key of the block is smaller than the search key
+    if ((diff & bitpack_mask(shift)) == 0)
+    {
+        const uint64_t dsearch = (diff >> shift);
+        while (bfirst < blast)
+        {
+            middle = get_middle_point(bfirst, blast);
+            x = bitpack_read(data, (middle * bits), mask);
+            if (x < dsearch)
+            {
+                bfirst = (middle + 1);
+            }
+            else
+            {
+                blast = middle;
+            }
+        }
+        if ((bfirst < bsize) && (bitpack_read(data, (bfirst * bits), mask) == dsearch))
+        {
+            return ((blk * NKBITPACK_BLOCK) + bfirst);
+        }
+    }
+    if ((first < bp->nblocks) && (bp->base[first] == search))
+    {
+        return (first * NKBITPACK_BLOCK); // the key starts the next block
+    }
+    return bp->nkeys;
+}
+
+/**
+ * Computes the number of bits and the shift of the packed differences of a block.
+ */
+static inline void bitpack_block_params(const uint64_t *keys, uint64_t n, uint8_t *bits, uint8_t *shift)
+{
+    uint64_t i = 0, zbits = 0;
+    for (i = 1; i < n; i++)
+    {
+        zbits |= (keys[i] - keys[0]);
+    }
+    *shift = 0;
+    if (zbits != 0)
+    {
+        while (((zbits >> *shift) & 1) == 0)
+        {
+            (*shift)++;
+        }
+    }
+    *bits = bitpack_bits((keys[(n - 1)] - keys[0]) >> *shift);
+}
+
+/**
+ * Compress a sorted array of keys and serialize it.
+ *
+ * @param keys  Sorted array of keys (e.g. processed with sort_uint64_t).
+ * @param nkeys Number of keys.
+ * @param size  Pointer to the size in bytes of the returned blob.
+ *
+ * @return Serialized blob allocated with malloc (to be freed by the caller), or NULL in case of memory allocation failure.
+ */
+static inline uint8_t *bitpack_build(const uint64_t *keys, uint64_t nkeys, uint64_t *size)
+{
+    uint64_t nblocks = ((nkeys + NKBITPACK_BLOCK - 1) / NKBITPACK_BLOCK);
+    uint64_t nwords = 0, blk = 0, i = 0, start = 0, end = 0, pos = 0, v = 0;
+    uint8_t bits = 0, shift = 0;
+    for (blk = 0; blk < nblocks; blk++)
+    {
+        start = (blk * NKBITPACK_BLOCK);
+        end = ((start + NKBITPACK_BLOCK) < nkeys) ? (start + NKBITPACK_BLOCK) : nkeys;
+        bitpack_block_params(keys + start, (end - start), &bits, &shift);
+        nwords += (2 * (uint64_t)bits); // 128 keys * bits / 64
+    }
+    *size = ((NKBITPACK_HEADER_WORDS + (2 * nblocks) + nwords + NKBITPACK_PADWORDS) * sizeof(uint64_t));
+    uint8_t *blob = (uint8_t *)calloc(*size, 1);
+    if (blob == NULL)
+    {
+        return NULL;
+    }
+    uint64_t *p = (uint64_t *)blob;
+    p[0] = NKBITPACK_MAGIC;
+    p[1] = nkeys;
+    p[2] = nblocks;
+    p[3] = nwords;
+    uint64_t *base = (p + NKBITPACK_HEADER_WORDS);
+    uint64_t *info = (base + nblocks);
+    uint64_t *data = (info + nblocks);
+    uint64_t offset = 0;
+    for (blk = 0; blk < nblocks; blk++)
+    {
+        start = (blk * NKBITPACK_BLOCK);
+        end = ((start + NKBITPACK_BLOCK) < nkeys) ? (start + NKBITPACK_BLOCK) : nkeys;
+        bitpack_block_params(keys + start, (end - start), &bits, &shift);
+        base[blk] = keys[start];
+        info[blk] = ((offset << NKBITPACK_OFFSETSHIFT) | ((uint64_t)shift << NKBITPACK_SHIFTSHIFT) | bits);
+        for (i = start, pos = (offset << 6); i < end; i++, pos += bits)
+        {
+            v = ((keys[i] - keys[start]) >> shift);
+            data[(pos >> 6)] |= (v << (pos & 63));
+            if (((pos & 63) + bits) > 64)
+            {
+                data[((pos >> 6) + 1)] |= (v >> (64 - (pos & 63)));
+            }
+        }
+        offset += (2 * (uint64_t)bits);
+    }
+    return blob;
+}
+
+#endif  // NUMKEY_BITPACK_H
@@ -0,0 +1,397 @@
+// NumKey
+//
+// e164.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file e164.h
+ * @brief E.164 number normalization functions.
+ *
+ * The functions provided here allows to extract the significant digits of numbers formatted for humans,
+ * like "+44 (0)20 7946-0018" or "0044 20 7946 0018", without allocating a cleaned copy of the string,
+ * and to resolve the ISO 3166 alpha-2 country code of an E.164 number from its calling code.
+ */
+
+#ifndef NUMKEY_E164_H
+#define NUMKEY_E164_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+/**
+ * Encodes a calling code table entry: code length (2 bit) and country letters (5 + 5 bit, A=1, ..., Z=26).
+ *
+ * @param a   First letter of the ISO 3166 alpha-2 country code.
+ * @param b   Second letter of the ISO 3166 alpha-2 country code.
+ * @param len Number of digits of the calling code (1 to 3).
+ */
+#define E164CC(a, b, len) (uint16_t)(((len) << 10) | (((a) - 64) << 5) | ((b) - 64))
+
+#define E164BMASK_COUNTRY 0x03FF //!< Bit mask for the country letters in a calling code table entry.
+#define E164BSHIFT_CCLEN      10 //!< Position of the calling code length in a calling code table entry.
+
+/**
+ * Calling code table indexed by the first three digits of an E.164 number.
+ * E.164 calling codes are prefix-free, so three digits always identify the code.
+ * Shared codes map to the main country: +1 is refined with e164_nanp_map and +7 with the Kazakhstan ranges.
+ * Unassigned and non-geographic codes are set to 0.
+ */
+static const uint16_t e164_cc_map[1000] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 000-009
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 010-019
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 020-029
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 030-039
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 040-049
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 050-059
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 060-069
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 070-079
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 080-089
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 090-099
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 100-109
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 110-119
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 120-129
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 130-139
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 140-149
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 150-159
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 160-169
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 170-179
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 180-189
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 190-199
+    E164CC('E', 'G', 2), E164CC('E', 'G', 2), E164CC('E', 'G', 2), E164CC('E', 'G', 2), E164CC('E', 'G', 2), E164CC('E', 'G', 2), E164CC('E', 'G', 2), E164CC('E', 'G', 2), E164CC('E', 'G', 2), E164CC('E', 'G', 2), // 200-209
+    0, E164CC('S', 'S', 3), E164CC('M', 'A', 3), E164CC('D', 'Z', 3), 0, 0, E164CC('T', 'N', 3), 0, E164CC('L', 'Y', 3), 0, // 210-219
+    E164CC('G', 'M', 3), E164CC('S', 'N', 3), E164CC('M', 'R', 3), E164CC('M', 'L', 3), E164CC('G', 'N', 3), E164CC('C', 'I', 3), E164CC('B', 'F', 3), E164CC('N', 'E', 3), E164CC('T', 'G', 3), E164CC('B', 'J', 3), // 220-229
+    E164CC('M', 'U', 3), E164CC('L', 'R', 3), E164CC('S', 'L', 3), E164CC('G', 'H', 3), E164CC('N', 'G', 3), E164CC('T', 'D', 3), E164CC('C', 'F', 3), E164CC('C', 'M', 3), E164CC('C', 'V', 3), E164CC('S', 'T', 3), // 230-239
+    E164CC('G', 'Q', 3), E164CC('G', 'A', 3), E164CC('C', 'G', 3), E164CC('C', 'D', 3), E164CC('A', 'O', 3), E164CC('G', 'W', 3), E164CC('I', 'O', 3), E164CC('S', 'H', 3), E164CC('S', 'C', 3), E164CC('S', 'D', 3), // 240-249
+    E164CC('R', 'W', 3), E164CC('E', 'T', 3), E164CC('S', 'O', 3), E164CC('D', 'J', 3), E164CC('K', 'E', 3), E164CC('T', 'Z', 3), E164CC('U', 'G', 3), E164CC('B', 'I', 3), E164CC('M', 'Z', 3), 0, // 250-259
+    E164CC('Z', 'M', 3), E164CC('M', 'G', 3), E164CC('R', 'E', 3), E164CC('Z', 'W', 3), E164CC('N', 'A', 3), E164CC('M', 'W', 3), E164CC('L', 'S', 3), E164CC('B', 'W', 3), E164CC('S', 'Z', 3), E164CC('K', 'M', 3), // 260-269
+    E164CC('Z', 'A', 2), E164CC('Z', 'A', 2), E164CC('Z', 'A', 2), E164CC('Z', 'A', 2), E164CC('Z', 'A', 2), E164CC('Z', 'A', 2), E164CC('Z', 'A', 2), E164CC('Z', 'A', 2), E164CC('Z', 'A', 2), E164CC('Z', 'A', 2), // 270-279
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 280-289
+    E164CC('S', 'H', 3), E164CC('E', 'R', 3), 0, 0, 0, 0, 0, E164CC('A', 'W', 3), E164CC('F', 'O', 3), E164CC('G', 'L', 3), // 290-299
+    E164CC('G', 'R', 2), E164CC('G', 'R', 2), E164CC('G', 'R', 2), E164CC('G', 'R', 2), E164CC('G', 'R', 2), E164CC('G', 'R', 2), E164CC('G', 'R', 2), E164CC('G', 'R', 2), E164CC('G', 'R', 2), E164CC('G', 'R', 2), // 300-309
+    E164CC('N', 'L', 2), E164CC('N', 'L', 2), E164CC('N', 'L', 2), E164CC('N', 'L', 2), E164CC('N', 'L', 2), E164CC('N', 'L', 2), E164CC('N', 'L', 2), E164CC('N', 'L', 2), E164CC('N', 'L', 2), E164CC('N', 'L', 2), // 310-319
+    E164CC('B', 'E', 2), E164CC('B', 'E', 2), E164CC('B', 'E', 2), E164CC('B', 'E', 2), E164CC('B', 'E', 2), E164CC('B', 'E', 2), E164CC('B', 'E', 2), E164CC('B', 'E', 2), E164CC('B', 'E', 2), E164CC('B', 'E', 2), // 320-329
+    E164CC('F', 'R', 2), E164CC('F', 'R', 2), E164CC('F', 'R', 2), E164CC('F', 'R', 2), E164CC('F', 'R', 2), E164CC('F', 'R', 2), E164CC('F', 'R', 2), E164CC('F', 'R', 2), E164CC('F', 'R', 2), E164CC('F', 'R', 2), // 330-339
+    E164CC('E', 'S', 2), E164CC('E', 'S', 2), E164CC('E', 'S', 2), E164CC('E', 'S', 2), E164CC('E', 'S', 2), E164CC('E', 'S', 2), E164CC('E', 'S', 2), E164CC('E', 'S', 2), E164CC('E', 'S', 2), E164CC('E', 'S', 2), // 340-349
+    E164CC('G', 'I', 3), E164CC('P', 'T', 3), E164CC('L', 'U', 3), E164CC('I', 'E', 3), E164CC('I', 'S', 3), E164CC('A', 'L', 3), E164CC('M', 'T', 3), E164CC('C', 'Y', 3), E164CC('F', 'I', 3), E164CC('B', 'G', 3), // 350-359
+    E164CC('H', 'U', 2), E164CC('H', 'U', 2), E164CC('H', 'U', 2), E164CC('H', 'U', 2), E164CC('H', 'U', 2), E164CC('H', 'U', 2), E164CC('H', 'U', 2), E164CC('H', 'U', 2), E164CC('H', 'U', 2), E164CC('H', 'U', 2), // 360-369
+    E164CC('L', 'T', 3), E164CC('L', 'V', 3), E164CC('E', 'E', 3), E164CC('M', 'D', 3), E164CC('A', 'M', 3), E164CC('B', 'Y', 3), E164CC('A', 'D', 3), E164CC('M', 'C', 3), E164CC('S', 'M', 3), E164CC('V', 'A', 3), // 370-379
+    E164CC('U', 'A', 3), E164CC('R', 'S', 3), E164CC('M', 'E', 3), E164CC('X', 'K', 3), 0, E164CC('H', 'R', 3), E164CC('S', 'I', 3), E164CC('B', 'A', 3), 0, E164CC('M', 'K', 3), // 380-389
+    E164CC('I', 'T', 2), E164CC('I', 'T', 2), E164CC('I', 'T', 2), E164CC('I', 'T', 2), E164CC('I', 'T', 2), E164CC('I', 'T', 2), E164CC('I', 'T', 2), E164CC('I', 'T', 2), E164CC('I', 'T', 2), E164CC('I', 'T', 2), // 390-399
+    E164CC('R', 'O', 2), E164CC('R', 'O', 2), E164CC('R', 'O', 2), E164CC('R', 'O', 2), E164CC('R', 'O', 2), E164CC('R', 'O', 2), E164CC('R', 'O', 2), E164CC('R', 'O', 2), E164CC('R', 'O', 2), E164CC('R', 'O', 2), // 400-409
+    E164CC('C', 'H', 2), E164CC('C', 'H', 2), E164CC('C', 'H', 2), E164CC('C', 'H', 2), E164CC('C', 'H', 2), E164CC('C', 'H', 2), E164CC('C', 'H', 2), E164CC('C', 'H', 2), E164CC('C', 'H', 2), E164CC('C', 'H', 2), // 410-419
+    E164CC('C', 'Z', 3), E164CC('S', 'K', 3), 0, E164CC('L', 'I', 3), 0, 0, 0, 0, 0, 0, // 420-429
+    E164CC('A', 'T', 2), E164CC('A', 'T', 2), E164CC('A', 'T', 2), E164CC('A', 'T', 2), E164CC('A', 'T', 2), E164CC('A', 'T', 2), E164CC('A', 'T', 2), E164CC('A', 'T', 2), E164CC('A', 'T', 2), E164CC('A', 'T', 2), // 430-439
+    E164CC('G', 'B', 2), E164CC('G', 'B', 2), E164CC('G', 'B', 2), E164CC('G', 'B', 2), E164CC('G', 'B', 2), E164CC('G', 'B', 2), E164CC('G', 'B', 2), E164CC('G', 'B', 2), E164CC('G', 'B', 2), E164CC('G', 'B', 2), // 440-449
+    E164CC('D', 'K', 2), E164CC('D', 'K', 2), E164CC('D', 'K', 2), E164CC('D', 'K', 2), E164CC('D', 'K', 2), E164CC('D', 'K', 2), E164CC('D', 'K', 2), E164CC('D', 'K', 2), E164CC('D', 'K', 2), E164CC('D', 'K', 2), // 450-459
+    E164CC('S', 'E', 2), E164CC('S', 'E', 2), E164CC('S', 'E', 2), E164CC('S', 'E', 2), E164CC('S', 'E', 2), E164CC('S', 'E', 2), E164CC('S', 'E', 2), E164CC('S', 'E', 2), E164CC('S', 'E', 2), E164CC('S', 'E', 2), // 460-469
+    E164CC('N', 'O', 2), E164CC('N', 'O', 2), E164CC('N', 'O', 2), E164CC('N', 'O', 2), E164CC('N', 'O', 2), E164CC('N', 'O', 2), E164CC('N', 'O', 2), E164CC('N', 'O', 2), E164CC('N', 'O', 2), E164CC('N', 'O', 2), // 470-479
+    E164CC('P', 'L', 2), E164CC('P', 'L', 2), E164CC('P', 'L', 2), E164CC('P', 'L', 2), E164CC('P', 'L', 2), E164CC('P', 'L', 2), E164CC('P', 'L', 2), E164CC('P', 'L', 2), E164CC('P', 'L', 2), E164CC('P', 'L', 2), // 480-489
+    E164CC('D', 'E', 2), E164CC('D', 'E', 2), E164CC('D', 'E', 2), E164CC('D', 'E', 2), E164CC('D', 'E', 2), E164CC('D', 'E', 2), E164CC('D', 'E', 2), E164CC('D', 'E', 2), E164CC('D', 'E', 2), E164CC('D', 'E', 2), // 490-499
+    E164CC('F', 'K', 3), E164CC('B', 'Z', 3), E164CC('G', 'T', 3), E164CC('S', 'V', 3), E164CC('H', 'N', 3), E164CC('N', 'I', 3), E164CC('C', 'R', 3), E164CC('P', 'A', 3), E164CC('P', 'M', 3), E164CC('H', 'T', 3), // 500-509
+    E164CC('P', 'E', 2), E164CC('P', 'E', 2), E164CC('P', 'E', 2), E164CC('P', 'E', 2), E164CC('P', 'E', 2), E164CC('P', 'E', 2), E164CC('P', 'E', 2), E164CC('P', 'E', 2), E164CC('P', 'E', 2), E164CC('P', 'E', 2), // 510-519
+    E164CC('M', 'X', 2), E164CC('M', 'X', 2), E164CC('M', 'X', 2), E164CC('M', 'X', 2), E164CC('M', 'X', 2), E164CC('M', 'X', 2), E164CC('M', 'X', 2), E164CC('M', 'X', 2), E164CC('M', 'X', 2), E164CC('M', 'X', 2), // 520-529
+    E164CC('C', 'U', 2), E164CC('C', 'U', 2), E164CC('C', 'U', 2), E164CC('C', 'U', 2), E164CC('C', 'U', 2), E164CC('C', 'U', 2), E164CC('C', 'U', 2), E164CC('C', 'U', 2), E164CC('C', 'U', 2), E164CC('C', 'U', 2), // 530-539
+    E164CC('A', 'R', 2), E164CC('A', 'R', 2), E164CC('A', 'R', 2), E164CC('A', 'R', 2), E164CC('A', 'R', 2), E164CC('A', 'R', 2), E164CC('A', 'R', 2), E164CC('A', 'R', 2), E164CC('A', 'R', 2), E164CC('A', 'R', 2), // 540-549
+    E164CC('B', 'R', 2), E164CC('B', 'R', 2), E164CC('B', 'R', 2), E164CC('B', 'R', 2), E164CC('B', 'R', 2), E164CC('B', 'R', 2), E164CC('B', 'R', 2), E164CC('B', 'R', 2), E164CC('B', 'R', 2), E164CC('B', 'R', 2), // 550-559
+    E164CC('C', 'L', 2), E164CC('C', 'L', 2), E164CC('C', 'L', 2), E164CC('C', 'L', 2), E164CC('C', 'L', 2), E164CC('C', 'L', 2), E164CC('C', 'L', 2), E164CC('C', 'L', 2), E164CC('C', 'L', 2), E164CC('C', 'L', 2), // 560-569
+    E164CC('C', 'O', 2), E164CC('C', 'O', 2), E164CC('C', 'O', 2), E164CC('C', 'O', 2), E164CC('C', 'O', 2), E164CC('C', 'O', 2), E164CC('C', 'O', 2), E164CC('C', 'O', 2), E164CC('C', 'O', 2), E164CC('C', 'O', 2), // 570-579
+    E164CC('V', 'E', 2), E164CC('V', 'E', 2), E164CC('V', 'E', 2), E164CC('V', 'E', 2), E164CC('V', 'E', 2), E164CC('V', 'E', 2), E164CC('V', 'E', 2), E164CC('V', 'E', 2), E164CC('V', 'E', 2), E164CC('V', 'E', 2), // 580-589
+    E164CC('G', 'P', 3), E164CC('B', 'O', 3), E164CC('G', 'Y', 3), E164CC('E', 'C', 3), E164CC('G', 'F', 3), E164CC('P', 'Y', 3), E164CC('M', 'Q', 3), E164CC('S', 'R', 3), E164CC('U', 'Y', 3), E164CC('C', 'W', 3), // 590-599
+    E164CC('M', 'Y', 2), E164CC('M', 'Y', 2), E164CC('M', 'Y', 2), E164CC('M', 'Y', 2), E164CC('M', 'Y', 2), E164CC('M', 'Y', 2), E164CC('M', 'Y', 2), E164CC('M', 'Y', 2), E164CC('M', 'Y', 2), E164CC('M', 'Y', 2), // 600-609
+    E164CC('A', 'U', 2), E164CC('A', 'U', 2), E164CC('A', 'U', 2), E164CC('A', 'U', 2), E164CC('A', 'U', 2), E164CC('A', 'U', 2), E164CC('A', 'U', 2), E164CC('A', 'U', 2), E164CC('A', 'U', 2), E164CC('A', 'U', 2), // 610-619
+    E164CC('I', 'D', 2), E164CC('I', 'D', 2), E164CC('I', 'D', 2), E164CC('I', 'D', 2), E164CC('I', 'D', 2), E164CC('I', 'D', 2), E164CC('I', 'D', 2), E164CC('I', 'D', 2), E164CC('I', 'D', 2), E164CC('I', 'D', 2), // 620-629
+    E164CC('P', 'H', 2), E164CC('P', 'H', 2), E164CC('P', 'H', 2), E164CC('P', 'H', 2), E164CC('P', 'H', 2), E164CC('P', 'H', 2), E164CC('P', 'H', 2), E164CC('P', 'H', 2), E164CC('P', 'H', 2), E164CC('P', 'H', 2), // 630-639
+    E164CC('N', 'Z', 2), E164CC('N', 'Z', 2), E164CC('N', 'Z', 2), E164CC('N', 'Z', 2), E164CC('N', 'Z', 2), E164CC('N', 'Z', 2), E164CC('N', 'Z', 2), E164CC('N', 'Z', 2), E164CC('N', 'Z', 2), E164CC('N', 'Z', 2), // 640-649
+    E164CC('S', 'G', 2), E164CC('S', 'G', 2), E164CC('S', 'G', 2), E164CC('S', 'G', 2), E164CC('S', 'G', 2), E164CC('S', 'G', 2), E164CC('S', 'G', 2), E164CC('S', 'G', 2), E164CC('S', 'G', 2), E164CC('S', 'G', 2), // 650-659
+    E164CC('T', 'H', 2), E164CC('T', 'H', 2), E164CC('T', 'H', 2), E164CC('T', 'H', 2), E164CC('T', 'H', 2), E164CC('T', 'H', 2), E164CC('T', 'H', 2), E164CC('T', 'H', 2), E164CC('T', 'H', 2), E164CC('T', 'H', 2), // 660-669
+    E164CC('T', 'L', 3), 0, E164CC('N', 'F', 3), E164CC('B', 'N', 3), E164CC('N', 'R', 3), E164CC('P', 'G', 3), E164CC('T', 'O', 3), E164CC('S', 'B', 3), E164CC('V', 'U', 3), E164CC('F', 'J', 3), // 670-679
+    E164CC('P', 'W', 3), E164CC('W', 'F', 3), E164CC('C', 'K', 3), E164CC('N', 'U', 3), 0, E164CC('W', 'S', 3), E164CC('K', 'I', 3), E164CC('N', 'C', 3), E164CC('T', 'V', 3), E164CC('P', 'F', 3), // 680-689
+    E164CC('T', 'K', 3), E164CC('F', 'M', 3), E164CC('M', 'H', 3), 0, 0, 0, 0, 0, 0, 0, // 690-699
+    E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), // 700-709
+    E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), // 710-719
+    E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), // 720-729
+    E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), // 730-739
+    E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), // 740-749
+    E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), // 750-759
+    E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), // 760-769
+    E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), // 770-779
+    E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), // 780-789
+    E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), E164CC('R', 'U', 1), // 790-799
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 800-809
+    E164CC('J', 'P', 2), E164CC('J', 'P', 2), E164CC('J', 'P', 2), E164CC('J', 'P', 2), E164CC('J', 'P', 2), E164CC('J', 'P', 2), E164CC('J', 'P', 2), E164CC('J', 'P', 2), E164CC('J', 'P', 2), E164CC('J', 'P', 2), // 810-819
+    E164CC('K', 'R', 2), E164CC('K', 'R', 2), E164CC('K', 'R', 2), E164CC('K', 'R', 2), E164CC('K', 'R', 2), E164CC('K', 'R', 2), E164CC('K', 'R', 2), E164CC('K', 'R', 2), E164CC('K', 'R', 2), E164CC('K', 'R', 2), // 820-829
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 830-839
+    E164CC('V', 'N', 2), E164CC('V', 'N', 2), E164CC('V', 'N', 2), E164CC('V', 'N', 2), E164CC('V', 'N', 2), E164CC('V', 'N', 2), E164CC('V', 'N', 2), E164CC('V', 'N', 2), E164CC('V', 'N', 2), E164CC('V', 'N', 2), // 840-849
+    E164CC('K', 'P', 3), 0, E164CC('H', 'K', 3), E164CC('M', 'O', 3), 0, E164CC('K', 'H', 3), E164CC('L', 'A', 3), 0, 0, 0, // 850-859
+    E164CC('C', 'N', 2), E164CC('C', 'N', 2), E164CC('C', 'N', 2), E164CC('C', 'N', 2), E164CC('C', 'N', 2), E164CC('C', 'N', 2), E164CC('C', 'N', 2), E164CC('C', 'N', 2), E164CC('C', 'N', 2), E164CC('C', 'N', 2), // 860-869
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 870-879
+    E164CC('B', 'D', 3), 0, 0, 0, 0, 0, E164CC('T', 'W', 3), 0, 0, 0, // 880-889
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 890-899
+    E164CC('T', 'R', 2), E164CC('T', 'R', 2), E164CC('T', 'R', 2), E164CC('T', 'R', 2), E164CC('T', 'R', 2), E164CC('T', 'R', 2), E164CC('T', 'R', 2), E164CC('T', 'R', 2), E164CC('T', 'R', 2), E164CC('T', 'R', 2), // 900-909
+    E164CC('I', 'N', 2), E164CC('I', 'N', 2), E164CC('I', 'N', 2), E164CC('I', 'N', 2), E164CC('I', 'N', 2), E164CC('I', 'N', 2), E164CC('I', 'N', 2), E164CC('I', 'N', 2), E164CC('I', 'N', 2), E164CC('I', 'N', 2), // 910-919
+    E164CC('P', 'K', 2), E164CC('P', 'K', 2), E164CC('P', 'K', 2), E164CC('P', 'K', 2), E164CC('P', 'K', 2), E164CC('P', 'K', 2), E164CC('P', 'K', 2), E164CC('P', 'K', 2), E164CC('P', 'K', 2), E164CC('P', 'K', 2), // 920-929
+    E164CC('A', 'F', 2), E164CC('A', 'F', 2), E164CC('A', 'F', 2), E164CC('A', 'F', 2), E164CC('A', 'F', 2), E164CC('A', 'F', 2), E164CC('A', 'F', 2), E164CC('A', 'F', 2), E164CC('A', 'F', 2), E164CC('A', 'F', 2), // 930-939
+    E164CC('L', 'K', 2), E164CC('L', 'K', 2), E164CC('L', 'K', 2), E164CC('L', 'K', 2), E164CC('L', 'K', 2), E164CC('L', 'K', 2), E164CC('L', 'K', 2), E164CC('L', 'K', 2), E164CC('L', 'K', 2), E164CC('L', 'K', 2), // 940-949
+    E164CC('M', 'M', 2), E164CC('M', 'M', 2), E164CC('M', 'M', 2), E164CC('M', 'M', 2), E164CC('M', 'M', 2), E164CC('M', 'M', 2), E164CC('M', 'M', 2), E164CC('M', 'M', 2), E164CC('M', 'M', 2), E164CC('M', 'M', 2), // 950-959
+    E164CC('M', 'V', 3), E164CC('L', 'B', 3), E164CC('J', 'O', 3), E164CC('S', 'Y', 3), E164CC('I', 'Q', 3), E164CC('K', 'W', 3), E164CC('S', 'A', 3), E164CC('Y', 'E', 3), E164CC('O', 'M', 3), 0, // 960-969
+    E164CC('P', 'S', 3), E164CC('A', 'E', 3), E164CC('I', 'L', 3), E164CC('B', 'H', 3), E164CC('Q', 'A', 3), E164CC('B', 'T', 3), E164CC('M', 'N', 3), E164CC('N', 'P', 3), 0, 0, // 970-979
+    E164CC('I', 'R', 2), E164CC('I', 'R', 2), E164CC('I', 'R', 2), E164CC('I', 'R', 2), E164CC('I', 'R', 2), E164CC('I', 'R', 2), E164CC('I', 'R', 2), E164CC('I', 'R', 2), E164CC('I', 'R', 2), E164CC('I', 'R', 2), // 980-989
+    0, 0, E164CC('T', 'J', 3), E164CC('T', 'M', 3), E164CC('A', 'Z', 3), E164CC('G', 'E', 3), E164CC('K', 'G', 3), 0, E164CC('U', 'Z', 3), 0, // 990-999
+};
+
+/**
+ * North American Numbering Plan (+1) table indexed by the three-digit area code.
+ * Area codes not assigned to other NANP countries map to US.
+ */
+static const uint16_t e164_nanp_map[1000] =
+{
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 000-009
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 010-019
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 020-029
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 030-039
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 040-049
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 050-059
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 060-069
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 070-079
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 080-089
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 090-099
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 100-109
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 110-119
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 120-129
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 130-139
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 140-149
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 150-159
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 160-169
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 170-179
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 180-189
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 190-199
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 200-209
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 210-219
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 220-229
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 230-239
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('B', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('B', 'B', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), // 240-249
+    E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 250-259
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('A', 'I', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('A', 'G', 1), E164CC('U', 'S', 1), // 260-269
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 270-279
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('V', 'G', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), // 280-289
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 290-299
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 300-309
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 310-319
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 320-329
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 330-339
+    E164CC('V', 'I', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('K', 'Y', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 340-349
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 350-359
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), // 360-369
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 370-379
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 380-389
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 390-399
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 400-409
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), // 410-419
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), // 420-429
+    E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), // 430-439
+    E164CC('U', 'S', 1), E164CC('B', 'M', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 440-449
+    E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 450-459
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), // 460-469
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('G', 'D', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 470-479
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 480-489
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 490-499
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 500-509
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), // 510-519
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 520-529
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 530-539
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), // 540-549
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 550-559
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 560-569
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), // 570-579
+    E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 580-589
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 590-599
+    E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 600-609
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 610-619
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 620-629
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), // 630-639
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('T', 'C', 1), // 640-649
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('J', 'M', 1), E164CC('U', 'S', 1), // 650-659
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('M', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 660-669
+    E164CC('M', 'P', 1), E164CC('G', 'U', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 670-679
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('A', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 680-689
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 690-699
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), // 700-709
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 710-719
+    E164CC('U', 'S', 1), E164CC('S', 'X', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 720-729
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 730-739
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 740-749
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('L', 'C', 1), E164CC('U', 'S', 1), // 750-759
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('D', 'M', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 760-769
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), // 770-779
+    E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('V', 'C', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('P', 'R', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 780-789
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 790-799
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('D', 'O', 1), // 800-809
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), // 810-819
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('D', 'O', 1), // 820-829
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 830-839
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('D', 'O', 1), // 840-849
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 850-859
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('T', 'T', 1), E164CC('K', 'N', 1), // 860-869
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('J', 'M', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), // 870-879
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 880-889
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 890-899
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 900-909
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 910-919
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 920-929
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('P', 'R', 1), // 930-939
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('C', 'A', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 940-949
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 950-959
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 960-969
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 970-979
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 980-989
+    E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), E164CC('U', 'S', 1), // 990-999
+};
+
+
+/**
+ * Returns 1 if the character is a formatting character that can be ignored (space, dash, dot, slash and parentheses).
+ *
+ * @param c Character to check.
+ */
+static inline int e164_format_char(char c)
+{
+    return ((c == ' ') || (c == '-') || (c == '.') || (c == '/') || (c == '(') || (c == ')'));
+}
+
+/**
+ * Returns the position of the first significant character of a formatted number,
+ * skipping leading formatting characters and the international prefix ("+" or "00").
+ *
+ * @param number String containing the formatted number.
+ * @param size   Length of the string.
+ *
+ * @return Position of the first significant character.
+ */
+static inline size_t e164_start(const char *number, size_t size)
+{
+    size_t pos = 0;
+    while ((pos < size) && (number[pos] != '(') && e164_format_char(number[pos])) // "(0)" is handled by e164_next_digit()
+    {
+        pos++;
+    }
+    if ((pos < size) && (number[pos] == '+'))
+    {
+        return (pos + 1);
+    }
+    if (((pos + 1) < size) && (number[pos] == '0') && (number[pos + 1] == '0'))
+    {
+        return (pos + 2);
+    }
+    return pos;
+}
+
+/**
+ * Returns the value of the next significant digit of a formatted number and advances the position.
+ * Formatting characters and the "(0)" national trunk prefix are skipped.
+ * The scan stops at the end of the string or at the first character that is neither a digit nor a formatting character.
+ *
+ * @param number String containing the formatted number.
+ * @param size   Length of the string.
+ * @param pos    Pointer to the current position (initialize it with e164_start()), updated to the position after the digit.
+ *
+ * @return Digit value (0 to 9), or -1 when there are no more digits.
+ */
+static inline int e164_next_digit(const char *number, size_t size, size_t *pos)
+{
+    uint8_t b = 0;
+    while (*pos < size)
+    {
+        b = (uint8_t)((uint8_t)number[*pos] - '0');
+        (*pos)++;
+        if (b <= 9)
+        {
+            return (int)b;
+        }
+        if ((number[*pos - 1] == '(') && ((*pos + 1) < size) && (number[*pos] == '0') && (number[*pos + 1] == ')'))
+        {
+            *pos += 2; // skip "(0)"
+            continue;
+        }
+        if (!e164_format_char(number[*pos - 1]))
+        {
+            *pos = size;
+            break;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Returns the calling code table entry of an E.164 number (digits only, without the international prefix).
+ * This is a constant-time lookup on the first 3 digits (4 for the NANP area codes) without heap usage.
+ *
+ * @param number String containing the E.164 number digits.
+ * @param size   Length of the number (number of digits).
+ *
+ * @return Calling code table entry (see E164CC), or 0 if the calling code is incomplete or not assigned to a country.
+ */
+static inline uint16_t e164_lookup(const char *number, size_t size)
+{
+    uint8_t d[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (i = 0; (i < 4) && (i < size); i++)
+    {
+        d[i] = (uint8_t)((uint8_t)number[i] - '0');
+        if (d[i] > 9)
+        {
+            return 0;
+        }
+    }
+    if (size == 0)
+    {
+        return 0;
+    }
+    if (d[0] == 1)
+    {
+        if (size < 4)
+        {
+            return 0; // truncated NANP area code
+        }
+        return e164_nanp_map[((d[1] * 100) + (d[2] * 10) + d[3])];
+    }
+    if ((d[0] == 7) && ((d[1] == 6) || (d[1] == 7)))
+    {
+        return E164CC('K', 'Z', 1);
+    }
+    uint16_t e = e164_cc_map[((d[0] * 100) + (d[1] * 10) + d[2])];
+    if ((size_t)(e >> E164BSHIFT_CCLEN) > size)
+    {
+        return 0; // truncated calling code
+    }
+    return e;
+}
+
+/**
+ * Resolves the ISO 3166 alpha-2 country code of an E.164 number from its calling code.
+ *
+ * @param number  String containing the E.164 number digits (without the international prefix).
+ * @param size    Length of the number (number of digits).
+ * @param country Pre-allocated string buffer to be returned (it must be at least three bytes). Set to "" if not found.
+ *
+ * @return Number of digits of the calling code, or 0 if the calling code is not assigned to a country.
+ */
+static inline size_t e164_country(const char *number, size_t size, char *country)
+{
+    uint16_t e = e164_lookup(number, size);
+    if (e == 0)
+    {
+        country[0] = 0;
+        return 0;
+    }
+    country[0] = (char)(((e >> 5) & 0x1F) + 64);
+    country[1] = (char)((e & 0x1F) + 64);
+    country[2] = 0;
+    return (size_t)(e >> E164BSHIFT_CCLEN);
+}
+
+#endif  // NUMKEY_E164_H
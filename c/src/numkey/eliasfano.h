@@ -0,0 +1,355 @@
+// NumKey
+//
+// eliasfano.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file eliasfano.h
+ * @brief Partitioned Elias-Fano encoded sorted NumKey column.
+ *
+ * The functions provided here allows to store a sorted (non-decreasing) column of NumKey codes
+ * (e.g. the output of sort_uint64_t and unique_uint64_t) with the partitioned Elias-Fano encoding.
+ *
+ * The keys are split in partitions of NKEF_PARTITION keys and each partition is encoded with Elias-Fano
+ * relative to its first key: with N keys spanning U values, each key is split in its l = log2(U/N) lowest bits,
+ * packed in the lower array, and the remaining high bits, stored in the upper bit array as the position
+ * of the i-th set bit (high + i), so each key takes about 2 + log2(U/N) bits.
+ * Partitioning adapts the encoding to the local density of the keys: the NumKey codes are clustered
+ * by country and length, so a single Elias-Fano sequence over the whole column would waste bits
+ * and concentrate most keys in a few huge high-bits buckets.
+ * The lowest bits are chosen so that (range >> l) < 2 * NKEF_PARTITION, so the upper array of a partition
+ * is at most 256 + 511 + 1 = 768 bits (12 words) long, and access(i) and next_geq(key) scan at most 12 words
+ * after a binary search on the partition skip index.
+ *
+ * The column is serialized as a single blob of uint64_t words that can be memory-mapped
+ * (e.g. with mmap_binfile) and used directly with eliasfano_load, without any parsing or allocation:
+ *
+ *   - header (NKEF_HEADER_WORDS): magic "NKEF1", nkeys, nparts, nwords;
+ *   - skip index (nparts): first key of each partition;
+ *   - partition info (2 * nparts): offset of the partition data in words (<< 8) | l, last key of the partition;
+ *   - data (nwords + NKBITPACK_PADWORDS): lower array and upper array of each partition.
+ */
+
+#ifndef NUMKEY_ELIASFANO_H
+#define NUMKEY_ELIASFANO_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "bitpack.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#define NKEF_MAGIC        0x0000003146454b4e //!< Magic number "NKEF1" in LE.
+#define NKEF_HEADER_WORDS 4                  //!< Number of uint64_t words in the header.
+#define NKEF_PARTITION    256                //!< Number of keys per partition.
+#define NKEF_LBITSMASK    0xFF               //!< Bit mask for the number of low bits in the partition info.
+#define NKEF_OFFSETSHIFT  8                  //!< Position of the data offset in the partition info.
+
+/**
+ * Read-only view of a serialized Elias-Fano column.
+ */
+typedef struct eliasfano_t
+{
+    const uint64_t *base; //!< First key of each partition (skip index).
+    const uint64_t *info; //!< Data offset and number of low bits, last key (2 words per partition).
+    const uint64_t *data; //!< Lower and upper arrays of the partitions.
+    uint64_t nkeys;       //!< Number of keys.
+    uint64_t nparts;      //!< Number of partitions.
+    uint64_t nwords;      //!< Number of data words (excluding the padding).
+} eliasfano_t;
+
+/**
+ * Decoded parameters of a partition.
+ */
+typedef struct eliasfano_part_t
+{
+    const uint64_t *lower; //!< Packed low bits of the keys.
+    const uint64_t *upper; //!< Unary-coded high bits of the keys.
+    uint64_t base;         //!< First key of the partition.
+    uint64_t last;         //!< Last key of the partition.
+    uint64_t lmask;        //!< Bit mask of the low bits.
+    uint64_t nkeys;        //!< Number of keys in the partition.
+    uint8_t lbits;         //!< Number of low bits per key.
+} eliasfano_part_t;
+
+/**
+ * Returns the number of bits set in a 64 bit word.
+ */
+static inline uint64_t eliasfano_popcount(uint64_t v)
+{
+#if defined(__GNUC__)
+    return (uint64_t)__builtin_popcountll(v);
+#else
+    v = v - ((v >> 1) & 0x5555555555555555);
+    v = (v & 0x3333333333333333) + ((v >> 2) & 0x3333333333333333);
+    v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0f;
+    return ((v * 0x0101010101010101) >> 56);
+#endif
+}
+
+/**
+ * Returns the position of the k-th set bit (starting from 0) of a word (the word must contain at least k + 1 set bits).
+ */
+static inline uint64_t eliasfano_select_word(uint64_t v, uint64_t k)
+{
+#if defined(__BMI2__)
+    return (uint64_t)__builtin_ctzll(_pdep_u64(((uint64_t)1 << k), v)); // tzcnt would also require BMI1
+#else
+    for (; k > 0; k--)
+    {
+        v &= (v - 1);
+    }
+#if defined(__GNUC__)
+    return (uint64_t)__builtin_ctzll(v);
+#else
+    uint64_t i = 0;
+    while (!(v & 1))
+    {
+        v >>= 1;
+        i++;
+    }
+    return i;
+#endif
+#endif
+}
+
+/**
+ * Returns the position of the k-th set bit (flip = 0) or zero bit (flip = ~0) of an upper array.
+ */
+static inline uint64_t eliasfano_select(const uint64_t *upper, uint64_t k, uint64_t flip)
+{
+    uint64_t w = 0, v = 0, c = 0;
+    while (k >= (c = eliasfano_popcount(v = (upper[w] ^ flip))))
+    {
+        k -= c;
+        w++;
+    }
+    return ((w << 6) + eliasfano_select_word(v, k));
+}
+
+/**
+ * Returns the number of low bits used to encode n keys spanning the specified range of values.
+ */
+static inline uint8_t eliasfano_lbits(uint64_t range, uint64_t n)
+{
+    uint8_t lbits = 0;
+    while ((lbits < 63) && ((range >> (lbits + 1)) >= n)) // l = floor(log2(U / N))
+    {
+        lbits++;
+    }
+    return lbits;
+}
+
+/**
+ * Initialize an Elias-Fano view from a serialized blob (e.g. a memory-mapped file).
+ * The blob is not copied and it must be kept valid while the view is used.
+ *
+ * @param src  Address of the serialized blob (8-byte aligned).
+ * @param size Size of the blob in bytes.
+ * @param ef   View to initialize.
+ *
+ * @return False if the blob is not a valid serialized Elias-Fano column, true otherwise.
+ */
+static inline bool eliasfano_load(const uint8_t *src, uint64_t size, eliasfano_t *ef)
+{
+    const uint64_t *p = (const uint64_t *)src;
+    if ((size < (NKEF_HEADER_WORDS * sizeof(uint64_t))) || (p[0] != NKEF_MAGIC))
+    {
+        return false;
+    }
+    ef->nkeys = p[1];
+    ef->nparts = p[2];
+    ef->nwords = p[3];
+    if (((size / sizeof(uint64_t)) < (NKEF_HEADER_WORDS + (3 * ef->nparts) + ef->nwords + NKBITPACK_PADWORDS))
+            || (ef->nparts != ((ef->nkeys + NKEF_PARTITION - 1) / NKEF_PARTITION)))
+    {
+        return false;
+    }
+    p += NKEF_HEADER_WORDS;
+    ef->base = p;
+    p += ef->nparts;
+    ef->info = p;
+    p += (2 * ef->nparts);
+    ef->data = p;
+    return true;
+}
+
+/**
+ * Decode the parameters of a partition.
+ */
+static inline void eliasfano_part(const eliasfano_t *ef, uint64_t part, eliasfano_part_t *ep)
+{
+    uint64_t info = ef->info[(2 * part)];
+    uint64_t end = ((part + 1) * NKEF_PARTITION);
+    ep->nkeys = (((end < ef->nkeys) ? end : ef->nkeys) - (part * NKEF_PARTITION));
+    ep->base = ef->base[part];
+    ep->last = ef->info[((2 * part) + 1)];
+    ep->lbits = (uint8_t)(info & NKEF_LBITSMASK);
+    ep->lmask = bitpack_mask(ep->lbits);
+    ep->lower = (ef->data + (info >> NKEF_OFFSETSHIFT));
+    ep->upper = (ep->lower + (((ep->nkeys * ep->lbits) + 63) >> 6));
+}
+
+/**
+ * Returns the key at the specified position.
+ *
+ * @param ef Elias-Fano view.
+ * @param i  Key position (it must be less than nkeys).
+ *
+ * @return Key value.
+ */
+static inline uint64_t eliasfano_access(const eliasfano_t *ef, uint64_t i)
+{
+    eliasfano_part_t ep;
+    eliasfano_part(ef, (i / NKEF_PARTITION), &ep);
+    uint64_t j = (i % NKEF_PARTITION);
+    uint64_t high = (eliasfano_select(ep.upper, j, 0) - j);
+    return (ep.base + ((high << ep.lbits) | bitpack_read(ep.lower, (j * ep.lbits), ep.lmask)));
+}
+
+/**
+ * Returns the position of the first key greater or equal than the search key.
+ * This replaces col_find_first_uint64_t on the compressed column: the key is found if the returned position
+ * is less than nkeys and eliasfano_access returns the search key at that position.
+ *
+ * @param ef     Elias-Fano view.
+ * @param search Key to search.
+ *
+ * @return Position of the first key greater or equal than the search key, or nkeys if all the keys are smaller.
+ */
+static inline uint64_t eliasfano_next_geq(const eliasfano_t *ef, uint64_t search)
+{
+    uint64_t first = 0, last = ef->nparts, middle = 0;
+    while (first < last)
+    {
+        middle = get_middle_point(first, last);
+        if (ef->base[middle] < search)
+        {
+            first = (middle + 1);
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    // first is the number of partitions starting with a key smaller than the search key
+    if (first == 0)
+    {
+        return 0;
+    }
+    const uint64_t part = (first - 1);
+    eliasfano_part_t ep;
+    eliasfano_part(ef, part, &ep);
+    if (search > ep.last)
+    {
+        return ((part * NKEF_PARTITION) + ep.nkeys); // the first key of the next partition
+    }
+    const uint64_t d = (search - ep.base);
+    const uint64_t h = (d >> ep.lbits);
+    const uint64_t low = (d & ep.lmask);
+    // the h-th zero bit ends the bucket of the keys with high bits smaller than h
+    uint64_t pos = (h == 0) ? 0 : (eliasfano_select(ep.upper, (h - 1), ~(uint64_t)0) + 1);
+    uint64_t j = (pos - h); // number of keys with high bits smaller than h
+    while ((ep.upper[(pos >> 6)] >> (pos & 63)) & 1)
+    {
+        if (bitpack_read(ep.lower, (j * ep.lbits), ep.lmask) >= low)
+        {
+            break;
+        }
+        j++;
+        pos++;
+    }
+    return ((part * NKEF_PARTITION) + j); // the bucket can only end with a zero bit because search <= last
+}
+
+/**
+ * Returns the number of keys smaller than the search key.
+ *
+ * @param ef     Elias-Fano view.
+ * @param search Key to search.
+ *
+ * @return Number of keys smaller than the search key.
+ */
+static inline uint64_t eliasfano_rank(const eliasfano_t *ef, uint64_t search)
+{
+    return eliasfano_next_geq(ef, search);
+}
+
+/**
+ * Encode a sorted array of keys and serialize it.
+ *
+ * @param keys  Sorted array of keys (e.g. processed with sort_uint64_t and unique_uint64_t).
+ * @param nkeys Number of keys.
+ * @param size  Pointer to the size in bytes of the returned blob.
+ *
+ * @return Serialized blob allocated with malloc (to be freed by the caller), or NULL in case of memory allocation failure.
+ */
+static inline uint8_t *eliasfano_build(const uint64_t *keys, uint64_t nkeys, uint64_t *size)
+{
+    uint64_t nparts = ((nkeys + NKEF_PARTITION - 1) / NKEF_PARTITION);
+    uint64_t nwords = 0, part = 0, start = 0, n = 0, range = 0, i = 0, pos = 0, v = 0;
+    uint8_t lbits = 0;
+    for (part = 0; part < nparts; part++)
+    {
+        start = (part * NKEF_PARTITION);
+        n = ((start + NKEF_PARTITION) < nkeys) ? NKEF_PARTITION : (nkeys - start);
+        range = (keys[(start + n - 1)] - keys[start]);
+        lbits = eliasfano_lbits(range, n);
+        nwords += (((n * lbits) + 63) >> 6) + ((n + (range >> lbits) + 1 + 63) >> 6);
+    }
+    *size = ((NKEF_HEADER_WORDS + (3 * nparts) + nwords + NKBITPACK_PADWORDS) * sizeof(uint64_t));
+    uint8_t *blob = (uint8_t *)calloc(*size, 1);
+    if (blob == NULL)
+    {
+        return NULL;
+    }
+    uint64_t *p = (uint64_t *)blob;
+    p[0] = NKEF_MAGIC;
+    p[1] = nkeys;
+    p[2] = nparts;
+    p[3] = nwords;
+    uint64_t *base = (p + NKEF_HEADER_WORDS);
+    uint64_t *info = (base + nparts);
+    uint64_t *lower = (info + (2 * nparts));
+    uint64_t *upper = NULL;
+    uint64_t lmask = 0;
+    for (part = 0; part < nparts; part++)
+    {
+        start = (part * NKEF_PARTITION);
+        n = ((start + NKEF_PARTITION) < nkeys) ? NKEF_PARTITION : (nkeys - start);
+        range = (keys[(start + n - 1)] - keys[start]);
+        lbits = eliasfano_lbits(range, n);
+        lmask = bitpack_mask(lbits);
+        base[part] = keys[start];
+        info[(2 * part)] = (((uint64_t)(lower - (info + (2 * nparts))) << NKEF_OFFSETSHIFT) | lbits);
+        info[((2 * part) + 1)] = keys[(start + n - 1)];
+        upper = (lower + (((n * lbits) + 63) >> 6));
+        for (i = 0; i < n; i++)
+        {
+            v = (keys[(start + i)] - keys[start]);
+            pos = (i * lbits);
+            if (lbits > 0)
+            {
+                lower[(pos >> 6)] |= ((v & lmask) << (pos & 63));
+                if (((pos & 63) + lbits) > 64)
+                {
+                    lower[((pos >> 6) + 1)] |= ((v & lmask) >> (64 - (pos & 63)));
+                }
+            }
+            pos = ((v >> lbits) + i);
+            upper[(pos >> 6)] |= ((uint64_t)1 << (pos & 63));
+        }
+        lower = (upper + ((n + (range >> lbits) + 1 + 63) >> 6));
+    }
+    return blob;
+}
+
+#endif  // NUMKEY_ELIASFANO_H
@@ -0,0 +1,219 @@
+// NumKey
+//
+// eytzinger.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file eytzinger.h
+ * @brief Eytzinger (BFS-order) layout for sorted binsearch columns.
+ *
+ * The functions provided here allows to convert a sorted column of unsigned integers
+ * (in row mode via blklen/blkpos, or in column mode) into a copy stored in Eytzinger order:
+ * the implicit binary search tree of the sorted values stored level by level, like a binary heap.
+ * The top levels of the tree are packed in the first cache lines, and all the descendants
+ * of a node a few levels below are adjacent, so the search can be branchless and can prefetch
+ * the next levels while comparing the current one.
+ *
+ * The Eytzinger column has exactly the same number of items of the source column (nrows),
+ * so it can be kept in memory or persisted as an extra column of a binsearch file
+ * (e.g. a "BINSRC1" file) and used directly from the memory map.
+ * The search functions return the original (sorted) row index, so the result can be used
+ * to access the other columns of the same row, as with col_find_first_T.
+ *
+ * Node k (1-based) is stored at position (k - 1), and its children are the nodes 2k and 2k + 1.
+ * The rank of a node in the sorted order is computed arithmetically (see eytzinger_rank),
+ * so no extra index column is required.
+ */
+
+#ifndef NUMKEY_EYTZINGER_H
+#define NUMKEY_EYTZINGER_H
+
+#include <inttypes.h>
+#include "binsearch.h"
+
+#define EYTZINGER_CACHELINE 64 //!< Size in bytes of a cache line, used to compute the prefetch distance.
+
+/**
+ * Returns the position of the most significant bit set (floor(log2(x))), with x > 0.
+ */
+static inline uint8_t eytzinger_log2(uint64_t x)
+{
+#if defined(__GNUC__)
+    return (uint8_t)(63 - __builtin_clzll(x));
+#else
+    uint8_t r = 0;
+    while (x >>= 1)
+    {
+        r++;
+    }
+    return r;
+#endif
+}
+
+/**
+ * Returns the number of trailing bits set.
+ */
+static inline uint8_t eytzinger_trailing_ones(uint64_t x)
+{
+#if defined(__GNUC__)
+    return (uint8_t)((~x == 0) ? 64 : __builtin_ctzll(~x));
+#else
+    uint8_t r = 0;
+    while (x & 1)
+    {
+        x >>= 1;
+        r++;
+    }
+    return r;
+#endif
+}
+
+/**
+ * Returns the rank (position in the sorted order) of an Eytzinger node.
+ * The tree of nrows nodes is complete: the missing nodes are the rightmost ones of the last level.
+ * The rank is first computed as in a perfect tree of the same height,
+ * then decreased by the number of missing leaves preceding the node in the sorted order.
+ *
+ * @param k     Eytzinger node (1-based, 1 <= k <= nrows).
+ * @param nrows Number of items.
+ *
+ * @return Rank of the node (0-based).
+ */
+static inline uint64_t eytzinger_rank(uint64_t k, uint64_t nrows)
+{
+    const uint8_t height = eytzinger_log2(nrows);
+    const uint8_t depth = eytzinger_log2(k);
+    const uint64_t rank = ((((2 * (k - ((uint64_t)1 << depth))) + 1) << (height - depth)) - 1);
+    const uint64_t leaves = (nrows - (((uint64_t)1 << height) - 1)); // nodes in the last level
+    const uint64_t before = ((rank + 1) >> 1);                      // leaves of the perfect tree preceding the node
+    return (rank - ((before > leaves) ? (before - leaves) : 0));
+}
+
+/**
+ * Generic function to build the Eytzinger layout of a sorted column of a memory mapped
+ * binary file containing adjacent blocks of sorted binary data.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_eytzinger_build(O, T) \
+/** Build the Eytzinger layout of a sorted column of a memory mapped binary file
+containing adjacent blocks of sorted binary data.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number inside a binary block.
+@param nrows     Number of rows.
+@param dst       Output array of nrows items in Eytzinger order (native byte order).
+ */ \
+static inline void eytzinger_build_##O##_##T(const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t nrows, T *dst) \
+{ \
+    uint64_t k; \
+    for (k = 1; k <= nrows; k++) \
+    { \
+        dst[(k - 1)] = bytes_##O##_to_##T(src, get_address(blklen, blkpos, eytzinger_rank(k, nrows))); \
+    } \
+}
+
+define_eytzinger_build(be, uint8_t)
+define_eytzinger_build(be, uint16_t)
+define_eytzinger_build(be, uint32_t)
+define_eytzinger_build(be, uint64_t)
+define_eytzinger_build(le, uint8_t)
+define_eytzinger_build(le, uint16_t)
+define_eytzinger_build(le, uint32_t)
+define_eytzinger_build(le, uint64_t)
+
+/**
+ * Generic function to build the Eytzinger layout of a sorted column
+ * of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_eytzinger_col_build(T) \
+/** Build the Eytzinger layout of a sorted column of unsigned integers of the same type.
+@param src       Sorted column address.
+@param nrows     Number of rows.
+@param dst       Output array of nrows items in Eytzinger order.
+ */ \
+static inline void eytzinger_col_build_##T(const T *src, uint64_t nrows, T *dst) \
+{ \
+    uint64_t k; \
+    for (k = 1; k <= nrows; k++) \
+    { \
+        dst[(k - 1)] = src[eytzinger_rank(k, nrows)]; \
+    } \
+}
+
+define_eytzinger_col_build(uint8_t)
+define_eytzinger_col_build(uint16_t)
+define_eytzinger_col_build(uint32_t)
+define_eytzinger_col_build(uint64_t)
+
+/**
+ * Generic function to search the first item greater or equal than a value
+ * on a column in Eytzinger order.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_eytzinger_lower_bound(T) \
+/** Search the first item greater or equal than a value on a column in Eytzinger order.
+The search is branchless and prefetches the descendants of the current node a few levels below.
+@param src       Column in Eytzinger order (see eytzinger_col_build_T).
+@param nrows     Number of rows.
+@param search    Unsigned number to search (type T).
+@return Eytzinger node (1-based) of the first item greater or equal than the search value, or 0 if none.
+ */ \
+static inline uint64_t eytzinger_lower_bound_##T(const T *src, uint64_t nrows, T search) \
+{ \
+    const uint64_t stride = (EYTZINGER_CACHELINE / sizeof(T)); \
+    uint64_t k = 1, pf; \
+    while (k <= nrows) \
+    { \
+        pf = ((k * stride) - 1); /* first descendant log2(stride) levels below */ \
+        binsearch_prefetch(src + ((pf < nrows) ? pf : 0)); \
+        pf += (stride - 1); /* last descendant, on the next cache line if not aligned */ \
+        binsearch_prefetch(src + ((pf < nrows) ? pf : 0)); \
+        k = ((2 * k) + (src[(k - 1)] < search)); \
+    } \
+    return (k >> (eytzinger_trailing_ones(k) + 1)); \
+}
+
+define_eytzinger_lower_bound(uint8_t)
+define_eytzinger_lower_bound(uint16_t)
+define_eytzinger_lower_bound(uint32_t)
+define_eytzinger_lower_bound(uint64_t)
+
+/**
+ * Generic function to search for the first occurrence of an unsigned integer
+ * on a column in Eytzinger order.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_eytzinger_find_first(T) \
+/** Search for the first occurrence of an unsigned integer on a column in Eytzinger order.
+@param src       Column in Eytzinger order (see eytzinger_col_build_T).
+@param nrows     Number of rows.
+@param search    Unsigned number to search (type T).
+@return Original (sorted) row index of the first occurrence if found or nrows if not found.
+ */ \
+static inline uint64_t eytzinger_find_first_##T(const T *src, uint64_t nrows, T search) \
+{ \
+    const uint64_t k = eytzinger_lower_bound_##T(src, nrows, search); \
+    if ((k == 0) || (src[(k - 1)] != search)) \
+    { \
+        return nrows; \
+    } \
+    return eytzinger_rank(k, nrows); \
+}
+
+define_eytzinger_find_first(uint8_t)
+define_eytzinger_find_first(uint16_t)
+define_eytzinger_find_first(uint32_t)
+define_eytzinger_find_first(uint64_t)
+
+#endif  // NUMKEY_EYTZINGER_H
@@ -0,0 +1,373 @@
+// NumKey
+//
+// lpm.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file lpm.h
+ * @brief Longest-prefix-match over PrefixKey routing tables.
+ *
+ * The functions provided here allows to find in a single search the longest prefix of a number
+ * in a static table of (prefix, length, value) tuples, where the prefixes are encoded with prefixkey().
+ *
+ * A prefix of L digits covers the PrefixKey interval [pk, pk + 10^(15 - L) - 1], and the intervals
+ * of different prefixes are either nested or disjoint. The builder sweeps the sorted intervals with a stack
+ * and splits the PrefixKey space in elementary segments, each one labeled with its most specific (longest)
+ * covering prefix. A lookup is then a single upper-bound search on the sorted segment boundaries.
+ * A directory indexed by the first radixdigits digits of the number restricts the search to the few segments
+ * starting with the same digits, and the value and length of each segment are stored in the same cache line.
+ * The search is branchless, and the batched version advances NKLPM_BATCH searches in lockstep,
+ * prefetching the next probes, so the cache misses of independent lookups overlap.
+ *
+ * The table is serialized as a single blob of uint64_t words that can be memory-mapped
+ * (e.g. with mmap_binfile) and used directly with lpm_load, without any parsing or allocation:
+ *
+ *   - header (NKLPM_HEADER_WORDS): magic "NKLPM1", nsegs, radixdigits;
+ *   - boundaries (nsegs): first PrefixKey of each segment (the first one is always 0);
+ *   - entries (2 * nsegs): value and length (or NKLPM_NOMATCH) of the longest prefix covering each segment;
+ *   - directory (10^radixdigits + 1 uint32_t, padded to 8 bytes): segment containing the first PrefixKey of each group.
+ */
+
+#ifndef NUMKEY_LPM_H
+#define NUMKEY_LPM_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "numkey.h"
+#include "prefixkey.h"
+
+#define NKLPM_MAGIC          0x0000314d504c4b4e //!< Magic number "NKLPM1" in LE.
+#define NKLPM_HEADER_WORDS   3                  //!< Number of uint64_t words in the header.
+#define NKLPM_NOMATCH        0xFF               //!< Length returned when no prefix matches.
+#define NKLPM_BATCH          16                 //!< Number of lookups advanced in lockstep by lpm_lookup_batch.
+#define NKLPM_MAXRADIXDIGITS 7                  //!< Maximum number of leading digits indexed by the directory (40 MB).
+
+/**
+ * Read-only view of a serialized longest-prefix-match table.
+ */
+typedef struct lpm_t
+{
+    const uint64_t *bounds;  //!< First PrefixKey of each segment.
+    const uint64_t *entries; //!< Value and length of the longest prefix covering each segment (NKLPM_NOMATCH if none).
+    const uint32_t *radix;   //!< Segment containing the first PrefixKey of each directory group.
+    uint64_t nsegs;          //!< Number of segments.
+    uint64_t radixspan;      //!< Number of PrefixKeys in each directory group.
+} lpm_t;
+
+/**
+ * Prefix interval used by the builder.
+ */
+typedef struct lpm_interval_t
+{
+    uint64_t start; //!< First PrefixKey covered by the prefix.
+    uint64_t end;   //!< Last PrefixKey covered by the prefix.
+    uint64_t idx;   //!< Index of the prefix in the input arrays.
+} lpm_interval_t;
+
+/**
+ * Returns the size in uint64_t words of the serialized table.
+ */
+static inline uint64_t lpm_words(uint64_t nsegs, uint8_t radixdigits)
+{
+    return (NKLPM_HEADER_WORDS + (3 * nsegs) + ((nk_pow10[radixdigits] + 2) / 2));
+}
+
+/**
+ * Initialize a longest-prefix-match view from a serialized blob (e.g. a memory-mapped file).
+ * The blob is not copied and it must be kept valid while the view is used.
+ *
+ * @param src  Address of the serialized blob (8-byte aligned).
+ * @param size Size of the blob in bytes.
+ * @param lpm  View to initialize.
+ *
+ * @return False if the blob is not a valid serialized table, true otherwise.
+ */
+static inline bool lpm_load(const uint8_t *src, uint64_t size, lpm_t *lpm)
+{
+    const uint64_t *p = (const uint64_t *)src;
+    if ((size < (NKLPM_HEADER_WORDS * sizeof(uint64_t))) || (p[0] != NKLPM_MAGIC)
+            || (p[1] == 0) || (p[1] > UINT32_MAX) || (p[2] > NKLPM_MAXRADIXDIGITS)
+            || ((size / sizeof(uint64_t)) < lpm_words(p[1], (uint8_t)p[2])))
+    {
+        return false;
+    }
+    lpm->nsegs = p[1];
+    lpm->radixspan = nk_pow10[(PKNUMMAXLEN - p[2])];
+    p += NKLPM_HEADER_WORDS;
+    lpm->bounds = p;
+    p += lpm->nsegs;
+    lpm->entries = p;
+    p += (2 * lpm->nsegs);
+    lpm->radix = (const uint32_t *)p;
+    return true;
+}
+
+/**
+ * Returns the longest prefix matching a PrefixKey.
+ *
+ * @param lpm   Longest-prefix-match view.
+ * @param pk    PrefixKey of the number (see prefixkey()): values not less than 10^PKNUMMAXLEN never match.
+ * @param value Pointer to the value of the longest matching prefix (unchanged if no prefix matches).
+ *
+ * @return Length of the longest matching prefix, or NKLPM_NOMATCH if no prefix matches.
+ */
+static inline uint8_t lpm_lookup(const lpm_t *lpm, uint64_t pk, uint64_t *value)
+{
+    if (pk >= nk_pow10[PKNUMMAXLEN])
+    {
+        return NKLPM_NOMATCH; // not a PrefixKey: the directory has no group for it
+    }
+    const uint64_t r = (pk / lpm->radixspan);
+    const uint64_t *base = (lpm->bounds + lpm->radix[r]);
+    uint64_t n = ((uint64_t)lpm->radix[(r + 1)] - lpm->radix[r] + 1), half = 0;
+    while (n > 1)
+    {
+        half = (n >> 1);
+        base = (base[half] <= pk) ? (base + half) : base; // compiled as a conditional move
+        n -= half;
+    }
+    const uint64_t *entry = (lpm->entries + (2 * (uint64_t)(base - lpm->bounds)));
+    if (entry[1] != NKLPM_NOMATCH)
+    {
+        *value = entry[0];
+    }
+    return (uint8_t)entry[1];
+}
+
+/**
+ * Returns the longest prefix matching a number.
+ * As in prefixkey(), numbers shorter than PKNUMMAXLEN digits are right-padded with zeros.
+ *
+ * @param lpm    Longest-prefix-match view.
+ * @param number String containing the number digits.
+ * @param size   Length of the number (number of digits).
+ * @param value  Pointer to the value of the longest matching prefix (unchanged if no prefix matches).
+ *
+ * @return Length of the longest matching prefix, or NKLPM_NOMATCH if no prefix matches.
+ */
+static inline uint8_t lpm_lookup_number(const lpm_t *lpm, const char *number, size_t size, uint64_t *value)
+{
+    return lpm_lookup(lpm, prefixkey(number, size), value);
+}
+
+/**
+ * Returns the longest prefixes matching a batch of PrefixKeys.
+ * The searches of NKLPM_BATCH keys are executed in lockstep, prefetching the next probe of each search.
+ *
+ * @param lpm     Longest-prefix-match view.
+ * @param pk      Array of n PrefixKeys (see prefixkey()): values not less than 10^PKNUMMAXLEN never match.
+ * @param n       Number of PrefixKeys.
+ * @param values  Array of n values of the longest matching prefixes (unchanged items if no prefix matches).
+ * @param lengths Array of n lengths of the longest matching prefixes (NKLPM_NOMATCH if no prefix matches).
+ */
+static inline void lpm_lookup_batch(const lpm_t *lpm, const uint64_t *pk, uint64_t n, uint64_t *values, uint8_t *lengths)
+{
+    uint64_t pos[NKLPM_BATCH];
+    uint64_t len[NKLPM_BATCH];
+    uint64_t i = 0, j = 0, m = 0, r = 0, maxlen = 0, half = 0;
+    const uint64_t *entry = NULL;
+    for (i = 0; i < n; i += NKLPM_BATCH)
+    {
+        m = ((n - i) < NKLPM_BATCH) ? (n - i) : NKLPM_BATCH;
+        maxlen = 0;
+        for (j = 0; j < m; j++)
+        {
+            r = (pk[(i + j)] < nk_pow10[PKNUMMAXLEN]) ? (pk[(i + j)] / lpm->radixspan) : 0; // invalid keys search the first group and never match
+            pos[j] = lpm->radix[r];
+            len[j] = ((uint64_t)lpm->radix[(r + 1)] - pos[j] + 1);
+            maxlen = (len[j] > maxlen) ? len[j] : maxlen;
+#if defined(__GNUC__)
+            __builtin_prefetch(lpm->bounds + pos[j] + (len[j] >> 1));
+#endif
+        }
+        while (maxlen > 1) // the completed searches (len = 1) keep their position
+        {
+            for (j = 0; j < m; j++)
+            {
+                half = (len[j] >> 1);
+                pos[j] = (lpm->bounds[(pos[j] + half)] <= pk[(i + j)]) ? (pos[j] + half) : pos[j];
+                len[j] -= half;
+#if defined(__GNUC__)
+                __builtin_prefetch(lpm->bounds + pos[j] + (len[j] >> 1));
+#endif
+            }
+            maxlen -= (maxlen >> 1);
+        }
+        for (j = 0; j < m; j++)
+        {
+            entry = (lpm->entries + (2 * pos[j]));
+            lengths[(i + j)] = (pk[(i + j)] < nk_pow10[PKNUMMAXLEN]) ? (uint8_t)entry[1] : NKLPM_NOMATCH;
+            if (lengths[(i + j)] != NKLPM_NOMATCH)
+            {
+                values[(i + j)] = entry[0];
+            }
+        }
+    }
+}
+
+/**
+ * Compares two prefix intervals by start and then by decreasing size (shorter prefixes first).
+ * Equal intervals are sorted by input index, so the last duplicated prefix wins.
+ */
+static inline int lpm_compare_interval(const void *a, const void *b)
+{
+    const lpm_interval_t *x = (const lpm_interval_t *)a;
+    const lpm_interval_t *y = (const lpm_interval_t *)b;
+    if (x->start != y->start)
+    {
+        return (x->start < y->start) ? -1 : 1;
+    }
+    if (x->end != y->end)
+    {
+        return (x->end > y->end) ? -1 : 1;
+    }
+    return (x->idx < y->idx) ? -1 : (x->idx > y->idx);
+}
+
+/**
+ * Build and serialize a longest-prefix-match table.
+ * This function is meant to be used offline: it allocates memory proportional to the number of prefixes.
+ *
+ * @param prefix      Array of prefixes encoded with prefixkey() (the digits after the prefix length are ignored).
+ * @param length      Array of prefix lengths (number of digits, max PKNUMMAXLEN).
+ * @param value       Array of values associated to the prefixes.
+ * @param n           Number of prefixes.
+ * @param radixdigits Number of leading digits indexed by the directory (max NKLPM_MAXRADIXDIGITS):
+ *                    the directory takes 4 * 10^radixdigits bytes (e.g. 6 for tables of millions of prefixes).
+ * @param size        Pointer to the size in bytes of the returned blob.
+ *
+ * @return Serialized blob allocated with malloc (to be freed by the caller),
+ *         or NULL in case of invalid arguments or memory allocation failure.
+ */
+static inline uint8_t *lpm_build(const uint64_t *prefix, const uint8_t *length, const uint64_t *value, uint64_t n, uint8_t radixdigits, uint64_t *size)
+{
+    if (radixdigits > NKLPM_MAXRADIXDIGITS)
+    {
+        return NULL;
+    }
+    lpm_interval_t *iv = (lpm_interval_t *)malloc(((n > 0) ? n : 1) * sizeof(lpm_interval_t));
+    uint64_t *stack = (uint64_t *)malloc(((n > 0) ? n : 1) * sizeof(uint64_t)); // indexes of the open intervals
+    uint64_t *segs = (uint64_t *)malloc(((2 * n) + 1) * 2 * sizeof(uint64_t));  // (start, winner) pairs
+    uint64_t i = 0, top = 0, nsegs = 0, cur = 0, win = 0, w = 0;
+    bool done = false;
+    if ((iv == NULL) || (stack == NULL) || (segs == NULL))
+    {
+        free(iv);
+        free(stack);
+        free(segs);
+        return NULL;
+    }
+    for (i = 0; i < n; i++)
+    {
+        if (length[i] > PKNUMMAXLEN)
+        {
+            free(iv);
+            free(stack);
+            free(segs);
+            return NULL;
+        }
+        uint64_t span = nk_pow10[(PKNUMMAXLEN - length[i])];
+        iv[i].start = (prefix[i] - (prefix[i] % span));
+        iv[i].end = (iv[i].start + span - 1);
+        iv[i].idx = i;
+    }
+    qsort(iv, (size_t)n, sizeof(lpm_interval_t), lpm_compare_interval);
+    // sweep: emit a segment every time the innermost open interval changes
+    i = 0;
+    while (!done)
+    {
+        // the next event is the end of the innermost open interval or the start of the next interval
+        if ((top > 0) && ((i == n) || (iv[stack[(top - 1)]].end < iv[i].start)))
+        {
+            w = stack[(top - 1)];
+            if (cur <= iv[w].end)
+            {
+                segs[(2 * nsegs)] = cur;
+                segs[((2 * nsegs) + 1)] = iv[w].idx;
+                nsegs++;
+                cur = (iv[w].end + 1);
+            }
+            top--;
+            continue;
+        }
+        if (i == n)
+        {
+            done = true;
+            if (cur < nk_pow10[PKNUMMAXLEN]) // the PrefixKey space is [0, 10^15)
+            {
+                segs[(2 * nsegs)] = cur;
+                segs[((2 * nsegs) + 1)] = UINT64_MAX;
+                nsegs++;
+            }
+            continue;
+        }
+        if (cur < iv[i].start)
+        {
+            segs[(2 * nsegs)] = cur;
+            segs[((2 * nsegs) + 1)] = (top > 0) ? iv[stack[(top - 1)]].idx : UINT64_MAX;
+            nsegs++;
+            cur = iv[i].start;
+        }
+        stack[top++] = i;
+        i++;
+    }
+    free(stack);
+    // merge the adjacent segments with the same winner
+    uint64_t nout = 0;
+    for (i = 0; i < nsegs; i++)
+    {
+        win = segs[((2 * i) + 1)];
+        if ((nout > 0) && (segs[((2 * (nout - 1)) + 1)] == win))
+        {
+            continue;
+        }
+        segs[(2 * nout)] = segs[(2 * i)];
+        segs[((2 * nout) + 1)] = win;
+        nout++;
+    }
+    free(iv);
+    *size = (lpm_words(nout, radixdigits) * sizeof(uint64_t));
+    uint8_t *blob = (uint8_t *)calloc(*size, 1);
+    if (blob == NULL)
+    {
+        free(segs);
+        return NULL;
+    }
+    uint64_t *p = (uint64_t *)blob;
+    p[0] = NKLPM_MAGIC;
+    p[1] = nout;
+    p[2] = radixdigits;
+    uint64_t *bounds = (p + NKLPM_HEADER_WORDS);
+    uint64_t *entries = (bounds + nout);
+    for (i = 0; i < nout; i++)
+    {
+        win = segs[((2 * i) + 1)];
+        bounds[i] = segs[(2 * i)];
+        entries[(2 * i)] = (win == UINT64_MAX) ? 0 : value[win];
+        entries[((2 * i) + 1)] = (win == UINT64_MAX) ? NKLPM_NOMATCH : length[win];
+    }
+    free(segs);
+    // directory: segment containing the first PrefixKey of each group (the last entry closes the last group)
+    uint32_t *radix = (uint32_t *)(entries + (2 * nout));
+    const uint64_t nradix = nk_pow10[radixdigits];
+    const uint64_t radixspan = nk_pow10[(PKNUMMAXLEN - radixdigits)];
+    uint64_t r = 0;
+    for (r = 0, i = 0; r < nradix; r++)
+    {
+        while (((i + 1) < nout) && (bounds[(i + 1)] <= (r * radixspan)))
+        {
+            i++;
+        }
+        radix[r] = (uint32_t)i;
+    }
+    radix[nradix] = (uint32_t)(nout - 1);
+    return blob;
+}
+
+#endif  // NUMKEY_LPM_H
@@ -0,0 +1,535 @@
+// NumKey
+//
+// mmsample.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file mmsample.h
+ * @brief Sampled in-memory search directory for memory mapped binsearch files.
+ *
+ * The first binary searches on a freshly memory mapped file page-fault on almost every probe,
+ * because the probed items are scattered over the whole file.
+ * The mmsample_t structure is a companion of mmfile_t that keeps in memory a sample of the search column
+ * (one value every "step" rows), small enough to fit in the L2 cache.
+ * The mmsample_range function searches the samples and narrows the first and last positions
+ * to a window of "step" rows (plus "step" rows for each sample equal to the search value),
+ * so only the last few probes of the following
+ * find_first_* / find_last_* (including the _sub_ and col_ variants) touch the mapped pages.
+ *
+ * The samples can be built at map time with the mmsample_build_* functions,
+ * or stored in the file (e.g. as an extra column) and attached with mmsample_init.
+ *
+ * The mmsample_find_* functions combine the two steps and, as the plain find functions,
+ * return the original last position when the search value is not found.
+ * When calling mmsample_range directly, a miss returns the narrowed last position instead,
+ * so the result must be compared with the narrowed last position.
+ */
+
+#ifndef NUMKEY_MMSAMPLE_H
+#define NUMKEY_MMSAMPLE_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "binsearch.h"
+
+#define MMSAMPLE_MAXBYTES 262144 //!< Default maximum size of the samples in bytes (fits in a typical L2 cache).
+
+/**
+ * Sampled search directory of a sorted column.
+ */
+typedef struct mmsample_t
+{
+    const uint64_t *keys; //!< Sampled values: keys[i] is the value of the row (i * step).
+    uint64_t *data;       //!< Allocated samples (NULL if the samples are external).
+    uint64_t nsamples;    //!< Number of samples.
+    uint64_t step;        //!< Number of rows between two consecutive samples.
+    uint64_t nrows;       //!< Number of rows of the sampled column.
+} mmsample_t;
+
+/**
+ * Returns the smallest sampling step that keeps the samples within the specified size.
+ *
+ * @param nrows    Number of rows.
+ * @param maxbytes Maximum size of the samples in bytes (e.g. MMSAMPLE_MAXBYTES).
+ *
+ * @return Sampling step (min 1).
+ */
+static inline uint64_t mmsample_step(uint64_t nrows, uint64_t maxbytes)
+{
+    const uint64_t maxsamples = ((maxbytes / sizeof(uint64_t)) > 0) ? (maxbytes / sizeof(uint64_t)) : 1;
+    return (nrows > maxsamples) ? (((nrows - 1) / maxsamples) + 1) : 1;
+}
+
+/**
+ * Initialize a sampled directory with external samples (e.g. stored in the memory mapped file).
+ * The samples are not copied and they must be kept valid while the directory is used.
+ *
+ * @param ms    Sampled directory to initialize.
+ * @param keys  Sampled values: keys[i] must be the value of the row (i * step), in native byte order.
+ * @param nrows Number of rows of the sampled column.
+ * @param step  Number of rows between two consecutive samples (min 1).
+ */
+static inline void mmsample_init(mmsample_t *ms, const uint64_t *keys, uint64_t nrows, uint64_t step)
+{
+    ms->keys = keys;
+    ms->data = NULL;
+    ms->step = (step > 0) ? step : 1;
+    ms->nrows = nrows;
+    ms->nsamples = (nrows > 0) ? (((nrows - 1) / ms->step) + 1) : 0;
+}
+
+/**
+ * Allocates the samples of a sampled directory.
+ *
+ * @param ms    Sampled directory to initialize.
+ * @param nrows Number of rows of the sampled column.
+ * @param step  Number of rows between two consecutive samples (0 = automatic, see mmsample_step).
+ *
+ * @return False in case of memory allocation failure, true otherwise.
+ */
+static inline bool mmsample_alloc(mmsample_t *ms, uint64_t nrows, uint64_t step)
+{
+    mmsample_init(ms, NULL, nrows, ((step > 0) ? step : mmsample_step(nrows, MMSAMPLE_MAXBYTES)));
+    ms->data = (uint64_t *)malloc(((ms->nsamples > 0) ? ms->nsamples : 1) * sizeof(uint64_t));
+    ms->keys = ms->data;
+    if (ms->data == NULL)
+    {
+        ms->nsamples = 0;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Free the samples allocated by the mmsample_build_* functions.
+ *
+ * @param ms Sampled directory.
+ */
+static inline void mmsample_free(mmsample_t *ms)
+{
+    free(ms->data);
+    ms->data = NULL;
+    ms->keys = NULL;
+    ms->nsamples = 0;
+}
+
+/**
+ * Generic function to build the sampled directory of a column of a memory mapped file
+ * containing adjacent blocks of sorted binary data.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_mmsample_build(O, T) \
+/** Build the sampled directory of a column of a memory mapped file containing adjacent blocks of sorted binary data.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+@param ms        Sampled directory to initialize (to be freed with mmsample_free).
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param nrows     Number of rows.
+@param step      Number of rows between two consecutive samples (0 = automatic, see mmsample_step).
+@return False in case of memory allocation failure, true otherwise.
+ */ \
+static inline bool mmsample_build_##O##_##T(mmsample_t *ms, const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t nrows, uint64_t step) \
+{ \
+    uint64_t i; \
+    if (!mmsample_alloc(ms, nrows, step)) \
+    { \
+        return false; \
+    } \
+    for (i = 0; i < ms->nsamples; i++) \
+    { \
+        ms->data[i] = (uint64_t)bytes_##O##_to_##T(src, get_address(blklen, blkpos, (i * ms->step))); \
+    } \
+    return true; \
+}
+
+define_mmsample_build(be, uint8_t)
+define_mmsample_build(be, uint16_t)
+define_mmsample_build(be, uint32_t)
+define_mmsample_build(be, uint64_t)
+define_mmsample_build(le, uint8_t)
+define_mmsample_build(le, uint16_t)
+define_mmsample_build(le, uint32_t)
+define_mmsample_build(le, uint64_t)
+
+/**
+ * Generic function to build the sampled directory of a sub-field of a column of a memory mapped file
+ * containing adjacent blocks of sorted binary data.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_mmsample_build_sub(O, T) \
+/** Build the sampled directory of a sub-field of a column of a memory mapped file containing adjacent blocks of sorted binary data,
+to be used with the find_first_sub_O_T and find_last_sub_O_T functions.
+The values in the file must be encoded in "O" format and sorted in ascending order.
+@param ms        Sampled directory to initialize (to be freed with mmsample_free).
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param nrows     Number of rows.
+@param step      Number of rows between two consecutive samples (0 = automatic, see mmsample_step).
+@return False in case of memory allocation failure, true otherwise.
+ */ \
+static inline bool mmsample_build_sub_##O##_##T(mmsample_t *ms, const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t nrows, uint64_t step) \
+{ \
+    uint64_t i; \
+    SUB_ITEM_VARS(T) \
+    if (!mmsample_alloc(ms, nrows, step)) \
+    { \
+        return false; \
+    } \
+    for (i = 0; i < ms->nsamples; i++) \
+    { \
+        ms->data[i] = (uint64_t)((bytes_##O##_to_##T(src, get_address(blklen, blkpos, (i * ms->step))) >> rshift) & bitmask); \
+    } \
+    return true; \
+}
+
+define_mmsample_build_sub(be, uint8_t)
+define_mmsample_build_sub(be, uint16_t)
+define_mmsample_build_sub(be, uint32_t)
+define_mmsample_build_sub(be, uint64_t)
+define_mmsample_build_sub(le, uint8_t)
+define_mmsample_build_sub(le, uint16_t)
+define_mmsample_build_sub(le, uint32_t)
+define_mmsample_build_sub(le, uint64_t)
+
+/**
+ * Generic function to build the sampled directory of a column of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_mmsample_col_build(T) \
+/** Build the sampled directory of a sorted column of unsigned integers of the same type.
+@param ms        Sampled directory to initialize (to be freed with mmsample_free).
+@param src       Sorted column address (e.g. get_src_offset_T(mf.src, mf.index[col])).
+@param nrows     Number of rows.
+@param step      Number of rows between two consecutive samples (0 = automatic, see mmsample_step).
+@return False in case of memory allocation failure, true otherwise.
+ */ \
+static inline bool mmsample_col_build_##T(mmsample_t *ms, const T *src, uint64_t nrows, uint64_t step) \
+{ \
+    uint64_t i; \
+    if (!mmsample_alloc(ms, nrows, step)) \
+    { \
+        return false; \
+    } \
+    for (i = 0; i < ms->nsamples; i++) \
+    { \
+        ms->data[i] = (uint64_t)src[(i * ms->step)]; \
+    } \
+    return true; \
+}
+
+define_mmsample_col_build(uint8_t)
+define_mmsample_col_build(uint16_t)
+define_mmsample_col_build(uint32_t)
+define_mmsample_col_build(uint64_t)
+
+/**
+ * Generic function to build the sampled directory of a sub-field of a column of unsigned integers of the same type.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_mmsample_col_build_sub(T) \
+/** Build the sampled directory of a sub-field of a sorted column of unsigned integers of the same type,
+to be used with the col_find_first_sub_T and col_find_last_sub_T functions.
+@param ms        Sampled directory to initialize (to be freed with mmsample_free).
+@param src       Sorted column address (e.g. get_src_offset_T(mf.src, mf.index[col])).
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param nrows     Number of rows.
+@param step      Number of rows between two consecutive samples (0 = automatic, see mmsample_step).
+@return False in case of memory allocation failure, true otherwise.
+ */ \
+static inline bool mmsample_col_build_sub_##T(mmsample_t *ms, const T *src, uint8_t bitstart, uint8_t bitend, uint64_t nrows, uint64_t step) \
+{ \
+    uint64_t i; \
+    SUB_ITEM_VARS(T) \
+    if (!mmsample_alloc(ms, nrows, step)) \
+    { \
+        return false; \
+    } \
+    for (i = 0; i < ms->nsamples; i++) \
+    { \
+        ms->data[i] = (uint64_t)((src[(i * ms->step)] >> rshift) & bitmask); \
+    } \
+    return true; \
+}
+
+define_mmsample_col_build_sub(uint8_t)
+define_mmsample_col_build_sub(uint16_t)
+define_mmsample_col_build_sub(uint32_t)
+define_mmsample_col_build_sub(uint64_t)
+
+/**
+ * Returns the number of samples smaller than (or smaller or equal to) the search value.
+ *
+ * @param ms     Sampled directory.
+ * @param search Value to search.
+ * @param equal  If true counts the samples smaller or equal to the search value.
+ *
+ * @return Number of samples.
+ */
+static inline uint64_t mmsample_rank(const mmsample_t *ms, uint64_t search, bool equal)
+{
+    const uint64_t *base = ms->keys;
+    uint64_t n = ms->nsamples, half = 0;
+    if (n == 0)
+    {
+        return 0;
+    }
+    while (n > 1)
+    {
+        half = (n >> 1);
+        base = ((base[half] < search) || (equal && (base[half] == search))) ? (base + half) : base;
+        n -= half;
+    }
+    return (uint64_t)(base - ms->keys) + (uint64_t)((*base < search) || (equal && (*base == search)));
+}
+
+/**
+ * Narrows a search range to the rows between the last sample smaller than the search value
+ * and the first sample greater than the search value.
+ * The narrowed range contains all the occurrences of the search value in the original range,
+ * so it can be used with any find_first_* and find_last_* function on the sampled column.
+ *
+ * @param ms     Sampled directory.
+ * @param search Value to search (as returned by the item task of the find functions, e.g. the sub-field value for the _sub_ variants).
+ * @param first  Pointer to the element from where to start the search (min value = 0). This will be updated.
+ * @param last   Pointer to the element (up to but not including) where to end the search (max value = nrows). This will be updated.
+ */
+static inline void mmsample_range(const mmsample_t *ms, uint64_t search, uint64_t *first, uint64_t *last)
+{
+    const uint64_t lt = mmsample_rank(ms, search, false);
+    const uint64_t le = (((lt < ms->nsamples) && (ms->keys[lt] == search)) ? mmsample_rank(ms, search, true) : lt);
+    const uint64_t start = (lt > 0) ? ((lt - 1) * ms->step) : 0;
+    const uint64_t end = (le < ms->nsamples) ? (le * ms->step) : ms->nrows;
+    *first = (start > *first) ? start : *first;
+    *last = (end < *last) ? end : *last;
+    *first = (*first < *last) ? *first : *last;
+}
+
+/**
+ * Returns the position found on a narrowed range, or the original last position if not found.
+ *
+ * @param pos      Position returned by a find function on the narrowed range.
+ * @param nlast    Narrowed last position (as set by mmsample_range).
+ * @param notfound Original last position.
+ *
+ * @return Position found or notfound.
+ */
+static inline uint64_t mmsample_found(uint64_t pos, uint64_t nlast, uint64_t notfound)
+{
+    return (pos < nlast) ? pos : notfound;
+}
+
+/**
+ * Generic function to search for the first and last occurrence of an unsigned integer
+ * on a memory mapped file narrowed by a sampled directory.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_mmsample_find(O, T) \
+/** Search for the first occurrence of a number, narrowing the range with the sampled directory (see find_first_O_T).
+@param ms        Sampled directory of the searched column.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param first     Pointer to the element from where to start the search (min value = 0). This will hold the position of the first item found.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nitems). This will hold the position of the last item found.
+@param search    Unsigned number to search (type T).
+@return First element position if found or the original value of last if not found.
+ */ \
+static inline uint64_t mmsample_find_first_##O##_##T(const mmsample_t *ms, const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t *first, uint64_t *last, T search) \
+{ \
+    const uint64_t notfound = *last; \
+    mmsample_range(ms, (uint64_t)search, first, last); \
+    const uint64_t nlast = *last; \
+    return mmsample_found(find_first_##O##_##T(src, blklen, blkpos, first, last, search), nlast, notfound); \
+} \
+/** Search for the last occurrence of a number, narrowing the range with the sampled directory (see find_last_O_T).
+@param ms        Sampled directory of the searched column.
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param first     Pointer to the element from where to start the search (min value = 0). This will hold the position of the first item found.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nitems). This will hold the position of the last item found.
+@param search    Unsigned number to search (type T).
+@return Last element position if found or the original value of last if not found.
+ */ \
+static inline uint64_t mmsample_find_last_##O##_##T(const mmsample_t *ms, const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint64_t *first, uint64_t *last, T search) \
+{ \
+    const uint64_t notfound = *last; \
+    mmsample_range(ms, (uint64_t)search, first, last); \
+    const uint64_t nlast = *last; \
+    return mmsample_found(find_last_##O##_##T(src, blklen, blkpos, first, last, search), nlast, notfound); \
+}
+
+define_mmsample_find(be, uint8_t)
+define_mmsample_find(be, uint16_t)
+define_mmsample_find(be, uint32_t)
+define_mmsample_find(be, uint64_t)
+define_mmsample_find(le, uint8_t)
+define_mmsample_find(le, uint16_t)
+define_mmsample_find(le, uint32_t)
+define_mmsample_find(le, uint64_t)
+
+/**
+ * Generic function to search for the first and last occurrence of a bit set
+ * on a memory mapped file narrowed by a sampled directory.
+ *
+ * @param O Endiannes: be or le.
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_mmsample_find_sub(O, T) \
+/** Search for the first occurrence of a bit set, narrowing the range with the sampled directory (see find_first_sub_O_T).
+@param ms        Sampled directory of the searched sub-field (see mmsample_build_sub_O_T).
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param first     Pointer to the element from where to start the search (min value = 0). This will hold the position of the first item found.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nitems). This will hold the position of the last item found.
+@param search    Unsigned number to search (type T).
+@return First element position if found or the original value of last if not found.
+ */ \
+static inline uint64_t mmsample_find_first_sub_##O##_##T(const mmsample_t *ms, const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
+{ \
+    const uint64_t notfound = *last; \
+    mmsample_range(ms, (uint64_t)search, first, last); \
+    const uint64_t nlast = *last; \
+    return mmsample_found(find_first_sub_##O##_##T(src, blklen, blkpos, bitstart, bitend, first, last, search), nlast, notfound); \
+} \
+/** Search for the last occurrence of a bit set, narrowing the range with the sampled directory (see find_last_sub_O_T).
+@param ms        Sampled directory of the searched sub-field (see mmsample_build_sub_O_T).
+@param src       Memory mapped file address.
+@param blklen    Length of the binary block in bytes.
+@param blkpos    Indicates the position of the number to search inside a binary block.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param first     Pointer to the element from where to start the search (min value = 0). This will hold the position of the first item found.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nitems). This will hold the position of the last item found.
+@param search    Unsigned number to search (type T).
+@return Last element position if found or the original value of last if not found.
+ */ \
+static inline uint64_t mmsample_find_last_sub_##O##_##T(const mmsample_t *ms, const uint8_t *src, uint64_t blklen, uint64_t blkpos, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
+{ \
+    const uint64_t notfound = *last; \
+    mmsample_range(ms, (uint64_t)search, first, last); \
+    const uint64_t nlast = *last; \
+    return mmsample_found(find_last_sub_##O##_##T(src, blklen, blkpos, bitstart, bitend, first, last, search), nlast, notfound); \
+}
+
+define_mmsample_find_sub(be, uint8_t)
+define_mmsample_find_sub(be, uint16_t)
+define_mmsample_find_sub(be, uint32_t)
+define_mmsample_find_sub(be, uint64_t)
+define_mmsample_find_sub(le, uint8_t)
+define_mmsample_find_sub(le, uint16_t)
+define_mmsample_find_sub(le, uint32_t)
+define_mmsample_find_sub(le, uint64_t)
+
+/**
+ * Generic function to search for the first and last occurrence of an unsigned integer
+ * on a column of unsigned integers of the same type narrowed by a sampled directory.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_mmsample_col_find(T) \
+/** Search for the first occurrence of a number, narrowing the range with the sampled directory (see col_find_first_T).
+@param ms        Sampled directory of the searched column.
+@param src       Sorted column address.
+@param first     Pointer to the element from where to start the search (min value = 0). This will hold the position of the first item found.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nitems). This will hold the position of the last item found.
+@param search    Unsigned number to search (type T).
+@return First element position if found or the original value of last if not found.
+ */ \
+static inline uint64_t mmsample_col_find_first_##T(const mmsample_t *ms, const T *src, uint64_t *first, uint64_t *last, T search) \
+{ \
+    const uint64_t notfound = *last; \
+    mmsample_range(ms, (uint64_t)search, first, last); \
+    const uint64_t nlast = *last; \
+    return mmsample_found(col_find_first_##T(src, first, last, search), nlast, notfound); \
+} \
+/** Search for the last occurrence of a number, narrowing the range with the sampled directory (see col_find_last_T).
+@param ms        Sampled directory of the searched column.
+@param src       Sorted column address.
+@param first     Pointer to the element from where to start the search (min value = 0). This will hold the position of the first item found.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nitems). This will hold the position of the last item found.
+@param search    Unsigned number to search (type T).
+@return Last element position if found or the original value of last if not found.
+ */ \
+static inline uint64_t mmsample_col_find_last_##T(const mmsample_t *ms, const T *src, uint64_t *first, uint64_t *last, T search) \
+{ \
+    const uint64_t notfound = *last; \
+    mmsample_range(ms, (uint64_t)search, first, last); \
+    const uint64_t nlast = *last; \
+    return mmsample_found(col_find_last_##T(src, first, last, search), nlast, notfound); \
+}
+
+define_mmsample_col_find(uint8_t)
+define_mmsample_col_find(uint16_t)
+define_mmsample_col_find(uint32_t)
+define_mmsample_col_find(uint64_t)
+
+/**
+ * Generic function to search for the first and last occurrence of a bit set
+ * on a column of unsigned integers of the same type narrowed by a sampled directory.
+ *
+ * @param T Unsigned integer type, one of: uint8_t, uint16_t, uint32_t, uint64_t.
+ */
+#define define_mmsample_col_find_sub(T) \
+/** Search for the first occurrence of a bit set, narrowing the range with the sampled directory (see col_find_first_sub_T).
+@param ms        Sampled directory of the searched sub-field (see mmsample_col_build_sub_T).
+@param src       Sorted column address.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param first     Pointer to the element from where to start the search (min value = 0). This will hold the position of the first item found.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nitems). This will hold the position of the last item found.
+@param search    Unsigned number to search (type T).
+@return First element position if found or the original value of last if not found.
+ */ \
+static inline uint64_t mmsample_col_find_first_sub_##T(const mmsample_t *ms, const T *src, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
+{ \
+    const uint64_t notfound = *last; \
+    mmsample_range(ms, (uint64_t)search, first, last); \
+    const uint64_t nlast = *last; \
+    return mmsample_found(col_find_first_sub_##T(src, bitstart, bitend, first, last, search), nlast, notfound); \
+} \
+/** Search for the last occurrence of a bit set, narrowing the range with the sampled directory (see col_find_last_sub_T).
+@param ms        Sampled directory of the searched sub-field (see mmsample_col_build_sub_T).
+@param src       Sorted column address.
+@param bitstart  First bit position to consider (usually 0).
+@param bitend    Last bit position to consider (usually the last bit, e.g. 7 for uint8_t, 15 for uint16_t, etc).
+@param first     Pointer to the element from where to start the search (min value = 0). This will hold the position of the first item found.
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nitems). This will hold the position of the last item found.
+@param search    Unsigned number to search (type T).
+@return Last element position if found or the original value of last if not found.
+ */ \
+static inline uint64_t mmsample_col_find_last_sub_##T(const mmsample_t *ms, const T *src, uint8_t bitstart, uint8_t bitend, uint64_t *first, uint64_t *last, T search) \
+{ \
+    const uint64_t notfound = *last; \
+    mmsample_range(ms, (uint64_t)search, first, last); \
+    const uint64_t nlast = *last; \
+    return mmsample_found(col_find_last_sub_##T(src, bitstart, bitend, first, last, search), nlast, notfound); \
+}
+
+define_mmsample_col_find_sub(uint8_t)
+define_mmsample_col_find_sub(uint16_t)
+define_mmsample_col_find_sub(uint32_t)
+define_mmsample_col_find_sub(uint64_t)
+
+#endif  // NUMKEY_MMSAMPLE_H
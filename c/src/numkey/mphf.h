@@ -0,0 +1,329 @@
+// NumKey
+//
+// mphf.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file mphf.h
+ * @brief Minimal perfect hash function for static NumKey sets.
+ *
+ * The functions provided here allows to build offline a minimal perfect hash function (BBHash algorithm)
+ * that maps each key of a static set of N unique NumKey codes to a distinct index in [0, N).
+ * The keys are hashed on a cascade of bit arrays (2 bits per key on the first level):
+ * the keys without collisions are assigned to the rank of their bit, the others move to the next level.
+ * The few keys left after NKMPHF_MAXLEVELS levels are stored in a small sorted fallback array.
+ *
+ * The function is serialized as a single little-endian blob of uint64_t words that can be memory-mapped
+ * (e.g. with mmap_binfile) and used directly with mphf_load, without any parsing or allocation:
+ *
+ *   - header (NKMPHF_HEADER_WORDS): magic "NKMPHF1", nkeys, nlevels, nwords, nranks, nfallback, haskeys;
+ *   - level offsets (nlevels + 1): start of each level bit array in words;
+ *   - bits (nwords): concatenated level bit arrays;
+ *   - rank samples (nranks): number of bits set before every block of NKMPHF_RANKWORDS words;
+ *   - fallback (nfallback): sorted keys not placed in the bit arrays;
+ *   - keys (nkeys if haskeys): the original keys ordered by index, to check the membership of any key.
+ *
+ * A lookup typically reads one bit array word, one rank sample and (optionally) one key.
+ */
+
+#ifndef NUMKEY_MPHF_H
+#define NUMKEY_MPHF_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binsearch.h"
+#include "numkey.h"
+#include "set.h"
+
+#define NKMPHF_MAGIC        0x00314648504d4b4e //!< Magic number "NKMPHF1" in LE.
+#define NKMPHF_HEADER_WORDS 7                  //!< Number of uint64_t words in the header.
+#define NKMPHF_MAXLEVELS    32                 //!< Maximum number of bit array levels.
+#define NKMPHF_RANKWORDS    8                  //!< Number of bit array words (512 bits) per rank sample.
+#define NKMPHF_LEVELSEED    0x9e3779b97f4a7c15 //!< Multiplier of the level number used to seed the level hash.
+
+/**
+ * Read-only view of a serialized minimal perfect hash function.
+ */
+typedef struct mphf_t
+{
+    const uint64_t *offsets;  //!< Start of each level bit array in words (nlevels + 1 items).
+    const uint64_t *bits;     //!< Concatenated level bit arrays.
+    const uint64_t *ranks;    //!< Number of bits set before every block of NKMPHF_RANKWORDS words.
+    const uint64_t *fallback; //!< Sorted keys not placed in the bit arrays.
+    const uint64_t *keys;     //!< Keys ordered by index (NULL if not stored).
+    uint64_t nkeys;           //!< Number of keys.
+    uint64_t nlevels;         //!< Number of levels.
+    uint64_t nwords;          //!< Number of bit array words.
+    uint64_t nranks;          //!< Number of rank samples.
+    uint64_t nfallback;       //!< Number of fallback keys.
+} mphf_t;
+
+/**
+ * Returns the number of bits set in a 64 bit word.
+ */
+static inline uint64_t mphf_popcount(uint64_t v)
+{
+#if defined(__GNUC__)
+    return (uint64_t)__builtin_popcountll(v);
+#else
+    v = v - ((v >> 1) & 0x5555555555555555);
+    v = (v & 0x3333333333333333) + ((v >> 2) & 0x3333333333333333);
+    v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0f;
+    return ((v * 0x0101010101010101) >> 56);
+#endif
+}
+
+/**
+ * Returns the position of a key in the bit array of the specified level.
+ *
+ * @param nk    NumKey.
+ * @param level Level number.
+ * @param nbits Number of bits of the level.
+ *
+ * @return Bit position in [0, nbits).
+ */
+static inline uint64_t mphf_level_pos(uint64_t nk, uint64_t level, uint64_t nbits)
+{
+    return mulhi64(numkey_hash(nk ^ (NKMPHF_LEVELSEED * (level + 1))), nbits); // multiply-shift range reduction
+}
+
+/**
+ * Returns the number of bits set before the specified position of the bit arrays.
+ */
+static inline uint64_t mphf_rank(const mphf_t *mph, uint64_t pos)
+{
+    uint64_t w = (pos >> 6);
+    uint64_t i = (w & ~(uint64_t)(NKMPHF_RANKWORDS - 1));
+    uint64_t r = mph->ranks[(w / NKMPHF_RANKWORDS)];
+    for (; i < w; i++)
+    {
+        r += mphf_popcount(mph->bits[i]);
+    }
+    return (r + mphf_popcount(mph->bits[w] & (((uint64_t)1 << (pos & 63)) - 1)));
+}
+
+/**
+ * Initialize a minimal perfect hash view from a serialized blob (e.g. a memory-mapped file).
+ * The blob is not copied and it must be kept valid while the view is used.
+ *
+ * @param src  Address of the serialized blob (8-byte aligned).
+ * @param size Size of the blob in bytes.
+ * @param mph  View to initialize.
+ *
+ * @return False if the blob is not a valid serialized minimal perfect hash function, true otherwise.
+ */
+static inline bool mphf_load(const uint8_t *src, uint64_t size, mphf_t *mph)
+{
+    const uint64_t *p = (const uint64_t *)src;
+    if ((size < (NKMPHF_HEADER_WORDS * sizeof(uint64_t))) || (p[0] != NKMPHF_MAGIC) || (p[2] > NKMPHF_MAXLEVELS))
+    {
+        return false;
+    }
+    mph->nkeys = p[1];
+    mph->nlevels = p[2];
+    mph->nwords = p[3];
+    mph->nranks = p[4];
+    mph->nfallback = p[5];
+    uint64_t nwords = (NKMPHF_HEADER_WORDS + mph->nlevels + 1 + mph->nwords + mph->nranks + mph->nfallback + ((p[6] != 0) ? mph->nkeys : 0));
+    if ((size / sizeof(uint64_t)) < nwords)
+    {
+        return false;
+    }
+    p += NKMPHF_HEADER_WORDS;
+    mph->offsets = p;
+    p += (mph->nlevels + 1);
+    mph->bits = p;
+    p += mph->nwords;
+    mph->ranks = p;
+    p += mph->nranks;
+    mph->fallback = p;
+    p += mph->nfallback;
+    mph->keys = (((const uint64_t *)src)[6] != 0) ? p : NULL;
+    return true;
+}
+
+/**
+ * Returns the index associated to a key.
+ * If the keys are stored in the blob, the index is verified and any key not in the set returns nkeys;
+ * otherwise a key not in the set returns an arbitrary index (or nkeys).
+ *
+ * @param mph Minimal perfect hash view.
+ * @param nk  NumKey to search.
+ *
+ * @return Index in [0, nkeys) or nkeys if not found.
+ */
+static inline uint64_t mphf_index(const mphf_t *mph, uint64_t nk)
+{
+    uint64_t l = 0, pos = 0, idx = mph->nkeys;
+    for (l = 0; l < mph->nlevels; l++)
+    {
+        pos = (mph->offsets[l] << 6) + mphf_level_pos(nk, l, ((mph->offsets[(l + 1)] - mph->offsets[l]) << 6));
+        if ((mph->bits[(pos >> 6)] >> (pos & 63)) & 1)
+        {
+            idx = mphf_rank(mph, pos);
+            break;
+        }
+    }
+    if ((l == mph->nlevels) && (mph->nfallback > 0) && (nk <= mph->fallback[(mph->nfallback - 1)])) // the search never reads past the last fallback key
+    {
+        uint64_t first = 0, last = mph->nfallback;
+        pos = col_find_first_uint64_t(mph->fallback, &first, &last, nk);
+        if (pos < mph->nfallback)
+        {
+            idx = (mph->nkeys - mph->nfallback + pos);
+        }
+    }
+    if ((mph->keys != NULL) && (idx < mph->nkeys) && (mph->keys[idx] != nk))
+    {
+        return mph->nkeys;
+    }
+    return idx;
+}
+
+/**
+ * Build and serialize a minimal perfect hash function for a set of unique keys
+ * (e.g. a NumKey array processed with sort_uint64_t and unique_uint64_t).
+ * This function is meant to be used offline: it allocates memory proportional to the number of keys.
+ *
+ * @param keys      Array of unique NumKey codes.
+ * @param nkeys     Number of keys.
+ * @param storekeys If true the keys are stored in the blob ordered by index, so mphf_index can reject the keys not in the set.
+ * @param size      Pointer to the size in bytes of the returned blob.
+ *
+ * @return Serialized blob allocated with malloc (to be freed by the caller), or NULL in case of memory allocation failure.
+ */
+static inline uint8_t *mphf_build(const uint64_t *keys, uint64_t nkeys, bool storekeys, uint64_t *size)
+{
+    uint64_t *cur = (uint64_t *)malloc(((nkeys > 0) ? nkeys : 1) * sizeof(uint64_t));
+    uint64_t *bits = NULL, *col = NULL, *tmp = NULL;
+    uint64_t offsets[(NKMPHF_MAXLEVELS + 1)];
+    uint64_t n = nkeys, nwords = 0, nlevels = 0, words = 0, i = 0, j = 0, p = 0;
+    uint8_t *blob = NULL;
+    if (cur == NULL)
+    {
+        return NULL;
+    }
+    memcpy(cur, keys, (nkeys * sizeof(uint64_t)));
+    offsets[0] = 0;
+    while ((n > 0) && (nlevels < NKMPHF_MAXLEVELS))
+    {
+        words = (((2 * n) + 63) >> 6); // 2 bits per key
+        tmp = (uint64_t *)realloc(bits, ((nwords + words) * sizeof(uint64_t)));
+        free(col);
+        col = (uint64_t *)calloc(words, sizeof(uint64_t));
+        if ((tmp == NULL) || (col == NULL))
+        {
+            free((tmp == NULL) ? bits : tmp);
+            free(col);
+            free(cur);
+            return NULL;
+        }
+        bits = tmp;
+        uint64_t *lvl = (bits + nwords);
+        memset(lvl, 0, (words * sizeof(uint64_t)));
+        for (i = 0; i < n; i++)
+        {
+            p = mphf_level_pos(cur[i], nlevels, (words << 6));
+            if ((lvl[(p >> 6)] >> (p & 63)) & 1)
+            {
+                col[(p >> 6)] |= ((uint64_t)1 << (p & 63));
+            }
+            lvl[(p >> 6)] |= ((uint64_t)1 << (p & 63));
+        }
+        for (i = 0; i < words; i++)
+        {
+            lvl[i] &= ~col[i];
+        }
+        for (i = 0, j = 0; i < n; i++)
+        {
+            p = mphf_level_pos(cur[i], nlevels, (words << 6));
+            if ((col[(p >> 6)] >> (p & 63)) & 1)
+            {
+                cur[j++] = cur[i]; // collision: move to the next level
+            }
+        }
+        n = j;
+        nwords += words;
+        offsets[++nlevels] = nwords;
+    }
+    free(col);
+    if (n > 1)
+    {
+        tmp = (uint64_t *)malloc(n * sizeof(uint64_t));
+        if (tmp == NULL)
+        {
+            free(bits);
+            free(cur);
+            return NULL;
+        }
+        sort_uint64_t(cur, tmp, (uint32_t)n);
+        free(tmp);
+    }
+    uint64_t nranks = ((nwords / NKMPHF_RANKWORDS) + 1);
+    uint64_t total = (NKMPHF_HEADER_WORDS + nlevels + 1 + nwords + nranks + n + (storekeys ? nkeys : 0));
+    *size = (total * sizeof(uint64_t));
+    blob = (uint8_t *)malloc(*size);
+    if (blob == NULL)
+    {
+        free(bits);
+        free(cur);
+        return NULL;
+    }
+    uint64_t *out = (uint64_t *)blob;
+    out[0] = NKMPHF_MAGIC;
+    out[1] = nkeys;
+    out[2] = nlevels;
+    out[3] = nwords;
+    out[4] = nranks;
+    out[5] = n;
+    out[6] = (storekeys ? 1 : 0);
+    out += NKMPHF_HEADER_WORDS;
+    memcpy(out, offsets, ((nlevels + 1) * sizeof(uint64_t)));
+    out += (nlevels + 1);
+    if (nwords > 0)
+    {
+        memcpy(out, bits, (nwords * sizeof(uint64_t)));
+    }
+    uint64_t *ranks = (out + nwords);
+    for (i = 0, p = 0; i < nranks; i++)
+    {
+        ranks[i] = p;
+        for (j = (i * NKMPHF_RANKWORDS); (j < ((i + 1) * NKMPHF_RANKWORDS)) && (j < nwords); j++)
+        {
+            p += mphf_popcount(bits[j]);
+        }
+    }
+    out = (ranks + nranks);
+    if (n > 0)
+    {
+        memcpy(out, cur, (n * sizeof(uint64_t)));
+    }
+    free(bits);
+    free(cur);
+    if (storekeys)
+    {
+        mphf_t mph;
+        ((uint64_t *)blob)[6] = 0; // temporarily disable the key check to compute the indexes
+        if (!mphf_load(blob, *size, &mph))
+        {
+            free(blob);
+            return NULL;
+        }
+        out += n;
+        for (i = 0; i < nkeys; i++)
+        {
+            out[mphf_index(&mph, keys[i])] = keys[i];
+        }
+        ((uint64_t *)blob)[6] = 1;
+    }
+    return blob;
+}
+
+#endif  // NUMKEY_MPHF_H
@@ -20,9 +20,16 @@
 #define NUMKEY_NUMKEY_H
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
+#include "e164.h"
 #include "hex.h"
 
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
 #define NKBMASK_COUNTRY_FL 0xF800000000000000  //!< Bit mask for the ISO 3166 alpha-2 country code first letter  [ 11111000 00000000 00000000 00000000 00000000 00000000 00000000 00000000 ].
 #define NKBMASK_COUNTRY_SL 0x07C0000000000000  //!< Bit mask for the ISO 3166 alpha-2 country code second letter [ 00000111 11000000 00000000 00000000 00000000 00000000 00000000 00000000 ].
 #define NKBMASK_NUMBER     0x003FFFFFFFFFFFF0  //!< Bit mask for the short code or E.164 number (max 15 digits)  [ 00000000 00111111 11111111 11111111 11111111 11111111 11111111 11110000 ].
@@ -39,6 +46,14 @@
 
 #define NKNUMMAXLEN         15 //!< Maximum number length for E.164 and key reversibility.
 
+#define NKNUMSTRIDE         16 //!< Stride in bytes of each number in the digit column produced by decode_numkey_batch().
+
+#define NKSTATUS_OK          0 //!< numkey_checked() status: valid input.
+#define NKSTATUS_ECOUNTRY    1 //!< numkey_checked() status: the country is not made of two uppercase A-Z letters.
+#define NKSTATUS_EEMPTY      2 //!< numkey_checked() status: empty number.
+#define NKSTATUS_EDIGIT      3 //!< numkey_checked() status: the number contains non-digit characters.
+#define NKSTATUS_LONG        4 //!< numkey_checked() status: valid number longer than NKNUMMAXLEN, encoded as non-reversible NumKey.
+
 /**
  * NumKey struct.
  * Contains the NumKey components (COUNTRY, NUMBER).
@@ -114,8 +129,102 @@ static inline uint64_t encode_number(const char *number, size_t size)
     return ((num << NKBSHIFT_NUMBER) | (len & NKBMASK_LENGTH));
 }
 
+/**
+ * Lookup table containing the ASCII representation of all numbers from 00 to 99.
+ */
+static const char nk_digit_pairs[200] =
+{
+    '0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
+    '1', '0', '1', '1', '1', '2', '1', '3', '1', '4', '1', '5', '1', '6', '1', '7', '1', '8', '1', '9',
+    '2', '0', '2', '1', '2', '2', '2', '3', '2', '4', '2', '5', '2', '6', '2', '7', '2', '8', '2', '9',
+    '3', '0', '3', '1', '3', '2', '3', '3', '3', '4', '3', '5', '3', '6', '3', '7', '3', '8', '3', '9',
+    '4', '0', '4', '1', '4', '2', '4', '3', '4', '4', '4', '5', '4', '6', '4', '7', '4', '8', '4', '9',
+    '5', '0', '5', '1', '5', '2', '5', '3', '5', '4', '5', '5', '5', '6', '5', '7', '5', '8', '5', '9',
+    '6', '0', '6', '1', '6', '2', '6', '3', '6', '4', '6', '5', '6', '6', '6', '7', '6', '8', '6', '9',
+    '7', '0', '7', '1', '7', '2', '7', '3', '7', '4', '7', '5', '7', '6', '7', '7', '7', '8', '7', '9',
+    '8', '0', '8', '1', '8', '2', '8', '3', '8', '4', '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+    '9', '0', '9', '1', '9', '2', '9', '3', '9', '4', '9', '5', '9', '6', '9', '7', '9', '8', '9', '9',
+};
+
+/**
+ * Returns the upper 64 bits of the 128 bit product of two unsigned 64 bit integers.
+ *
+ * @param a First factor.
+ * @param b Second factor.
+ *
+ * @return High 64 bits of the product.
+ */
+static inline uint64_t mulhi64(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 nkuint128_t;
+    return (uint64_t)(((nkuint128_t)a * b) >> 64);
+#else
+    uint64_t alo = (a & 0xFFFFFFFF), ahi = (a >> 32);
+    uint64_t blo = (b & 0xFFFFFFFF), bhi = (b >> 32);
+    uint64_t p0 = (alo * blo), p1 = (alo * bhi), p2 = (ahi * blo), p3 = (ahi * bhi);
+    uint64_t mid = ((p0 >> 32) + (p1 & 0xFFFFFFFF) + (p2 & 0xFFFFFFFF));
+    return (p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32));
+#endif
+}
+
+/**
+ * Splits a number smaller than 10^8 into four 2-digit groups without using divisions.
+ *
+ * @param v     Number to split (max 99999999).
+ * @param pairs Output array of 4 values (00 to 99), most significant first.
+ */
+static inline void split_digits8(uint32_t v, uint8_t *pairs)
+{
+    uint32_t hi = (uint32_t)(((uint64_t)v * 109951163) >> 40); // v / 10000 for v < 2^27
+    uint32_t lo = (v - (hi * 10000));
+    uint32_t hh = ((hi * 5243) >> 19); // hi / 100 for hi < 43699
+    uint32_t lh = ((lo * 5243) >> 19);
+    pairs[0] = (uint8_t)hh;
+    pairs[1] = (uint8_t)(hi - (hh * 100));
+    pairs[2] = (uint8_t)lh;
+    pairs[3] = (uint8_t)(lo - (lh * 100));
+}
+
+/**
+ * Splits a NUMBER field value into eight 2-digit groups (16 zero-padded digits) without using divisions.
+ * The value is first split into two 8-digit chunks with a multiply-shift reciprocal of 10^8.
+ *
+ * @param num   Number to split (max 2^50 - 1).
+ * @param pairs Output array of 8 values (00 to 99), most significant first.
+ */
+static inline void split_digits16(uint64_t num, uint8_t *pairs)
+{
+    uint64_t hi = (mulhi64(num, 0xabcc77118461cefd) >> 26); // num / 10^8 for num < 2^50
+    split_digits8((uint32_t)hi, pairs);
+    split_digits8((uint32_t)(num - (hi * 100000000)), pairs + 4);
+}
+
+/**
+ * Writes the last "size" digits of a NUMBER field value, two digits at a time from the digit-pair table.
+ *
+ * @param num    Number to write (max 2^50 - 1).
+ * @param size   Number of digits to write (max 16).
+ * @param number Output buffer (at least "size" bytes, no NULL terminator is added).
+ */
+static inline void write_digits(uint64_t num, size_t size, char *number)
+{
+    uint8_t pairs[8];
+    size_t i = 0;
+    split_digits16(num, pairs);
+    for (i = 0; i < (size >> 1); i++)
+    {
+        memcpy(number + size - (2 * (i + 1)), &nk_digit_pairs[2 * pairs[7 - i]], 2);
+    }
+    if (size & 1)
+    {
+        number[0] = nk_digit_pairs[(2 * pairs[7 - i]) + 1];
+    }
+}
+
 /**
  * Decode number into string.
+ * The digits are generated without divisions using multiply-shift reciprocals and a digit-pair table.
  *
  * @param nk       NumKey.
  * @param number   Number string buffer to be returned.
@@ -125,15 +234,7 @@ static inline uint64_t encode_number(const char *number, size_t size)
 static inline size_t decode_number(uint64_t nk, char *number)
 {
     size_t size = (size_t)(nk & NKBMASK_LENGTH);
-    uint64_t num = ((nk & NKBMASK_NUMBER) >> NKBSHIFT_NUMBER);
-    int rem = 0;
-    int i = 0;
-    for (i = (int)(size - 1); i >= 0; i--)
-    {
-        rem = (int)(num % 10);
-        number[i] = (char)(rem + '0');
-        num = (num / 10);
-    }
+    write_digits(((nk & NKBMASK_NUMBER) >> NKBSHIFT_NUMBER), size, number);
     number[size] = 0;
     return size;
 }
@@ -152,6 +253,314 @@ static inline uint64_t numkey(const char *country, const char *number, size_t nu
     return (encode_country(country) | encode_number(number, numsize));
 }
 
+#if defined(__AVX2__) || defined(__SSE4_1__)
+
+#define NKZEROS 0x3030303030303030 //!< Eight '0' characters packed in a 64 bit word.
+
+/**
+ * Loads up to 8 bytes of the number string into a little-endian 64 bit word without reading outside the string.
+ *
+ * @param number String containing the number digits.
+ * @param size   Number of bytes to load (1 to 8).
+ *
+ * @return Little-endian word containing the loaded bytes in the lower positions.
+ */
+static inline uint64_t load_digits8(const char *number, size_t size)
+{
+    uint64_t a = 0, b = 0;
+    if (size >= 8)
+    {
+        memcpy(&a, number, 8);
+        return a;
+    }
+    if (size >= 4)
+    {
+        memcpy(&a, number, 4);
+        memcpy(&b, number + size - 4, 4);
+        return (a | (b << (8 * (size - 4)))); // overlapping bytes are identical
+    }
+    if (size >= 2)
+    {
+        memcpy(&a, number, 2);
+        memcpy(&b, number + size - 2, 2);
+        return (a | (b << (8 * (size - 2))));
+    }
+    return (uint64_t)(uint8_t)number[0];
+}
+
+/**
+ * Loads the number digits into a 16-byte vector, right-aligned and left-padded with '0' characters.
+ * Only the last 15 digits are loaded if the number is longer than NKNUMMAXLEN.
+ *
+ * @param number String containing the Short code or E.164 LVN number.
+ * @param size   Length of the number (number of digits).
+ * @param len    Value of the LENGTH field to be returned (0 for non-reversible long numbers).
+ *
+ * @return Vector of 16 ASCII digits, most significant first.
+ */
+static inline __m128i load_number16_sse(const char *number, size_t size, uint64_t *len)
+{
+    *len = (uint64_t)(size);
+    if (size > NKNUMMAXLEN)
+    {
+        number += (size - NKNUMMAXLEN); // last 15 digits
+        size = NKNUMMAXLEN;
+        *len = 0;                       // flag non-revesible encoding
+    }
+    if (size > 8)
+    {
+        uint64_t hi = load_digits8(number, 8);
+        uint64_t lo = load_digits8(number + size - 8, 8);
+        hi = ((hi << (8 * (16 - size))) | (NKZEROS >> (8 * (size - 8))));
+        return _mm_set_epi64x((int64_t)lo, (int64_t)hi);
+    }
+    if (size == 0)
+    {
+        return _mm_set1_epi8('0');
+    }
+    uint64_t lo = load_digits8(number, size);
+    if (size < 8)
+    {
+        lo = ((lo << (8 * (8 - size))) | (NKZEROS >> (8 * size)));
+    }
+    return _mm_set_epi64x((int64_t)lo, (int64_t)NKZEROS);
+}
+
+/**
+ * Converts a vector of 16 ASCII digits into its numerical value using multiply-add reductions.
+ *
+ * @param v Vector of 16 ASCII digits, most significant first.
+ *
+ * @return Numerical value of the digits.
+ */
+static inline uint64_t parse_digits16_sse(__m128i v)
+{
+    v = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    v = _mm_maddubs_epi16(v, _mm_set1_epi16(0x010a)); // 8 x 2 digits
+    v = _mm_madd_epi16(v, _mm_set1_epi32(0x00010064)); // 4 x 4 digits
+    v = _mm_packus_epi32(v, v);
+    v = _mm_madd_epi16(v, _mm_set1_epi32(0x00012710)); // 2 x 8 digits
+    return (((uint64_t)(uint32_t)_mm_cvtsi128_si32(v) * 100000000) + (uint64_t)(uint32_t)_mm_extract_epi32(v, 1));
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+/**
+ * Converts two vectors of 16 ASCII digits into their numerical values using multiply-add reductions.
+ *
+ * @param a   First vector of 16 ASCII digits, most significant first.
+ * @param b   Second vector of 16 ASCII digits, most significant first.
+ * @param out Array of two numerical values to be returned.
+ */
+static inline void parse_digits16x2_avx2(__m128i a, __m128i b, uint64_t *out)
+{
+    __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1);
+    v = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+    v = _mm256_maddubs_epi16(v, _mm256_set1_epi16(0x010a)); // 2 x 8 x 2 digits
+    v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00010064)); // 2 x 4 x 4 digits
+    v = _mm256_packus_epi32(v, v);
+    v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00012710)); // 2 x 2 x 8 digits
+    out[0] = (((uint64_t)(uint32_t)_mm256_extract_epi32(v, 0) * 100000000) + (uint64_t)(uint32_t)_mm256_extract_epi32(v, 1));
+    out[1] = (((uint64_t)(uint32_t)_mm256_extract_epi32(v, 4) * 100000000) + (uint64_t)(uint32_t)_mm256_extract_epi32(v, 5));
+}
+
+#endif
+
+/**
+ * Encode an array of numkeys.
+ * This produces the same output as calling numkey() on each element.
+ * When compiled with AVX2 or SSE4.1 support (e.g. -mavx2 or -msse4.1) the digits are converted 16 at a time
+ * with SIMD multiply-add reductions, otherwise the scalar encoder is used.
+ *
+ * @param country Array of ISO 3166 alpha-2 country codes.
+ * @param number  Array of strings containing the Short code or LVN number.
+ * @param numsize Array of number lengths (number of digits).
+ * @param nk      Pre-allocated output array of NumKey 64 bit codes.
+ * @param n       Number of elements to process.
+ */
+static inline void numkey_batch(const char *const *country, const char *const *number, const size_t *numsize, uint64_t *nk, size_t n)
+{
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE4_1__)
+    uint64_t len[2];
+#endif
+#if defined(__AVX2__)
+    uint64_t num[2];
+    __m128i a, b;
+    for (; (i + 1) < n; i += 2)
+    {
+        a = load_number16_sse(number[i], numsize[i], &len[0]);
+        b = load_number16_sse(number[i + 1], numsize[i + 1], &len[1]);
+        parse_digits16x2_avx2(a, b, num);
+        nk[i] = (encode_country(country[i]) | (num[0] << NKBSHIFT_NUMBER) | len[0]);
+        nk[i + 1] = (encode_country(country[i + 1]) | (num[1] << NKBSHIFT_NUMBER) | len[1]);
+    }
+#endif
+#if defined(__AVX2__) || defined(__SSE4_1__)
+    for (; i < n; i++)
+    {
+        nk[i] = (encode_country(country[i]) | (parse_digits16_sse(load_number16_sse(number[i], numsize[i], &len[0])) << NKBSHIFT_NUMBER) | len[0]);
+    }
+#else
+    for (; i < n; i++)
+    {
+        nk[i] = numkey(country[i], number[i], numsize[i]);
+    }
+#endif
+}
+
+/**
+ * Encode numkey from a formatted number in a single pass and without allocations.
+ * Formatting characters (space, dash, dot, slash, parentheses), the "(0)" trunk prefix
+ * and the international prefix ("+" or "00") are skipped while accumulating the digits (see e164.h).
+ * The result is the same as calling numkey() with the significant digits only.
+ *
+ * @param country ISO 3166 alpha-2 country code.
+ * @param number  String containing the formatted number (e.g. "+44 (0)20 7946-0018").
+ * @param size    Length of the number string.
+ * @param nk      NumKey 64 bit code to be returned.
+ *
+ * @return Number of significant digits consumed.
+ */
+static inline size_t numkey_norm(const char *country, const char *number, size_t size, uint64_t *nk)
+{
+    uint64_t num = 0;
+    size_t len = 0;
+    size_t pos = e164_start(number, size);
+    int b = 0;
+    while ((b = e164_next_digit(number, size, &pos)) >= 0)
+    {
+        num = (num * 10) + (uint64_t)b;
+        if (++len > NKNUMMAXLEN)
+        {
+            num %= 1000000000000000; // keep the last 15 digits
+        }
+    }
+    *nk = (encode_country(country) | (num << NKBSHIFT_NUMBER) | ((len > NKNUMMAXLEN) ? 0 : (uint64_t)len));
+    return len;
+}
+
+/**
+ * Encode numkey for an E.164 LVN without a country argument.
+ * The country is resolved from the calling code with a constant-time table lookup (see e164_lookup()).
+ *
+ * @param number  String containing the E.164 number digits (without the international prefix).
+ * @param numsize Length of the number (number of digits).
+ *
+ * @return NumKey 64 bit code, or 0 if the calling code is not assigned to a country.
+ */
+static inline uint64_t numkey_e164(const char *number, size_t numsize)
+{
+    uint16_t e = e164_lookup(number, numsize);
+    if (e == 0)
+    {
+        return 0;
+    }
+    return (((uint64_t)(e & E164BMASK_COUNTRY) << NKBSHIFT_COUNTRY_SL) | encode_number(number, numsize));
+}
+
+/**
+ * Returns 1 if the character is not an uppercase A-Z letter, 0 otherwise.
+ *
+ * @param c Character to check.
+ */
+static inline uint8_t invalid_char(char c)
+{
+    return (uint8_t)((uint8_t)(c - 'A') > ('Z' - 'A'));
+}
+
+/**
+ * Returns 1 if the character is not a 0-9 digit, 0 otherwise.
+ *
+ * @param c Character to check.
+ */
+static inline uint8_t invalid_digit(char c)
+{
+    return (uint8_t)((uint8_t)(c - '0') > 9);
+}
+
+/**
+ * Validate and encode numkey in a single pass.
+ * The encoding rules are the same as numkey(), but the input is checked for errors.
+ * When compiled with SSE4.1 support (e.g. -msse4.1) the digit range checks and the conversion are performed with SIMD instructions.
+ *
+ * @param country ISO 3166 alpha-2 country code (uppercase).
+ * @param number  String containing the Short code or LVN number (digits only).
+ * @param numsize Length of the number (number of digits).
+ * @param nk      NumKey 64 bit code to be returned (set to 0 in case of error).
+ *
+ * @return Status code: NKSTATUS_OK, NKSTATUS_LONG or one of the NKSTATUS_E* errors.
+ */
+static inline uint8_t numkey_checked(const char *country, const char *number, size_t numsize, uint64_t *nk)
+{
+    uint8_t bad = 0;
+    size_t i = 0;
+    *nk = 0;
+    if (invalid_char(country[0]) || invalid_char(country[1]))
+    {
+        return NKSTATUS_ECOUNTRY;
+    }
+    if (numsize == 0)
+    {
+        return NKSTATUS_EEMPTY;
+    }
+    for (i = NKNUMMAXLEN; i < numsize; i++)
+    {
+        bad |= invalid_digit(number[i - NKNUMMAXLEN]); // leading digits dropped by the encoding
+    }
+#if defined(__SSE4_1__)
+    uint64_t len = 0;
+    __m128i v = load_number16_sse(number, numsize, &len);
+    bad |= (uint8_t)(_mm_movemask_epi8(_mm_or_si128(_mm_cmplt_epi8(v, _mm_set1_epi8('0')), _mm_cmpgt_epi8(v, _mm_set1_epi8('9')))) != 0);
+    if (bad)
+    {
+        return NKSTATUS_EDIGIT;
+    }
+    *nk = (encode_country(country) | (parse_digits16_sse(v) << NKBSHIFT_NUMBER) | len);
+#else
+    uint64_t num = 0;
+    uint8_t b = 0;
+    for (i = ((numsize > NKNUMMAXLEN) ? (numsize - NKNUMMAXLEN) : 0); i < numsize; i++)
+    {
+        b = (uint8_t)number[i] - '0';
+        bad |= (uint8_t)(b > 9);
+        num = (num * 10) + b;
+    }
+    if (bad)
+    {
+        return NKSTATUS_EDIGIT;
+    }
+    *nk = (encode_country(country) | (num << NKBSHIFT_NUMBER) | ((numsize > NKNUMMAXLEN) ? 0 : (uint64_t)numsize));
+#endif
+    return (numsize > NKNUMMAXLEN) ? NKSTATUS_LONG : NKSTATUS_OK;
+}
+
+/**
+ * Validate and encode an array of numkeys in a single pass.
+ * See numkey_checked().
+ *
+ * @param country Array of ISO 3166 alpha-2 country codes (uppercase).
+ * @param number  Array of strings containing the Short code or LVN number (digits only).
+ * @param numsize Array of number lengths (number of digits).
+ * @param nk      Pre-allocated output array of NumKey 64 bit codes (set to 0 in case of error).
+ * @param status  Pre-allocated output array of status codes (NKSTATUS_*).
+ * @param n       Number of elements to process.
+ *
+ * @return Number of elements with NKSTATUS_OK status.
+ */
+static inline size_t numkey_checked_batch(const char *const *country, const char *const *number, const size_t *numsize, uint64_t *nk, uint8_t *status, size_t n)
+{
+    size_t i = 0, nok = 0;
+    for (i = 0; i < n; i++)
+    {
+        status[i] = numkey_checked(country[i], number[i], numsize[i], &nk[i]);
+        nok += (status[i] == NKSTATUS_OK);
+    }
+    return nok;
+}
+
 /**
  * Decode a NumKey code to get the individual components.
  *
@@ -164,6 +573,78 @@ static inline void decode_numkey(uint64_t nk, numkey_t *data)
     decode_number(nk, data->number);
 }
 
+/**
+ * Returns the CountryKey (see countrykey.h) of the country encoded in a NumKey.
+ *
+ * @param nk    NumKey code.
+ *
+ * @return CountryKey 16 bit code.
+ */
+static inline uint16_t numkey_countrykey(uint64_t nk)
+{
+    return (uint16_t)(((((nk & NKBMASK_COUNTRY_FL) >> NKBSHIFT_COUNTRY_FL) + NKCSHIFT_CHAR) << 8) | (((nk & NKBMASK_COUNTRY_SL) >> NKBSHIFT_COUNTRY_SL) + NKCSHIFT_CHAR));
+}
+
+/**
+ * Decode an array of NumKey codes into caller-allocated columns (structure of arrays).
+ * Each number is written left-aligned in a fixed NKNUMSTRIDE bytes slot and NULL-padded,
+ * so every slot is also a valid NULL-terminated string.
+ *
+ * @param nk      Array of NumKey codes.
+ * @param n       Number of elements to process.
+ * @param country Output column of n CountryKey codes (see countrykey.h).
+ * @param length  Output column of n number lengths (number of digits).
+ * @param number  Output column of (n * NKNUMSTRIDE) bytes containing the number digits.
+ */
+static inline void decode_numkey_batch(const uint64_t *nk, size_t n, uint16_t *country, uint8_t *length, char *number)
+{
+    size_t i = 0;
+    uint8_t size = 0;
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    uint8_t pairs[8];
+    uint16_t dp[8];
+    uint64_t w[2];
+    uint8_t sh = 0;
+    for (i = 0; i < n; i++)
+    {
+        size = (uint8_t)(nk[i] & NKBMASK_LENGTH);
+        country[i] = numkey_countrykey(nk[i]);
+        length[i] = size;
+        split_digits16(((nk[i] & NKBMASK_NUMBER) >> NKBSHIFT_NUMBER), pairs);
+        for (sh = 0; sh < 8; sh++)
+        {
+            memcpy(&dp[sh], &nk_digit_pairs[2 * pairs[sh]], 2);
+        }
+        w[0] = ((uint64_t)dp[0] | ((uint64_t)dp[1] << 16) | ((uint64_t)dp[2] << 32) | ((uint64_t)dp[3] << 48));
+        w[1] = ((uint64_t)dp[4] | ((uint64_t)dp[5] << 16) | ((uint64_t)dp[6] << 32) | ((uint64_t)dp[7] << 48));
+        // shift the 16 digits right by (16 - size) characters: the number becomes left-aligned and NULL-padded
+        sh = (uint8_t)(8 * (16 - size));
+        if (sh >= 64)
+        {
+            w[0] = (sh < 128) ? (w[1] >> (sh - 64)) : 0;
+            w[1] = 0;
+        }
+        else
+        {
+            w[0] = ((w[0] >> sh) | (w[1] << (64 - sh)));
+            w[1] >>= sh;
+        }
+        memcpy(number, w, NKNUMSTRIDE);
+        number += NKNUMSTRIDE;
+    }
+#else
+    for (i = 0; i < n; i++)
+    {
+        size = (uint8_t)(nk[i] & NKBMASK_LENGTH);
+        country[i] = numkey_countrykey(nk[i]);
+        length[i] = size;
+        memset(number, 0, NKNUMSTRIDE);
+        write_digits(((nk[i] & NKBMASK_NUMBER) >> NKBSHIFT_NUMBER), size, number);
+        number += NKNUMSTRIDE;
+    }
+#endif
+}
+
 static inline int8_t compare_uint64_t(uint64_t a, uint64_t b)
 {
     return (a < b) ? -1 : (a > b); //NOLINT:bugprone-narrowing-conversions,cppcoreguidelines-narrowing-conversions
@@ -182,6 +663,191 @@ static inline int8_t compare_numkey_country(uint64_t nka, uint64_t nkb)
     return compare_uint64_t((nka >> NKBSHIFT_COUNTRY_SL), (nkb >> NKBSHIFT_COUNTRY_SL));
 }
 
+/**
+ * Returns a 64 bit hash of a NumKey with all bits depending on all input bits (MurmurHash3 fmix64 finalizer).
+ * The NumKey bits are not uniformly distributed (the LENGTH has few values and the COUNTRY is usually one of a handful),
+ * so the raw code should not be used directly as hash (e.g. nk % buckets).
+ *
+ * @param nk NumKey code.
+ *
+ * @return Hash value.
+ */
+static inline uint64_t numkey_hash(uint64_t nk)
+{
+    nk ^= (nk >> 33);
+    nk *= 0xff51afd7ed558ccd;
+    nk ^= (nk >> 33);
+    nk *= 0xc4ceb9fe1a85ec53;
+    nk ^= (nk >> 33);
+    return nk;
+}
+
+/**
+ * Powers of 10 from 10^0 to 10^15.
+ */
+static const uint64_t nk_pow10[16] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+    10000000000, 100000000000, 1000000000000, 10000000000000, 100000000000000, 1000000000000000,
+};
+
+/**
+ * Returns the [lo, hi] NumKey range containing all the numbers of the specified country.
+ * The COUNTRY is stored in the most significant bits, so every country is a contiguous range in a sorted NumKey column,
+ * and the bounds can be directly used with col_find_first_uint64_t and col_find_last_uint64_t.
+ *
+ * @param country ISO 3166 alpha-2 country code.
+ * @param lo      Lower bound (inclusive) to be returned.
+ * @param hi      Upper bound (inclusive) to be returned.
+ */
+static inline void numkey_country_range(const char *country, uint64_t *lo, uint64_t *hi)
+{
+    *lo = encode_country(country);
+    *hi = (*lo | NKBMASK_NUMBER | NKBMASK_LENGTH);
+}
+
+/**
+ * Returns the tightest [lo, hi] NumKey range containing all the numbers of the specified country and length.
+ * The keys are sorted by number value before length, so the range also contains the shorter numbers with the
+ * same value range (e.g. "5" is between "000" and "999"): the matching items must be filtered by the LENGTH bits.
+ *
+ * @param country ISO 3166 alpha-2 country code.
+ * @param numsize Length of the numbers (number of digits, 1 to 15, or 0 for the non-reversible numbers longer than 15 digits).
+ * @param lo      Lower bound (inclusive) to be returned.
+ * @param hi      Upper bound (inclusive) to be returned.
+ *
+ * @return False if the length is greater than NKNUMMAXLEN, true otherwise.
+ */
+static inline bool numkey_country_length_range(const char *country, size_t numsize, uint64_t *lo, uint64_t *hi)
+{
+    if (numsize > NKNUMMAXLEN)
+    {
+        return false;
+    }
+    uint64_t cc = encode_country(country);
+    uint64_t maxnum = (numsize == 0) ? (NKBMASK_NUMBER >> NKBSHIFT_NUMBER) : (nk_pow10[numsize] - 1);
+    *lo = (cc | (uint64_t)numsize);
+    *hi = (cc | (maxnum << NKBSHIFT_NUMBER) | (uint64_t)numsize);
+    return true;
+}
+
+/**
+ * Returns the tightest [lo, hi] NumKey range containing all the numbers of the specified country and length
+ * starting with the specified digits.
+ * As for numkey_country_length_range(), the range may also contain shorter numbers with leading zeros
+ * (e.g. "044" is between "440" and "449"): the matching items must be filtered by the LENGTH bits.
+ *
+ * @param country    ISO 3166 alpha-2 country code.
+ * @param prefix     String containing the leading digits of the numbers.
+ * @param prefixsize Length of the prefix (number of digits).
+ * @param numsize    Length of the numbers (number of digits, 1 to 15).
+ * @param lo         Lower bound (inclusive) to be returned.
+ * @param hi         Upper bound (inclusive) to be returned.
+ *
+ * @return False if the prefix is longer than the numbers or the length is invalid, true otherwise.
+ */
+static inline bool numkey_country_prefix_range(const char *country, const char *prefix, size_t prefixsize, size_t numsize, uint64_t *lo, uint64_t *hi)
+{
+    if ((numsize == 0) || (numsize > NKNUMMAXLEN) || (prefixsize > numsize))
+    {
+        return false;
+    }
+    uint64_t cc = encode_country(country);
+    uint64_t num = ((encode_number(prefix, prefixsize) & NKBMASK_NUMBER) >> NKBSHIFT_NUMBER);
+    uint64_t scale = nk_pow10[(numsize - prefixsize)];
+    *lo = (cc | ((num * scale) << NKBSHIFT_NUMBER) | (uint64_t)numsize);
+    *hi = (cc | ((((num + 1) * scale) - 1) << NKBSHIFT_NUMBER) | (uint64_t)numsize);
+    return true;
+}
+
+/**
+ * Encode numkey_lex: a NumKey variant with the number digits left-aligned (like the prefixkey).
+ * The number is stored as its first 15 digits right-padded with zeros, followed by the length,
+ * so the keys are sorted by country and then lexicographically by number (e.g. "44" < "440" < "4420" < "45"),
+ * and all the numbers starting with the same digits form a single contiguous range (see numkey_lex_prefix_range()).
+ * The code is fully reversible for numbers up to 15 digits; longer numbers keep their first 15 digits and length 0.
+ *
+ * @param country ISO 3166 alpha-2 country code.
+ * @param number  String containing the Short code or LVN number.
+ * @param numsize Length of the number (number of digits).
+ *
+ * @return NumKey lexicographic 64 bit code.
+ */
+static inline uint64_t numkey_lex(const char *country, const char *number, size_t numsize)
+{
+    uint64_t num = 0;
+    uint64_t len = (uint64_t)numsize;
+    size_t i = 0;
+    if (numsize > NKNUMMAXLEN)
+    {
+        numsize = NKNUMMAXLEN; // first 15 digits
+        len = 0;               // flag non-revesible encoding
+    }
+    for (i = 0; i < numsize; i++)
+    {
+        num = (num * 10) + (uint8_t)((uint8_t)number[i] - '0');
+    }
+    num *= nk_pow10[(NKNUMMAXLEN - numsize)]; // zero right-padding
+    return (encode_country(country) | (num << NKBSHIFT_NUMBER) | len);
+}
+
+/**
+ * Decode the numkey_lex number into string.
+ *
+ * @param nk       NumKey lexicographic code.
+ * @param number   Number string buffer to be returned.
+ *
+ * @return      Number length (number of digits).
+ */
+static inline size_t decode_number_lex(uint64_t nk, char *number)
+{
+    size_t size = (size_t)(nk & NKBMASK_LENGTH);
+    write_digits(((nk & NKBMASK_NUMBER) >> NKBSHIFT_NUMBER), NKNUMMAXLEN, number); // all 15 digits
+    number[size] = 0;
+    return size;
+}
+
+/**
+ * Decode a numkey_lex code and returns the components as numkey_t structure.
+ *
+ * @param nk    NumKey lexicographic code.
+ * @param data  Decoded numkey structure.
+ */
+static inline void decode_numkey_lex(uint64_t nk, numkey_t *data)
+{
+    decode_country(nk, data->country);
+    decode_number_lex(nk, data->number);
+}
+
+/**
+ * Returns the [lo, hi] numkey_lex range containing all the numbers of the specified country starting with the specified digits,
+ * regardless of their length.
+ * The bounds can be directly used with col_find_first_uint64_t and col_find_last_uint64_t on a sorted numkey_lex column.
+ * NOTE: The only non-reversible numbers (longer than 15 digits) left out are the ones made of the prefix followed by zeros
+ * up to the 15th digit, as their length 0 sorts them before the prefix itself.
+ *
+ * @param country    ISO 3166 alpha-2 country code.
+ * @param prefix     String containing the leading digits of the numbers.
+ * @param prefixsize Length of the prefix (number of digits, max 15).
+ * @param lo         Lower bound (inclusive) to be returned.
+ * @param hi         Upper bound (inclusive) to be returned.
+ *
+ * @return False if the prefix is longer than NKNUMMAXLEN, true otherwise.
+ */
+static inline bool numkey_lex_prefix_range(const char *country, const char *prefix, size_t prefixsize, uint64_t *lo, uint64_t *hi)
+{
+    if (prefixsize > NKNUMMAXLEN)
+    {
+        return false;
+    }
+    uint64_t cc = encode_country(country);
+    uint64_t num = ((encode_number(prefix, prefixsize) & NKBMASK_NUMBER) >> NKBSHIFT_NUMBER);
+    uint64_t scale = nk_pow10[(NKNUMMAXLEN - prefixsize)];
+    *lo = (cc | ((num * scale) << NKBSHIFT_NUMBER) | (uint64_t)prefixsize); // skip the shorter numbers ending with zeros
+    *hi = (cc | ((((num + 1) * scale) - 1) << NKBSHIFT_NUMBER) | NKBMASK_LENGTH);
+    return true;
+}
+
 /**
  * Returns NumKey hexadecimal string (16 characters).
  *
@@ -0,0 +1,281 @@
+// NumKey
+//
+// numkey.hpp
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file numkey.hpp
+ * @brief NumKey C++20 interface.
+ *
+ * Strongly typed wrappers for the NumKey, PrefixKey and CountryKey codes,
+ * constexpr encoders and field extractors (usable in static tables and switch statements),
+ * and std::span batch functions dispatching to the C kernels.
+ */
+
+#ifndef NUMKEY_NUMKEY_HPP
+#define NUMKEY_NUMKEY_HPP
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "binsearch.h"
+#include "countrykey.h"
+#include "numkey.h"
+#include "prefixkey.h"
+#include "set.h"
+
+namespace nk
+{
+
+/**
+ * NumKey 64 bit code (see numkey.h).
+ */
+class NumKey
+{
+public:
+    constexpr NumKey() noexcept = default;
+    constexpr explicit NumKey(uint64_t v) noexcept : v_(v) {}
+    constexpr uint64_t value() const noexcept { return v_; } //!< Raw 64 bit code.
+    constexpr auto operator<=>(const NumKey &) const noexcept = default;
+private:
+    uint64_t v_ = 0;
+};
+
+/**
+ * PrefixKey 64 bit code (see prefixkey.h).
+ */
+class PrefixKey
+{
+public:
+    constexpr PrefixKey() noexcept = default;
+    constexpr explicit PrefixKey(uint64_t v) noexcept : v_(v) {}
+    constexpr uint64_t value() const noexcept { return v_; } //!< Raw 64 bit code.
+    constexpr auto operator<=>(const PrefixKey &) const noexcept = default;
+private:
+    uint64_t v_ = 0;
+};
+
+/**
+ * CountryKey 16 bit code (see countrykey.h).
+ */
+class CountryKey
+{
+public:
+    constexpr CountryKey() noexcept = default;
+    constexpr explicit CountryKey(uint16_t v) noexcept : v_(v) {}
+    constexpr uint16_t value() const noexcept { return v_; } //!< Raw 16 bit code.
+    constexpr auto operator<=>(const CountryKey &) const noexcept = default;
+private:
+    uint16_t v_ = 0;
+};
+
+// The strong types have the same layout of the raw codes, so spans of keys are passed as-is to the C kernels.
+static_assert((sizeof(NumKey) == sizeof(uint64_t)) && std::is_standard_layout_v<NumKey> && std::is_trivially_copyable_v<NumKey>);
+static_assert((sizeof(PrefixKey) == sizeof(uint64_t)) && std::is_standard_layout_v<PrefixKey> && std::is_trivially_copyable_v<PrefixKey>);
+static_assert((sizeof(CountryKey) == sizeof(uint16_t)) && std::is_standard_layout_v<CountryKey> && std::is_trivially_copyable_v<CountryKey>);
+
+/**
+ * Encode numkey (constexpr version of numkey()).
+ *
+ * @param country ISO 3166 alpha-2 country code.
+ * @param number  Short code or E.164 LVN number (only the last 15 digits are encoded for longer numbers).
+ *
+ * @return NumKey code.
+ */
+constexpr NumKey make_numkey(std::string_view country, std::string_view number) noexcept
+{
+    uint64_t num = 0;
+    uint64_t len = number.size();
+    std::size_t i = 0;
+    if (number.size() > NKNUMMAXLEN)
+    {
+        i = (number.size() - NKNUMMAXLEN); // last 15 digits
+        len = 0;                           // flag non-revesible encoding
+    }
+    for (; i < number.size(); i++)
+    {
+        num = (num * 10) + static_cast<uint8_t>(number[i] - '0');
+    }
+    return NumKey((static_cast<uint64_t>(country[0] - NKCSHIFT_CHAR) << NKBSHIFT_COUNTRY_FL)
+                  | (static_cast<uint64_t>(country[1] - NKCSHIFT_CHAR) << NKBSHIFT_COUNTRY_SL)
+                  | (num << NKBSHIFT_NUMBER) | (len & NKBMASK_LENGTH));
+}
+
+/**
+ * Encode prefixkey (constexpr version of prefixkey()).
+ *
+ * @param number E.164 number or prefix (max 15 digits or it will be truncated).
+ *
+ * @return PrefixKey code.
+ */
+constexpr PrefixKey make_prefixkey(std::string_view number) noexcept
+{
+    uint64_t num = 0;
+    std::size_t i = 0;
+    for (i = 0; i < PKNUMMAXLEN; i++)
+    {
+        num = (num * 10) + ((i < number.size()) ? static_cast<uint8_t>(number[i] - '0') : 0);
+    }
+    return PrefixKey(num);
+}
+
+/**
+ * Encode countrykey (constexpr version of countrykey()).
+ *
+ * @param country ISO 3166 alpha-2 country code.
+ *
+ * @return CountryKey code.
+ */
+constexpr CountryKey make_countrykey(std::string_view country) noexcept
+{
+    return CountryKey(static_cast<uint16_t>((static_cast<uint8_t>(country[0]) << 8) | static_cast<uint8_t>(country[1])));
+}
+
+/**
+ * Returns the country of a NumKey as CountryKey (constexpr version of numkey_countrykey()).
+ */
+constexpr CountryKey country(NumKey nk) noexcept
+{
+    return CountryKey(static_cast<uint16_t>(((((nk.value() & NKBMASK_COUNTRY_FL) >> NKBSHIFT_COUNTRY_FL) + NKCSHIFT_CHAR) << 8)
+                                            | (((nk.value() & NKBMASK_COUNTRY_SL) >> NKBSHIFT_COUNTRY_SL) + NKCSHIFT_CHAR)));
+}
+
+/**
+ * Returns the NUMBER field value of a NumKey.
+ */
+constexpr uint64_t number(NumKey nk) noexcept
+{
+    return ((nk.value() & NKBMASK_NUMBER) >> NKBSHIFT_NUMBER);
+}
+
+/**
+ * Returns the LENGTH field of a NumKey (0 for non-reversible numbers longer than 15 digits).
+ */
+constexpr uint8_t length(NumKey nk) noexcept
+{
+    return static_cast<uint8_t>(nk.value() & NKBMASK_LENGTH);
+}
+
+/**
+ * Returns the ISO 3166 alpha-2 country code of a CountryKey as NULL terminated string.
+ */
+constexpr std::array<char, NKSLENGTH_COUNTRY> country_code(CountryKey ck) noexcept
+{
+    return {static_cast<char>(ck.value() >> 8), static_cast<char>(ck.value() & 0xFF), 0};
+}
+
+/**
+ * Returns the NUMBER of a NumKey as NULL terminated string.
+ */
+constexpr std::array<char, NKSLENGTH_NUMBER> number_string(NumKey nk) noexcept
+{
+    std::array<char, NKSLENGTH_NUMBER> str{};
+    uint64_t num = number(nk);
+    for (std::size_t i = length(nk); i > 0; i--)
+    {
+        str[(i - 1)] = static_cast<char>('0' + (num % 10));
+        num /= 10;
+    }
+    return str;
+}
+
+/**
+ * Returns the [lo, hi] NumKey range of a country (see numkey_country_range()).
+ */
+constexpr std::pair<NumKey, NumKey> country_range(std::string_view country) noexcept
+{
+    const NumKey lo = make_numkey(country, "");
+    return {lo, NumKey(lo.value() | NKBMASK_NUMBER | NKBMASK_LENGTH)};
+}
+
+/**
+ * Encode a batch of numbers with the SIMD kernel (see numkey_batch()).
+ * The number of processed items is the size of the smallest span.
+ */
+inline std::size_t encode(std::span<const char *const> country, std::span<const char *const> number, std::span<const std::size_t> numsize, std::span<NumKey> nk) noexcept
+{
+    const std::size_t n = std::min({country.size(), number.size(), numsize.size(), nk.size()});
+    numkey_batch(country.data(), number.data(), numsize.data(), reinterpret_cast<uint64_t *>(nk.data()), n);
+    return n;
+}
+
+/**
+ * Decode a batch of NumKeys into structure-of-arrays columns (see decode_numkey_batch()).
+ * The number column must contain NKNUMSTRIDE bytes per key.
+ * The number of processed items is limited by the size of the smallest output column.
+ */
+inline std::size_t decode(std::span<const NumKey> nk, std::span<CountryKey> country, std::span<uint8_t> length, std::span<char> number) noexcept
+{
+    const std::size_t n = std::min({nk.size(), country.size(), length.size(), (number.size() / NKNUMSTRIDE)});
+    decode_numkey_batch(reinterpret_cast<const uint64_t *>(nk.data()), n, reinterpret_cast<uint16_t *>(country.data()), length.data(), number.data());
+    return n;
+}
+
+/**
+ * Sorts in ascending order a span of keys with the radix sort (see sort_uint64_t()).
+ * Returns the number of sorted keys: keys.size(), or 0 (keys unchanged) if the temporary span
+ * is smaller than the keys span or the keys span has more than UINT32_MAX items.
+ */
+template <typename K> requires (std::is_same_v<K, NumKey> || std::is_same_v<K, PrefixKey>)
+inline std::size_t sort(std::span<K> keys, std::span<K> tmp) noexcept
+{
+    if ((tmp.size() < keys.size()) || (keys.size() > UINT32_MAX))
+    {
+        return 0;
+    }
+    sort_uint64_t(reinterpret_cast<uint64_t *>(keys.data()), reinterpret_cast<uint64_t *>(tmp.data()), static_cast<uint32_t>(keys.size()));
+    return keys.size();
+}
+
+/**
+ * Returns the position of the first key equal to the search key in a sorted span (see col_find_first_uint64_t()).
+ */
+template <typename K> requires (std::is_same_v<K, NumKey> || std::is_same_v<K, PrefixKey>)
+inline std::optional<std::size_t> find_first(std::span<const K> keys, K search) noexcept
+{
+    if (keys.empty() || (search < keys.front()) || (search > keys.back()))
+    {
+        return std::nullopt; // the C search may read one item outside the range in these cases
+    }
+    uint64_t first = 0, last = keys.size();
+    uint64_t pos = col_find_first_uint64_t(reinterpret_cast<const uint64_t *>(keys.data()), &first, &last, search.value());
+    if (pos >= keys.size())
+    {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(pos);
+}
+
+/**
+ * Returns the position of the last key equal to the search key in a sorted span (see col_find_last_uint64_t()).
+ */
+template <typename K> requires (std::is_same_v<K, NumKey> || std::is_same_v<K, PrefixKey>)
+inline std::optional<std::size_t> find_last(std::span<const K> keys, K search) noexcept
+{
+    if (keys.empty() || (search < keys.front()) || (search > keys.back()))
+    {
+        return std::nullopt; // the C search may read one item outside the range in these cases
+    }
+    uint64_t first = 0, last = keys.size();
+    uint64_t pos = col_find_last_uint64_t(reinterpret_cast<const uint64_t *>(keys.data()), &first, &last, search.value());
+    if (pos >= keys.size())
+    {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(pos);
+}
+
+} // namespace nk
+
+#endif  // NUMKEY_NUMKEY_HPP
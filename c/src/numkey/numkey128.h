@@ -0,0 +1,247 @@
+// NumKey
+//
+// numkey128.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file numkey128.h
+ * @brief NumKey128 functions.
+ *
+ * The functions provided here allows to generate and process a 128 bit Unsigned Integer Keys for
+ * Short Codes, E.164 LVN numbers and longer numeric identifiers (up to 31 digits).
+ * The NumKey128 has the same sorting order of the NumKey (country, number, length) and it is fully reversible.
+ *
+ * The 128 bit key is split in two 64 bit words:
+ *
+ *   - hi: [ 5 bit COUNTRY first letter | 5 bit COUNTRY second letter | 54 bit NUMBER (most significant bits) ]
+ *   - lo: [ 59 bit NUMBER (least significant bits) | 5 bit LENGTH ]
+ *
+ * The COUNTRY bits are in the same position of the NumKey ones.
+ */
+
+#ifndef NUMKEY_NUMKEY128_H
+#define NUMKEY_NUMKEY128_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "numkey.h"
+
+#define NK128BMASK_NUMBER_HI 0x003FFFFFFFFFFFFF //!< Bit mask for the most significant bits of the number in the high word.
+#define NK128BMASK_NUMBER_LO 0xFFFFFFFFFFFFFFE0 //!< Bit mask for the least significant bits of the number in the low word.
+#define NK128BMASK_LENGTH    0x000000000000001F //!< Bit mask for the number length in the low word.
+
+#define NK128BSHIFT_NUMBER    5 //!< NUMBER LSB position from the low word LSB.
+
+#define NK128SLENGTH_NUMBER  32 //!< Number of characters in the number code + NULL terminator.
+
+#define NK128NUMMAXLEN       31 //!< Maximum number length for key reversibility.
+
+/**
+ * NumKey128 code.
+ * The low word is stored first, so an array of numkey128_t has the same memory layout
+ * of the 128 bit arrays processed by sort_uint128_t() and col_find_first_uint128_t().
+ */
+typedef struct numkey128_t
+{
+    uint64_t lo; //!< Low 64 bits: NUMBER least significant bits and LENGTH.
+    uint64_t hi; //!< High 64 bits: COUNTRY and NUMBER most significant bits.
+} numkey128_t;
+
+/**
+ * NumKey128 decoded struct.
+ * Contains the NumKey128 components (COUNTRY, NUMBER).
+ */
+typedef struct numkey128_data_t
+{
+    char country[NKSLENGTH_COUNTRY];  //!< ISO 3166 alpha-2 country code.
+    char number[NK128SLENGTH_NUMBER]; //!< Short code, E.164 number or numeric identifier (max 31 digits).
+} numkey128_data_t;
+
+/**
+ * Divides in place an unsigned 128 bit integer by a 32 bit divisor using 32 bit limbs.
+ * When inlined with a constant divisor the limb divisions are replaced by multiplications.
+ *
+ * @param hi High 64 bits of the dividend, replaced by the quotient.
+ * @param lo Low 64 bits of the dividend, replaced by the quotient.
+ * @param d  Divisor.
+ *
+ * @return Remainder.
+ */
+static inline uint32_t divrem_uint128_u32(uint64_t *hi, uint64_t *lo, uint32_t d)
+{
+    uint64_t cur = (*hi >> 32);
+    uint64_t q3 = (cur / d);
+    cur = ((cur % d) << 32) | (*hi & 0xFFFFFFFF);
+    uint64_t q2 = (cur / d);
+    cur = ((cur % d) << 32) | (*lo >> 32);
+    uint64_t q1 = (cur / d);
+    cur = ((cur % d) << 32) | (*lo & 0xFFFFFFFF);
+    uint64_t q0 = (cur / d);
+    *hi = ((q3 << 32) | q2);
+    *lo = ((q1 << 32) | q0);
+    return (uint32_t)(cur % d);
+}
+
+/**
+ * Encode number string into the NUMBER and LENGTH fields of a NumKey128.
+ * The digits are accumulated in two 64 bit chunks (at most 18 digits each) combined with a single 64x64 bit multiplication.
+ *
+ * @param number String containing the number (max 31 digits, only the last 31 digits are encoded for longer numbers).
+ * @param size   Length of the number (number of digits).
+ *
+ * @return Encoded number and length (the COUNTRY bits are set to zero).
+ */
+static inline numkey128_t encode_number128(const char *number, size_t size)
+{
+    numkey128_t nk;
+    uint64_t a = 0, b = 0;
+    uint64_t len = (uint64_t)size;
+    size_t i = 0, j = 0;
+    if (size > NK128NUMMAXLEN)
+    {
+        j = (size - NK128NUMMAXLEN); // last 31 digits
+        len = 0;                     // flag non-revesible encoding
+    }
+    size_t split = ((size - j) > 18) ? (size - 18) : j;
+    for (i = j; i < split; i++)
+    {
+        a = (a * 10) + (uint8_t)((uint8_t)number[i] - '0');
+    }
+    for (i = split; i < size; i++)
+    {
+        b = (b * 10) + (uint8_t)((uint8_t)number[i] - '0');
+    }
+    // value = a * 10^18 + b
+    uint64_t lo = (a * 1000000000000000000);
+    uint64_t hi = mulhi64(a, 1000000000000000000);
+    lo += b;
+    hi += (lo < b); // carry
+    nk.hi = ((hi << NK128BSHIFT_NUMBER) | (lo >> (64 - NK128BSHIFT_NUMBER)));
+    nk.lo = ((lo << NK128BSHIFT_NUMBER) | (len & NK128BMASK_LENGTH));
+    return nk;
+}
+
+/**
+ * Encode numkey128.
+ *
+ * @param country ISO 3166 alpha-2 country code.
+ * @param number  String containing the Short code, LVN number or numeric identifier.
+ * @param numsize Length of the number (number of digits).
+ *
+ * @return NumKey128 code.
+ */
+static inline numkey128_t numkey128(const char *country, const char *number, size_t numsize)
+{
+    numkey128_t nk = encode_number128(number, numsize);
+    nk.hi |= encode_country(country);
+    return nk;
+}
+
+/**
+ * Convert a NumKey into a NumKey128 with the same country, number and length.
+ *
+ * @param nk NumKey code.
+ *
+ * @return NumKey128 code.
+ */
+static inline numkey128_t numkey128_from_numkey(uint64_t nk)
+{
+    numkey128_t nk128;
+    nk128.hi = (nk & (NKBMASK_COUNTRY_FL | NKBMASK_COUNTRY_SL));
+    nk128.lo = ((((nk & NKBMASK_NUMBER) >> NKBSHIFT_NUMBER) << NK128BSHIFT_NUMBER) | (nk & NKBMASK_LENGTH));
+    return nk128;
+}
+
+/**
+ * Decode the NumKey128 number into string.
+ * The 104 bit value is split in 8 digit chunks with two limb divisions by 10^8,
+ * then each chunk is written with the division-free digit-pair writer of the NumKey.
+ *
+ * @param nk       NumKey128.
+ * @param number   Number string buffer to be returned (it must be sized NK128SLENGTH_NUMBER bytes at least).
+ *
+ * @return      Number length (number of digits).
+ */
+static inline size_t decode_number128(numkey128_t nk, char *number)
+{
+    size_t size = (size_t)(nk.lo & NK128BMASK_LENGTH);
+    uint64_t hi = ((nk.hi & NK128BMASK_NUMBER_HI) >> NK128BSHIFT_NUMBER);
+    uint64_t lo = ((nk.lo >> NK128BSHIFT_NUMBER) | (nk.hi << (64 - NK128BSHIFT_NUMBER)));
+    uint32_t chunk[2];
+    size_t i = 0, k = 0, pos = size;
+    chunk[0] = divrem_uint128_u32(&hi, &lo, 100000000); // last 8 digits
+    chunk[1] = divrem_uint128_u32(&hi, &lo, 100000000); // previous 8 digits, lo < 10^15 is left
+    for (i = 0; (i < 2) && (pos > 0); i++)
+    {
+        k = (pos > 8) ? 8 : pos;
+        pos -= k;
+        write_digits(chunk[i], k, number + pos);
+    }
+    write_digits(lo, pos, number);
+    number[size] = 0;
+    return size;
+}
+
+/**
+ * Decode a NumKey128 code and returns the components as numkey128_data_t structure.
+ *
+ * @param nk    NumKey128 code.
+ * @param data  Decoded numkey128 structure.
+ */
+static inline void decode_numkey128(numkey128_t nk, numkey128_data_t *data)
+{
+    decode_country(nk.hi, data->country);
+    decode_number128(nk, data->number);
+}
+
+/**
+ * Compares two NumKey128 codes.
+ *
+ * @param a The first NumKey128 to be compared.
+ * @param b The second NumKey128 to be compared.
+ *
+ * @return -1 if the first key is smaller than the second, 0 if they are equal and 1 if the first is greater than the second.
+ */
+static inline int8_t compare_numkey128(numkey128_t a, numkey128_t b)
+{
+    if (a.hi != b.hi)
+    {
+        return compare_uint64_t(a.hi, b.hi);
+    }
+    return compare_uint64_t(a.lo, b.lo);
+}
+
+/**
+ * Returns NumKey128 hexadecimal string (32 characters).
+ *
+ * @param nk    NumKey128 code.
+ * @param str   String buffer to be returned (it must be sized 33 bytes at least).
+ *
+ * @return      Upon successful return, these function returns the number of characters processed
+ *              (excluding the null byte used to end output to strings).
+ */
+static inline size_t numkey128_hex(numkey128_t nk, char *str)
+{
+    return (hex_uint64_t(nk.hi, str) + hex_uint64_t(nk.lo, str + 16));
+}
+
+/**
+ * Parses a NumKey128 hexadecimal string and returns the code.
+ *
+ * @param ns NumKey128 hexadecimal string (it must contain 32 hexadecimal characters).
+ *
+ * @return A NumKey128 code.
+ */
+static inline numkey128_t parse_numkey128_hex(const char *ns)
+{
+    numkey128_t nk;
+    nk.hi = parse_hex_uint64_t(ns);
+    nk.lo = parse_hex_uint64_t(ns + 16);
+    return nk;
+}
+
+#endif  // NUMKEY_NUMKEY128_H
@@ -0,0 +1,321 @@
+// NumKey
+//
+// numkey_filter.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file numkey_filter.h
+ * @brief Static xor filter for NumKey sets.
+ *
+ * The functions provided here allows to build offline a xor filter (Graf and Lemire)
+ * to quickly reject the NumKey codes that are not part of a static set before searching them in a sorted column.
+ * Each key is mapped to 3 fingerprints (one for each third of the array) whose XOR is the key fingerprint,
+ * so any lookup reads exactly 3 array items. The filter has no false negatives and a false positive rate
+ * of about 1/256 with 8 bit fingerprints and 1/65536 with 16 bit fingerprints, using 1.23 fingerprints per key.
+ *
+ * The filter is serialized as a single blob that can be saved next to the data file,
+ * memory-mapped (e.g. with mmap_binfile) and used directly with numkey_filter_load, without any parsing or allocation:
+ *
+ *   - header (NKFILTER_HEADER_WORDS uint64_t): magic "NKXORF1", seed, nkeys, blocklength, fpbits;
+ *   - fingerprints (3 * blocklength items of fpbits bits), padded to a multiple of 8 bytes.
+ */
+
+#ifndef NUMKEY_NUMKEY_FILTER_H
+#define NUMKEY_NUMKEY_FILTER_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "numkey.h"
+
+#define NKFILTER_MAGIC        0x003146524f584b4e //!< Magic number "NKXORF1" in LE.
+#define NKFILTER_HEADER_WORDS 5                  //!< Number of uint64_t words in the header.
+#define NKFILTER_MAXTRIES     100                //!< Maximum number of build attempts with different seeds.
+#define NKFILTER_SEED         0x726b2b9d438b9d4d //!< Initial hash seed.
+#define NKFILTER_BATCH        16                 //!< Number of keys hashed and prefetched at once by numkey_filter_contains.
+
+/**
+ * Read-only view of a serialized xor filter.
+ */
+typedef struct numkey_filter_t
+{
+    const uint8_t *fp8;   //!< 8 bit fingerprints (NULL if fpbits is 16).
+    const uint16_t *fp16; //!< 16 bit fingerprints (NULL if fpbits is 8).
+    uint64_t seed;        //!< Hash seed.
+    uint64_t nkeys;       //!< Number of keys in the set.
+    uint64_t blocklength; //!< Number of fingerprints in each of the 3 blocks.
+    uint8_t fpbits;       //!< Number of bits per fingerprint (8 or 16).
+} numkey_filter_t;
+
+/**
+ * Returns the seeded hash of a NumKey.
+ */
+static inline uint64_t numkey_filter_hash(uint64_t nk, uint64_t seed)
+{
+    return numkey_hash(nk + seed);
+}
+
+/**
+ * Returns the fingerprint of a key hash (to be truncated to the fingerprint size).
+ */
+static inline uint64_t numkey_filter_fingerprint(uint64_t h)
+{
+    return (h ^ (h >> 32));
+}
+
+/**
+ * Returns the position of a key hash in the specified block (0, 1 or 2).
+ */
+static inline uint64_t numkey_filter_pos(uint64_t h, uint8_t block, uint64_t blocklength)
+{
+    uint64_t r = (block == 0) ? h : ((h << (21 * block)) | (h >> (64 - (21 * block)))); // rotate left
+    return ((((r & 0xFFFFFFFF) * blocklength) >> 32) + (block * blocklength)); // multiply-shift range reduction
+}
+
+/**
+ * Returns true if the key hash matches the filter fingerprints.
+ */
+static inline bool numkey_filter_match(const numkey_filter_t *f, uint64_t h)
+{
+    uint64_t p0 = numkey_filter_pos(h, 0, f->blocklength);
+    uint64_t p1 = numkey_filter_pos(h, 1, f->blocklength);
+    uint64_t p2 = numkey_filter_pos(h, 2, f->blocklength);
+    if (f->fp8 != NULL)
+    {
+        return ((uint8_t)numkey_filter_fingerprint(h) == (uint8_t)(f->fp8[p0] ^ f->fp8[p1] ^ f->fp8[p2]));
+    }
+    return ((uint16_t)numkey_filter_fingerprint(h) == (uint16_t)(f->fp16[p0] ^ f->fp16[p1] ^ f->fp16[p2]));
+}
+
+/**
+ * Initialize a xor filter view from a serialized blob (e.g. a memory-mapped file).
+ * The blob is not copied and it must be kept valid while the view is used.
+ *
+ * @param src  Address of the serialized blob (8-byte aligned).
+ * @param size Size of the blob in bytes.
+ * @param f    View to initialize.
+ *
+ * @return False if the blob is not a valid serialized xor filter, true otherwise.
+ */
+static inline bool numkey_filter_load(const uint8_t *src, uint64_t size, numkey_filter_t *f)
+{
+    const uint64_t *p = (const uint64_t *)src;
+    if ((size < (NKFILTER_HEADER_WORDS * sizeof(uint64_t))) || (p[0] != NKFILTER_MAGIC) || ((p[4] != 8) && (p[4] != 16)))
+    {
+        return false;
+    }
+    f->seed = p[1];
+    f->nkeys = p[2];
+    f->blocklength = p[3];
+    f->fpbits = (uint8_t)p[4];
+    if (((size - (NKFILTER_HEADER_WORDS * sizeof(uint64_t))) / (f->fpbits / 8)) < (3 * f->blocklength))
+    {
+        return false;
+    }
+    src += (NKFILTER_HEADER_WORDS * sizeof(uint64_t));
+    f->fp8 = (f->fpbits == 8) ? src : NULL;
+    f->fp16 = (f->fpbits == 16) ? (const uint16_t *)src : NULL;
+    return true;
+}
+
+/**
+ * Returns true if the key may be in the set, false if it is certainly not in the set.
+ *
+ * @param f  Xor filter view.
+ * @param nk NumKey to check.
+ *
+ * @return False if the key is not in the set, true if it is in the set (or it is a false positive).
+ */
+static inline bool numkey_filter_has(const numkey_filter_t *f, uint64_t nk)
+{
+    return ((f->nkeys > 0) && numkey_filter_match(f, numkey_filter_hash(nk, f->seed)));
+}
+
+/**
+ * Check a batch of keys against the filter.
+ * The keys are processed in groups of NKFILTER_BATCH: all the fingerprint locations of a group are prefetched
+ * before they are compared, so the cache misses of independent keys overlap.
+ *
+ * @param f     Xor filter view.
+ * @param nk    Array of NumKeys to check.
+ * @param n     Number of keys.
+ * @param found Array of n results (see numkey_filter_has).
+ *
+ * @return Number of keys that may be in the set.
+ */
+static inline uint64_t numkey_filter_contains(const numkey_filter_t *f, const uint64_t *nk, uint64_t n, bool *found)
+{
+    uint64_t h[NKFILTER_BATCH];
+    uint64_t i = 0, j = 0, m = 0, count = 0;
+    if (f->nkeys == 0)
+    {
+        memset(found, 0, (n * sizeof(bool)));
+        return 0;
+    }
+    for (i = 0; i < n; i += NKFILTER_BATCH)
+    {
+        m = ((n - i) < NKFILTER_BATCH) ? (n - i) : NKFILTER_BATCH;
+        for (j = 0; j < m; j++)
+        {
+            h[j] = numkey_filter_hash(nk[(i + j)], f->seed);
+#if defined(__GNUC__)
+            const uint8_t *fp = (f->fp8 != NULL) ? f->fp8 : (const uint8_t *)f->fp16;
+            uint8_t shift = (f->fpbits >> 4);
+            __builtin_prefetch(fp + (numkey_filter_pos(h[j], 0, f->blocklength) << shift));
+            __builtin_prefetch(fp + (numkey_filter_pos(h[j], 1, f->blocklength) << shift));
+            __builtin_prefetch(fp + (numkey_filter_pos(h[j], 2, f->blocklength) << shift));
+#endif
+        }
+        for (j = 0; j < m; j++)
+        {
+            found[(i + j)] = numkey_filter_match(f, h[j]);
+            count += found[(i + j)];
+        }
+    }
+    return count;
+}
+
+/**
+ * Build and serialize a xor filter for a sorted array of NumKey codes (duplicated keys are ignored).
+ * This function is meant to be used offline: it allocates memory proportional to the number of keys.
+ *
+ * @param keys   Sorted array of NumKey codes (e.g. processed with sort_uint64_t).
+ * @param nkeys  Number of keys.
+ * @param fpbits Number of bits per fingerprint: 8 or 16.
+ * @param size   Pointer to the size in bytes of the returned blob.
+ *
+ * @return Serialized blob allocated with malloc (to be freed by the caller),
+ *         or NULL in case of invalid fpbits, memory allocation failure or build failure.
+ */
+static inline uint8_t *numkey_filter_build(const uint64_t *keys, uint64_t nkeys, uint8_t fpbits, uint64_t *size)
+{
+    if ((fpbits != 8) && (fpbits != 16))
+    {
+        return NULL;
+    }
+    uint64_t blocklength = ((32 + ((123 * nkeys) / 100)) / 3) + 1;
+    uint64_t capacity = (3 * blocklength);
+    uint64_t fpbytes = (((capacity * (fpbits / 8)) + 7) & ~(uint64_t)7);
+    *size = ((NKFILTER_HEADER_WORDS * sizeof(uint64_t)) + fpbytes);
+    uint8_t *blob = (uint8_t *)calloc(*size, 1);
+    uint64_t *xormask = (uint64_t *)malloc(capacity * sizeof(uint64_t));
+    uint32_t *count = (uint32_t *)malloc(capacity * sizeof(uint32_t));
+    uint64_t *queue = (uint64_t *)malloc(capacity * sizeof(uint64_t));
+    uint64_t *stack = (uint64_t *)malloc(((nkeys > 0) ? nkeys : 1) * 2 * sizeof(uint64_t)); // (hash, position) pairs
+    uint64_t seed = NKFILTER_SEED, h = 0, i = 0, p = 0, nq = 0, ns = 0, nunique = 0;
+    uint8_t b = 0, tries = 0;
+    if ((blob == NULL) || (xormask == NULL) || (count == NULL) || (queue == NULL) || (stack == NULL))
+    {
+        free(blob);
+        free(xormask);
+        free(count);
+        free(queue);
+        free(stack);
+        return NULL;
+    }
+    for (tries = 0; tries < NKFILTER_MAXTRIES; tries++)
+    {
+        memset(xormask, 0, (capacity * sizeof(uint64_t)));
+        memset(count, 0, (capacity * sizeof(uint32_t)));
+        nunique = 0;
+        for (i = 0; i < nkeys; i++)
+        {
+            if ((i > 0) && (keys[i] == keys[(i - 1)]))
+            {
+                continue;
+            }
+            nunique++;
+            h = numkey_filter_hash(keys[i], seed);
+            for (b = 0; b < 3; b++)
+            {
+                p = numkey_filter_pos(h, b, blocklength);
+                xormask[p] ^= h;
+                count[p]++;
+            }
+        }
+        // peel the positions referenced by a single key
+        nq = 0;
+        for (i = 0; i < capacity; i++)
+        {
+            if (count[i] == 1)
+            {
+                queue[nq++] = i;
+            }
+        }
+        ns = 0;
+        while (nq > 0)
+        {
+            i = queue[--nq];
+            if (count[i] != 1)
+            {
+                continue;
+            }
+            h = xormask[i];
+            stack[(2 * ns)] = h;
+            stack[((2 * ns) + 1)] = i;
+            ns++;
+            for (b = 0; b < 3; b++)
+            {
+                p = numkey_filter_pos(h, b, blocklength);
+                xormask[p] ^= h;
+                if (--count[p] == 1)
+                {
+                    queue[nq++] = p;
+                }
+            }
+        }
+        if (ns == nunique)
+        {
+            break;
+        }
+        seed = numkey_hash(seed + NKFILTER_SEED);
+    }
+    free(xormask);
+    free(count);
+    free(queue);
+    if (ns != nunique)
+    {
+        free(blob);
+        free(stack);
+        return NULL;
+    }
+    uint64_t *hdr = (uint64_t *)blob;
+    hdr[0] = NKFILTER_MAGIC;
+    hdr[1] = seed;
+    hdr[2] = nunique;
+    hdr[3] = blocklength;
+    hdr[4] = fpbits;
+    uint8_t *fp8 = (blob + (NKFILTER_HEADER_WORDS * sizeof(uint64_t)));
+    uint16_t *fp16 = (uint16_t *)fp8;
+    uint64_t p0 = 0, p1 = 0, p2 = 0;
+    // assign the fingerprints in reverse peeling order, so each key owns a position not used by the following ones
+    while (ns > 0)
+    {
+        ns--;
+        h = stack[(2 * ns)];
+        i = stack[((2 * ns) + 1)];
+        p0 = numkey_filter_pos(h, 0, blocklength);
+        p1 = numkey_filter_pos(h, 1, blocklength);
+        p2 = numkey_filter_pos(h, 2, blocklength);
+        if (fpbits == 8)
+        {
+            fp8[i] = 0;
+            fp8[i] = (uint8_t)(numkey_filter_fingerprint(h) ^ fp8[p0] ^ fp8[p1] ^ fp8[p2]);
+        }
+        else
+        {
+            fp16[i] = 0;
+            fp16[i] = (uint16_t)(numkey_filter_fingerprint(h) ^ fp16[p0] ^ fp16[p1] ^ fp16[p2]);
+        }
+    }
+    free(stack);
+    return blob;
+}
+
+#endif  // NUMKEY_NUMKEY_FILTER_H
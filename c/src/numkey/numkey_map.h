@@ -0,0 +1,341 @@
+// NumKey
+//
+// numkey_map.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file numkey_map.h
+ * @brief Open-addressing hash map keyed by NumKey.
+ *
+ * The functions provided here allows to map NumKey codes to fixed-size 64 bit values in O(1).
+ * The map uses open addressing with one control byte per slot (SwissTable layout):
+ * the control bytes of 16 consecutive slots are compared at once with SSE2 instructions
+ * against the 7 bit tag of the key hash, so most lookups read a single key.
+ */
+
+#ifndef NUMKEY_NUMKEY_MAP_H
+#define NUMKEY_NUMKEY_MAP_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "numkey.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define NKMAP_GROUP          16 //!< Number of slots probed at once (one SSE2 register of control bytes).
+#define NKMAP_MINCAPACITY    16 //!< Minimum number of slots.
+#define NKMAP_CTRL_EMPTY   0x80 //!< Control byte of an empty slot.
+#define NKMAP_CTRL_DELETED 0xFE //!< Control byte of a deleted slot (tombstone).
+#define NKMAP_H2MASK       0x7F //!< Mask of the 7 bit hash tag stored in the control byte of a full slot.
+
+/**
+ * NumKey hash map.
+ */
+typedef struct numkey_map_t
+{
+    uint8_t *ctrl;     //!< Control bytes: capacity + NKMAP_GROUP (the first group is cloned at the end).
+    uint64_t *keys;    //!< NumKey of each slot.
+    uint64_t *values;  //!< Value of each slot.
+    uint64_t capacity; //!< Number of slots (power of 2).
+    uint64_t size;     //!< Number of stored keys.
+    uint64_t used;     //!< Number of non-empty slots (stored keys + tombstones).
+} numkey_map_t;
+
+/**
+ * Returns a bitmask with one bit set for every control byte of the group equal to the specified value.
+ *
+ * @param ctrl Pointer to the first control byte of the group.
+ * @param v    Control byte value to match.
+ *
+ * @return 16 bit mask.
+ */
+static inline uint32_t numkey_map_match(const uint8_t *ctrl, uint8_t v)
+{
+#if defined(__SSE2__)
+    __m128i g = _mm_loadu_si128((const __m128i *)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)v)));
+#else
+    uint32_t m = 0, i = 0;
+    for (i = 0; i < NKMAP_GROUP; i++)
+    {
+        m |= ((uint32_t)(ctrl[i] == v) << i);
+    }
+    return m;
+#endif
+}
+
+/**
+ * Returns a bitmask with one bit set for every empty or deleted slot of the group (control byte MSB set).
+ *
+ * @param ctrl Pointer to the first control byte of the group.
+ *
+ * @return 16 bit mask.
+ */
+static inline uint32_t numkey_map_match_free(const uint8_t *ctrl)
+{
+#if defined(__SSE2__)
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#else
+    uint32_t m = 0, i = 0;
+    for (i = 0; i < NKMAP_GROUP; i++)
+    {
+        m |= ((uint32_t)(ctrl[i] >> 7) << i);
+    }
+    return m;
+#endif
+}
+
+/**
+ * Returns the position of the lowest bit set (the mask must not be zero).
+ */
+static inline uint32_t numkey_map_ctz(uint32_t m)
+{
+#if defined(__GNUC__)
+    return (uint32_t)__builtin_ctz(m);
+#else
+    uint32_t i = 0;
+    while (!(m & 1))
+    {
+        m >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+/**
+ * Set the control byte of a slot.
+ */
+static inline void numkey_map_set_ctrl(numkey_map_t *m, uint64_t i, uint8_t v)
+{
+    m->ctrl[i] = v;
+    if (i < NKMAP_GROUP)
+    {
+        m->ctrl[(m->capacity + i)] = v; // keep the cloned group in sync
+    }
+}
+
+/**
+ * Initialize an empty map.
+ *
+ * @param m        Map to initialize.
+ * @param capacity Minimum number of slots (rounded up to a power of 2); the map grows automatically when needed.
+ *
+ * @return False in case of memory allocation failure, true otherwise.
+ */
+static inline bool numkey_map_init(numkey_map_t *m, uint64_t capacity)
+{
+    uint64_t cap = NKMAP_MINCAPACITY;
+    while (cap < capacity)
+    {
+        cap <<= 1;
+    }
+    m->capacity = cap;
+    m->size = 0;
+    m->used = 0;
+    m->ctrl = (uint8_t *)malloc(cap + NKMAP_GROUP);
+    m->keys = (uint64_t *)malloc(cap * sizeof(uint64_t));
+    m->values = (uint64_t *)malloc(cap * sizeof(uint64_t));
+    if ((m->ctrl == NULL) || (m->keys == NULL) || (m->values == NULL))
+    {
+        free(m->ctrl);
+        free(m->keys);
+        free(m->values);
+        m->ctrl = NULL;
+        m->keys = NULL;
+        m->values = NULL;
+        m->capacity = 0;
+        return false;
+    }
+    memset(m->ctrl, NKMAP_CTRL_EMPTY, (cap + NKMAP_GROUP));
+    return true;
+}
+
+/**
+ * Free the memory allocated by the map.
+ *
+ * @param m Map to free.
+ */
+static inline void numkey_map_free(numkey_map_t *m)
+{
+    free(m->ctrl);
+    free(m->keys);
+    free(m->values);
+    m->ctrl = NULL;
+    m->keys = NULL;
+    m->values = NULL;
+    m->capacity = 0;
+    m->size = 0;
+    m->used = 0;
+}
+
+/**
+ * Returns the slot containing the specified key.
+ *
+ * @param m  Map.
+ * @param nk NumKey to search.
+ *
+ * @return Slot index or the map capacity if the key is not found.
+ */
+static inline uint64_t numkey_map_find(const numkey_map_t *m, uint64_t nk)
+{
+    uint64_t h = numkey_hash(nk);
+    uint8_t h2 = (uint8_t)(h & NKMAP_H2MASK);
+    uint64_t mask = (m->capacity - 1);
+    uint64_t pos = ((h >> 7) & mask);
+    uint64_t step = 0, i = 0;
+    uint32_t bits = 0;
+    for (;;)
+    {
+        bits = numkey_map_match(m->ctrl + pos, h2);
+        while (bits != 0)
+        {
+            i = ((pos + numkey_map_ctz(bits)) & mask);
+            if (m->keys[i] == nk)
+            {
+                return i;
+            }
+            bits &= (bits - 1);
+        }
+        if (numkey_map_match(m->ctrl + pos, NKMAP_CTRL_EMPTY) != 0)
+        {
+            return m->capacity;
+        }
+        step += NKMAP_GROUP; // triangular probing visits every group
+        pos = ((pos + step) & mask);
+    }
+}
+
+/**
+ * Insert a key in the first empty or deleted slot of its probe sequence, without checking for duplicates or free space.
+ *
+ * @return Slot index.
+ */
+static inline uint64_t numkey_map_insert_slot(numkey_map_t *m, uint64_t nk)
+{
+    uint64_t h = numkey_hash(nk);
+    uint64_t mask = (m->capacity - 1);
+    uint64_t pos = ((h >> 7) & mask);
+    uint64_t step = 0, i = 0;
+    uint32_t bits = 0;
+    while ((bits = numkey_map_match_free(m->ctrl + pos)) == 0)
+    {
+        step += NKMAP_GROUP;
+        pos = ((pos + step) & mask);
+    }
+    i = ((pos + numkey_map_ctz(bits)) & mask);
+    if (m->ctrl[i] == NKMAP_CTRL_EMPTY)
+    {
+        m->used++;
+    }
+    numkey_map_set_ctrl(m, i, (uint8_t)(h & NKMAP_H2MASK));
+    m->keys[i] = nk;
+    m->size++;
+    return i;
+}
+
+/**
+ * Rebuild the map with the specified capacity, dropping the tombstones.
+ *
+ * @return False in case of memory allocation failure (the map is left unchanged), true otherwise.
+ */
+static inline bool numkey_map_rehash(numkey_map_t *m, uint64_t capacity)
+{
+    numkey_map_t n;
+    uint64_t i = 0;
+    if (!numkey_map_init(&n, capacity))
+    {
+        return false;
+    }
+    for (i = 0; i < m->capacity; i++)
+    {
+        if (m->ctrl[i] < NKMAP_CTRL_EMPTY)
+        {
+            n.values[numkey_map_insert_slot(&n, m->keys[i])] = m->values[i];
+        }
+    }
+    numkey_map_free(m);
+    *m = n;
+    return true;
+}
+
+/**
+ * Insert or update a key-value pair.
+ * The map grows (or it is cleaned from tombstones) when 7/8 of the slots are used.
+ *
+ * @param m     Map.
+ * @param nk    NumKey.
+ * @param value Value to store.
+ *
+ * @return False in case of memory allocation failure, true otherwise.
+ */
+static inline bool numkey_map_put(numkey_map_t *m, uint64_t nk, uint64_t value)
+{
+    uint64_t i = numkey_map_find(m, nk);
+    if (i < m->capacity)
+    {
+        m->values[i] = value;
+        return true;
+    }
+    if (((m->used + 1) * 8) > (m->capacity * 7))
+    {
+        // double the capacity only if most of the used slots contain keys
+        if (!numkey_map_rehash(m, (((m->size * 2) >= m->used) ? (m->capacity << 1) : m->capacity)))
+        {
+            return false;
+        }
+    }
+    m->values[numkey_map_insert_slot(m, nk)] = value;
+    return true;
+}
+
+/**
+ * Retrieve the value associated to a key.
+ *
+ * @param m     Map.
+ * @param nk    NumKey to search.
+ * @param value Pointer to the value to be returned (unchanged if the key is not found).
+ *
+ * @return True if the key is found, false otherwise.
+ */
+static inline bool numkey_map_get(const numkey_map_t *m, uint64_t nk, uint64_t *value)
+{
+    uint64_t i = numkey_map_find(m, nk);
+    if (i == m->capacity)
+    {
+        return false;
+    }
+    *value = m->values[i];
+    return true;
+}
+
+/**
+ * Remove a key from the map.
+ *
+ * @param m  Map.
+ * @param nk NumKey to remove.
+ *
+ * @return True if the key was found and removed, false otherwise.
+ */
+static inline bool numkey_map_del(numkey_map_t *m, uint64_t nk)
+{
+    uint64_t i = numkey_map_find(m, nk);
+    if (i == m->capacity)
+    {
+        return false;
+    }
+    numkey_map_set_ctrl(m, i, NKMAP_CTRL_DELETED);
+    m->size--;
+    return true;
+}
+
+#endif  // NUMKEY_NUMKEY_MAP_H
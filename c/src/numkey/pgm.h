@@ -0,0 +1,211 @@
+// NumKey
+//
+// pgm.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file pgm.h
+ * @brief Piecewise-linear learned index over sorted NumKey columns.
+ *
+ * The functions provided here allows to build a piecewise-linear model of the position of the keys
+ * of a sorted uint64_t column (e.g. a NumKey column), with a maximum prediction error epsilon,
+ * and to use it to restrict a col_find_first_uint64_t search to a window of about (2 * epsilon) rows.
+ *
+ * The model is built in a single pass with the shrinking cone algorithm:
+ * each segment starts at a key and keeps the range of the slopes that predict the position
+ * of all the following keys within epsilon, until the range becomes empty.
+ * The position of duplicate keys is the first one, so the window always contains the first occurrence.
+ * NumKeys in the same country are close to uniformly distributed over large number blocks,
+ * so a few segments are generally enough to model millions of keys.
+ *
+ * The model is serialized as a single blob of uint64_t words that can be stored next to the data
+ * and memory-mapped (e.g. with mmap_binfile), then used directly with pgm_load, without any parsing or allocation:
+ *
+ *   - header (PGM_HEADER_WORDS): magic "NKPGM1", nrows, epsilon, nsegs;
+ *   - keys (nsegs): first key of each segment;
+ *   - segments (2 * nsegs): first position and slope of each segment.
+ */
+
+#ifndef NUMKEY_PGM_H
+#define NUMKEY_PGM_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binsearch.h"
+
+#define PGM_MAGIC        0x00314d47504b4e //!< Magic number "NKPGM1" in LE.
+#define PGM_HEADER_WORDS 4                //!< Number of uint64_t words in the header.
+
+/**
+ * Linear model of a segment.
+ */
+typedef struct pgm_segment_t
+{
+    uint64_t pos; //!< Position of the first key of the segment.
+    double slope; //!< Positions per key unit.
+} pgm_segment_t;
+
+/**
+ * Read-only view of a serialized piecewise-linear model.
+ */
+typedef struct pgm_t
+{
+    const uint64_t *keys;       //!< First key of each segment.
+    const pgm_segment_t *segs;  //!< Linear model of each segment.
+    uint64_t nrows;             //!< Number of rows of the modeled column.
+    uint64_t epsilon;           //!< Maximum prediction error.
+    uint64_t nsegs;             //!< Number of segments.
+} pgm_t;
+
+/**
+ * Initialize a model view from a serialized blob (e.g. a memory-mapped file).
+ * The blob is not copied and it must be kept valid while the view is used.
+ *
+ * @param src  Address of the serialized blob (8-byte aligned).
+ * @param size Size of the blob in bytes.
+ * @param pgm  View to initialize.
+ *
+ * @return False if the blob is not a valid serialized model, true otherwise.
+ */
+static inline bool pgm_load(const uint8_t *src, uint64_t size, pgm_t *pgm)
+{
+    const uint64_t *p = (const uint64_t *)src;
+    if ((size < (PGM_HEADER_WORDS * sizeof(uint64_t))) || (p[0] != PGM_MAGIC) || (p[3] == 0)
+            || (p[3] > p[1] + 1) || ((size / sizeof(uint64_t)) < (PGM_HEADER_WORDS + (3 * p[3]))))
+    {
+        return false;
+    }
+    pgm->nrows = p[1];
+    pgm->epsilon = p[2];
+    pgm->nsegs = p[3];
+    pgm->keys = (p + PGM_HEADER_WORDS);
+    pgm->segs = (const pgm_segment_t *)(pgm->keys + pgm->nsegs);
+    return true;
+}
+
+/**
+ * Returns the window of rows containing the first occurrence of a key (if present).
+ *
+ * @param pgm    Model view.
+ * @param search Key to search.
+ * @param first  Pointer to the first row of the window.
+ * @param last   Pointer to the row (up to but not including) where the window ends.
+ */
+static inline void pgm_range(const pgm_t *pgm, uint64_t search, uint64_t *first, uint64_t *last)
+{
+    // branchless search of the last segment starting at or before the key
+    const uint64_t *base = pgm->keys;
+    uint64_t n = pgm->nsegs, half = 0;
+    while (n > 1)
+    {
+        half = (n >> 1);
+        base = (base[half] <= search) ? (base + half) : base;
+        n -= half;
+    }
+    const pgm_segment_t *seg = (pgm->segs + (base - pgm->keys));
+    const uint64_t delta = (search > *base) ? (search - *base) : 0;
+    const double pred = ((double)seg->pos + (seg->slope * (double)delta));
+    const uint64_t pos = (pred < (double)pgm->nrows) ? (uint64_t)pred : pgm->nrows;
+    const uint64_t err = (pgm->epsilon + 1); // one more row to absorb the floating point rounding
+    *first = (pos > err) ? (pos - err) : 0;
+    *last = ((pgm->nrows - pos) > (err + 1)) ? (pos + err + 1) : pgm->nrows;
+}
+
+/**
+ * Search for the first occurrence of a key on the modeled column.
+ *
+ * @param pgm    Model view.
+ * @param src    Sorted column (the same used to build the model).
+ * @param search Key to search.
+ *
+ * @return Row of the first occurrence if found or nrows if not found (as col_find_first_uint64_t on the whole column).
+ */
+static inline uint64_t pgm_find_first(const pgm_t *pgm, const uint64_t *src, uint64_t search)
+{
+    if ((pgm->nrows == 0) || (search > src[(pgm->nrows - 1)]))
+    {
+        return pgm->nrows; // the search may read src[last] when the key is past the window
+    }
+    uint64_t first = 0, last = 0;
+    pgm_range(pgm, search, &first, &last);
+    const uint64_t notfound = last;
+    const uint64_t pos = col_find_first_uint64_t(src, &first, &last, search);
+    return (pos < notfound) ? pos : pgm->nrows;
+}
+
+/**
+ * Build and serialize a piecewise-linear model of a sorted uint64_t column in a single pass.
+ *
+ * @param src     Sorted column address (e.g. get_src_offset_uint64_t(mf.src, mf.index[col])).
+ * @param nrows   Number of rows.
+ * @param epsilon Maximum prediction error (the search window is about 2 * epsilon rows).
+ * @param size    Pointer to the size in bytes of the returned blob.
+ *
+ * @return Serialized blob allocated with malloc (to be freed by the caller), or NULL in case of memory allocation failure.
+ */
+static inline uint8_t *pgm_build(const uint64_t *src, uint64_t nrows, uint64_t epsilon, uint64_t *size)
+{
+    uint64_t *keys = (uint64_t *)malloc(((nrows > 0) ? nrows : 1) * sizeof(uint64_t));
+    pgm_segment_t *segs = (pgm_segment_t *)malloc(((nrows > 0) ? nrows : 1) * sizeof(pgm_segment_t));
+    uint64_t i = 0, nsegs = 0;
+    double lo = 0, hi = 0, dx = 0, dy = 0, eps = (double)epsilon;
+    if ((keys == NULL) || (segs == NULL))
+    {
+        free(keys);
+        free(segs);
+        return NULL;
+    }
+    keys[0] = 0;
+    segs[0].pos = 0;
+    segs[0].slope = 0;
+    for (i = 0; i < nrows; i++)
+    {
+        if ((i > 0) && (src[i] == src[(i - 1)]))
+        {
+            continue; // the duplicates are modeled by the first occurrence
+        }
+        if (nsegs > 0)
+        {
+            dx = (double)(src[i] - keys[(nsegs - 1)]);
+            dy = (double)(i - segs[(nsegs - 1)].pos);
+            if ((((dy - eps) / dx) <= hi) && (((dy + eps) / dx) >= lo))
+            {
+                lo = (((dy - eps) / dx) > lo) ? ((dy - eps) / dx) : lo;
+                hi = (((dy + eps) / dx) < hi) ? ((dy + eps) / dx) : hi;
+                segs[(nsegs - 1)].slope = ((lo + hi) / 2);
+                continue;
+            }
+        }
+        // start a new segment
+        keys[nsegs] = src[i];
+        segs[nsegs].pos = i;
+        segs[nsegs].slope = 0;
+        lo = 0;
+        hi = (double)UINT64_MAX;
+        nsegs++;
+    }
+    nsegs = (nsegs > 0) ? nsegs : 1; // an empty column has a single empty segment
+    *size = ((PGM_HEADER_WORDS + (3 * nsegs)) * sizeof(uint64_t));
+    uint8_t *blob = (uint8_t *)malloc(*size);
+    if (blob != NULL)
+    {
+        uint64_t *p = (uint64_t *)blob;
+        p[0] = PGM_MAGIC;
+        p[1] = nrows;
+        p[2] = epsilon;
+        p[3] = nsegs;
+        memcpy((p + PGM_HEADER_WORDS), keys, (nsegs * sizeof(uint64_t)));
+        memcpy((p + PGM_HEADER_WORDS + nsegs), segs, (nsegs * sizeof(pgm_segment_t)));
+    }
+    free(keys);
+    free(segs);
+    return blob;
+}
+
+#endif  // NUMKEY_PGM_H
@@ -19,6 +19,7 @@
 
 #include <inttypes.h>
 #include <stddef.h>
+#include "e164.h"
 
 #define PKNUMMAXLEN 15 //!< Maximum number of digits to store for the prefixkey.
 
@@ -53,4 +54,35 @@ static inline uint64_t prefixkey(const char *number, size_t size)
     return num;
 }
 
+/**
+ * Encode a formatted number string into uint64 in a single pass and without allocations.
+ * Formatting characters (space, dash, dot, slash, parentheses), the "(0)" trunk prefix
+ * and the international prefix ("+" or "00") are skipped while accumulating the digits (see e164.h).
+ * The result is the same as calling prefixkey() with the significant digits only.
+ *
+ * @param number String containing the formatted number or prefix (e.g. "+1-212-").
+ * @param size   Length of the number string.
+ * @param pk     PrefixKey to be returned.
+ *
+ * @return Number of significant digits consumed (max PKNUMMAXLEN, as the following digits are truncated).
+ */
+static inline size_t prefixkey_norm(const char *number, size_t size, uint64_t *pk)
+{
+    uint64_t num = 0;
+    size_t len = 0, i = 0;
+    size_t pos = e164_start(number, size);
+    int b = 0;
+    while ((len < PKNUMMAXLEN) && ((b = e164_next_digit(number, size, &pos)) >= 0))
+    {
+        num = (num * 10) + (uint64_t)b;
+        len++;
+    }
+    for (i = len; i < PKNUMMAXLEN; i++)
+    {
+        num = (num * 10); // zero right-padding
+    }
+    *pk = num;
+    return len;
+}
+
 #endif  // NUMKEY_PREFIXKEY_H
@@ -19,6 +19,7 @@
 
 #include <inttypes.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define RADIX_SORT_COUNT_BLOCK \
     uint32_t c7[256]= {0}, c6[256]= {0}, c5[256]= {0}, c4[256]= {0}, c3[256]= {0}, c2[256]= {0}, c1[256]= {0}, c0[256]= {0}; \
@@ -243,4 +244,85 @@ static inline uint64_t *union_uint64_t(uint64_t *a_arr, uint64_t a_nitems, uint6
     return o_arr;
 }
 
+/**
+ * Sorts in-memory an array of unsigned 128 bit values in ascending order.
+ * Each value is stored as two consecutive uint64_t words, the low word first (e.g. an array of numkey128_t).
+ * This is a stable LSD radix sort on 16 bytes; the passes where all the values share the same byte are skipped
+ * (e.g. the country byte of a single-country dataset).
+ *
+ * @param arr    Pointer to the first element of the array to process (2 * nitems words).
+ * @param tmp    Pointer to the first element of a temporary array (2 * nitems words).
+ * @param nitems Number of 128 bit elements in the array.
+ */
+static inline void sort_uint128_t(uint64_t *arr, uint64_t *tmp, uint32_t nitems)
+{
+    uint32_t c[256];
+    uint32_t i, o, t;
+    uint8_t w, shift;
+    uint64_t *a = arr, *b = tmp, *x;
+    for (w = 0; w < 2; w++)
+    {
+        for (shift = 0; shift < 64; shift += 8)
+        {
+            memset(c, 0, sizeof(c));
+            for (i = 0; i < nitems; i++)
+            {
+                c[((a[(2 * i) + w] >> shift) & 0xff)]++;
+            }
+            if ((nitems == 0) || (c[((a[w] >> shift) & 0xff)] == nitems))
+            {
+                continue; // all values share this byte
+            }
+            for (o = 0, i = 0; i < 256; i++)
+            {
+                t = (o + c[i]);
+                c[i] = o;
+                o = t;
+            }
+            for (i = 0; i < nitems; i++)
+            {
+                t = c[((a[(2 * i) + w] >> shift) & 0xff)]++;
+                b[(2 * t)] = a[(2 * i)];
+                b[(2 * t) + 1] = a[(2 * i) + 1];
+            }
+            x = a;
+            a = b;
+            b = x;
+        }
+    }
+    if (a != arr)
+    {
+        memcpy(arr, a, ((size_t)nitems * 2 * sizeof(uint64_t)));
+    }
+}
+
+/**
+ * Eliminates all but the first element from every consecutive group of equal unsigned 128 bit values.
+ * Each value is stored as two consecutive uint64_t words, the low word first.
+ *
+ * @param arr    Pointer to the first element of the array to process (2 * nitems words).
+ * @param nitems Number of 128 bit elements in the array.
+ *
+ * @return Pointer to the end of the array.
+ */
+static inline uint64_t *unique_uint128_t(uint64_t *arr, uint64_t nitems)
+{
+    if (nitems == 0)
+    {
+        return arr;
+    }
+    uint64_t *last = (arr + (2 * nitems));
+    uint64_t *p = arr;
+    while ((arr += 2) != last)
+    {
+        if ((p[0] != arr[0]) || (p[1] != arr[1]))
+        {
+            p += 2;
+            p[0] = arr[0];
+            p[1] = arr[1];
+        }
+    }
+    return (p + 2);
+}
+
 #endif  // NUMKEY_SET_H
\ No newline at end of file
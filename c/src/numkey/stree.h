@@ -0,0 +1,413 @@
+// NumKey
+//
+// stree.h
+//
+// @category   Libraries
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+/**
+ * @file stree.h
+ * @brief Static B+ tree (S+ tree) index for sorted binsearch columns.
+ *
+ * The functions provided here allows to build an implicit static B+ tree over a sorted column
+ * of uint32_t or uint64_t values (e.g. a column of a BINSRC1, Arrow or Feather file mapped with mmap_binfile),
+ * and to search it with the same semantics of col_find_first_T and col_find_last_T.
+ *
+ * Each node is a 64-byte cache line containing STREE_KEYS(T) keys (8 uint64_t or 16 uint32_t),
+ * so a lookup touches about log_(STREE_KEYS+1)(n) cache lines instead of log2(n).
+ * The leaves contain all the sorted values (padded with the maximum value), and the key i of an internal node
+ * is the smallest value of the subtree of the child (i + 1). A node is searched by counting the keys
+ * smaller than the search value, with AVX2 compare and movemask when available.
+ *
+ * The tree is serialized as a single 64-byte aligned blob that can be memory-mapped
+ * (e.g. with mmap_binfile) and used directly with stree_load, without any parsing or allocation:
+ *
+ *   - header (STREE_HEADER_WORDS): magic "NKSTREE1", nrows, key size in bytes, number of layers, number of nodes;
+ *   - nodes: the layers from the root to the leaves, each one stored as consecutive nodes.
+ */
+
+#ifndef NUMKEY_STREE_H
+#define NUMKEY_STREE_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "binsearch.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define STREE_MAGIC        0x3145455254534b4e //!< Magic number "NKSTREE1" in LE.
+#define STREE_NODEBYTES    64                 //!< Size of a node in bytes (one cache line).
+#define STREE_HEADER_WORDS 8                  //!< Number of uint64_t words in the header (one node).
+#define STREE_MAXLAYERS    32                 //!< Maximum number of layers.
+
+/**
+ * Returns the number of keys in a node of the specified type.
+ */
+#define STREE_KEYS(T) (STREE_NODEBYTES / sizeof(T))
+
+/**
+ * Read-only view of a serialized S+ tree.
+ */
+typedef struct stree_t
+{
+    const uint8_t *nodes;             //!< Address of the first node (root).
+    uint64_t nrows;                   //!< Number of indexed rows.
+    uint64_t keybytes;                //!< Size of a key in bytes (4 or 8).
+    uint64_t nlayers;                 //!< Number of layers (1 = only the leaves).
+    uint64_t offset[STREE_MAXLAYERS]; //!< Index of the first node of each layer, by height (0 = leaves).
+} stree_t;
+
+/**
+ * Returns the number of bits set.
+ */
+static inline uint8_t stree_popcount(uint32_t x)
+{
+#if defined(__GNUC__)
+    return (uint8_t)__builtin_popcount(x);
+#else
+    uint8_t r = 0;
+    for (; x; r++)
+    {
+        x &= (x - 1);
+    }
+    return r;
+#endif
+}
+
+/**
+ * Computes the number of nodes of each layer.
+ *
+ * @param nrows Number of rows.
+ * @param keys  Number of keys per node.
+ * @param nodes Array of STREE_MAXLAYERS items to be filled with the number of nodes of each layer, by height.
+ *
+ * @return Number of layers.
+ */
+static inline uint64_t stree_layers(uint64_t nrows, uint64_t keys, uint64_t *nodes)
+{
+    uint64_t h = 0;
+    nodes[0] = (nrows > 0) ? (((nrows - 1) / keys) + 1) : 1;
+    while (nodes[h] > 1)
+    {
+        nodes[(h + 1)] = (((nodes[h] - 1) / (keys + 1)) + 1);
+        h++;
+    }
+    return (h + 1);
+}
+
+/**
+ * Initialize an S+ tree view from a serialized blob (e.g. a memory-mapped file).
+ * The blob is not copied and it must be kept valid while the view is used.
+ *
+ * @param src  Address of the serialized blob (64-byte aligned for best performance).
+ * @param size Size of the blob in bytes.
+ * @param st   View to initialize.
+ *
+ * @return False if the blob is not a valid serialized tree, true otherwise.
+ */
+static inline bool stree_load(const uint8_t *src, uint64_t size, stree_t *st)
+{
+    const uint64_t *p = (const uint64_t *)src;
+    uint64_t nodes[STREE_MAXLAYERS];
+    uint64_t h = 0, total = 0;
+    if ((size < (STREE_HEADER_WORDS * sizeof(uint64_t))) || (p[0] != STREE_MAGIC) || ((p[2] != 4) && (p[2] != 8)))
+    {
+        return false;
+    }
+    st->nrows = p[1];
+    st->keybytes = p[2];
+    st->nlayers = stree_layers(st->nrows, (STREE_NODEBYTES / st->keybytes), nodes);
+    if ((st->nlayers != p[3]) || (p[4] > ((size / STREE_NODEBYTES) - 1)))
+    {
+        return false;
+    }
+    for (h = st->nlayers; h > 0; h--)
+    {
+        st->offset[(h - 1)] = total;
+        total += nodes[(h - 1)];
+    }
+    if (total != p[4])
+    {
+        return false;
+    }
+    st->nodes = (src + (STREE_HEADER_WORDS * sizeof(uint64_t)));
+    return true;
+}
+
+/**
+ * Returns the number of keys of a uint64_t node smaller than (or smaller or equal to) the search value.
+ *
+ * @param node   Node keys (sorted).
+ * @param search Value to search.
+ * @param equal  If true counts the keys smaller or equal to the search value.
+ *
+ * @return Number of keys.
+ */
+static inline uint64_t stree_rank_uint64_t(const uint64_t *node, uint64_t search, bool equal)
+{
+#if defined(__AVX2__)
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN); // unsigned compare as signed
+    const __m256i vs = _mm256_xor_si256(_mm256_set1_epi64x((long long)search), sign);
+    const __m256i lo = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)node), sign);
+    const __m256i hi = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(node + 4)), sign);
+    if (equal)
+    {
+        const uint32_t gt = ((uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(lo, vs)))
+                             | ((uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(hi, vs))) << 4));
+        return (uint64_t)(8 - stree_popcount(gt));
+    }
+    const uint32_t lt = ((uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(vs, lo)))
+                         | ((uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(vs, hi))) << 4));
+    return (uint64_t)stree_popcount(lt);
+#else
+    uint64_t i = 0, r = 0;
+    for (i = 0; i < 8; i++)
+    {
+        r += (uint64_t)((node[i] < search) || (equal && (node[i] == search)));
+    }
+    return r;
+#endif
+}
+
+/**
+ * Returns the number of keys of a uint32_t node smaller than (or smaller or equal to) the search value.
+ *
+ * @param node   Node keys (sorted).
+ * @param search Value to search.
+ * @param equal  If true counts the keys smaller or equal to the search value.
+ *
+ * @return Number of keys.
+ */
+static inline uint64_t stree_rank_uint32_t(const uint32_t *node, uint32_t search, bool equal)
+{
+#if defined(__AVX2__)
+    const __m256i sign = _mm256_set1_epi32(INT32_MIN); // unsigned compare as signed
+    const __m256i vs = _mm256_xor_si256(_mm256_set1_epi32((int)search), sign);
+    const __m256i lo = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)node), sign);
+    const __m256i hi = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(node + 8)), sign);
+    if (equal)
+    {
+        const uint32_t gt = ((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(lo, vs)))
+                             | ((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(hi, vs))) << 8));
+        return (uint64_t)(16 - stree_popcount(gt));
+    }
+    const uint32_t lt = ((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vs, lo)))
+                         | ((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vs, hi))) << 8));
+    return (uint64_t)stree_popcount(lt);
+#else
+    uint64_t i = 0, r = 0;
+    for (i = 0; i < 16; i++)
+    {
+        r += (uint64_t)((node[i] < search) || (equal && (node[i] == search)));
+    }
+    return r;
+#endif
+}
+
+/**
+ * Generic function to build and serialize an S+ tree.
+ *
+ * @param T Unsigned integer type, one of: uint32_t, uint64_t.
+ */
+#define define_stree_build(T) \
+/** Build and serialize an S+ tree over a sorted column of unsigned integers.
+This function is meant to be used offline: the tree takes about (1 + 1/STREE_KEYS) times the size of the column.
+@param src       Sorted column address (e.g. get_src_offset_T(mf.src, mf.index[col])).
+@param nrows     Number of rows.
+@param size      Pointer to the size in bytes of the returned blob.
+@return Serialized blob allocated with aligned_alloc (to be freed by the caller with free), or NULL in case of memory allocation failure.
+ */ \
+static inline uint8_t *stree_build_##T(const T *src, uint64_t nrows, uint64_t *size) \
+{ \
+    const uint64_t keys = STREE_KEYS(T); \
+    const T pad = (T)(~(T)0); \
+    uint64_t nodes[STREE_MAXLAYERS]; \
+    uint64_t offset[STREE_MAXLAYERS]; \
+    uint64_t h, k, i, child, span, total = 0; \
+    const uint64_t nlayers = stree_layers(nrows, keys, nodes); \
+    for (h = nlayers; h > 0; h--) \
+    { \
+        offset[(h - 1)] = total; \
+        total += nodes[(h - 1)]; \
+    } \
+    *size = ((total + 1) * STREE_NODEBYTES); \
+    uint8_t *blob = (uint8_t *)aligned_alloc(STREE_NODEBYTES, *size); \
+    if (blob == NULL) \
+    { \
+        return NULL; \
+    } \
+    uint64_t *p = (uint64_t *)blob; \
+    for (i = 0; i < STREE_HEADER_WORDS; i++) \
+    { \
+        p[i] = 0; \
+    } \
+    p[0] = STREE_MAGIC; \
+    p[1] = nrows; \
+    p[2] = sizeof(T); \
+    p[3] = nlayers; \
+    p[4] = total; \
+    T *data = (T *)(blob + STREE_NODEBYTES); \
+    T *leaves = (data + (offset[0] * keys)); \
+    for (i = 0; i < (nodes[0] * keys); i++) \
+    { \
+        leaves[i] = (i < nrows) ? src[i] : pad; \
+    } \
+    for (h = 1, span = keys; h < nlayers; h++, span *= (keys + 1)) \
+    { \
+        T *layer = (data + (offset[h] * keys)); \
+        for (k = 0; k < nodes[h]; k++) \
+        { \
+            for (i = 0; i < keys; i++) \
+            { \
+                child = ((k * (keys + 1)) + i + 1); \
+                layer[((k * keys) + i)] = ((child < nodes[(h - 1)]) && ((child * span) < nrows)) ? src[(child * span)] : pad; \
+            } \
+        } \
+    } \
+    return blob; \
+}
+
+define_stree_build(uint32_t)
+define_stree_build(uint64_t)
+
+/**
+ * Generic function to build and serialize an S+ tree from a column of a memory mapped file.
+ *
+ * @param T Unsigned integer type, one of: uint32_t, uint64_t.
+ */
+#define define_stree_build_mmfile(T) \
+/** Build and serialize an S+ tree over a sorted column of a memory mapped file (see mmap_binfile).
+@param mf        Memory mapped file info.
+@param col       Column index.
+@param size      Pointer to the size in bytes of the returned blob.
+@return Serialized blob allocated with aligned_alloc (to be freed by the caller with free),
+        or NULL if the column type does not match or in case of memory allocation failure.
+ */ \
+static inline uint8_t *stree_build_mmfile_##T(const mmfile_t *mf, uint8_t col, uint64_t *size) \
+{ \
+    if ((col >= mf->ncols) || (mf->ctbytes[col] != sizeof(T))) \
+    { \
+        return NULL; \
+    } \
+    return stree_build_##T(get_src_offset_##T(mf->src, mf->index[col]), mf->nrows, size); \
+}
+
+define_stree_build_mmfile(uint32_t)
+define_stree_build_mmfile(uint64_t)
+
+/**
+ * Generic function to search the position of the first item greater (or greater or equal) than a value.
+ *
+ * @param T Unsigned integer type, one of: uint32_t, uint64_t.
+ */
+#define define_stree_bound(T) \
+/** Search the position of the first item greater (or greater or equal) than a value.
+@param st        S+ tree view.
+@param search    Unsigned number to search (type T).
+@param upper     If true returns the first item greater than the search value (upper bound),
+                 otherwise the first item greater or equal (lower bound).
+@return Row position (nrows if all the items are smaller).
+ */ \
+static inline uint64_t stree_bound_##T(const stree_t *st, T search, bool upper) \
+{ \
+    const uint64_t keys = STREE_KEYS(T); \
+    const T *data = (const T *)st->nodes; \
+    uint64_t h, k = 0; \
+    if (upper && (search == (T)(~(T)0))) \
+    { \
+        return st->nrows; /* the padding keys would match */ \
+    } \
+    for (h = (st->nlayers - 1); h > 0; h--) \
+    { \
+        k = ((k * (keys + 1)) + stree_rank_##T(data + ((st->offset[h] + k) * keys), search, upper)); \
+    } \
+    k = ((k * keys) + stree_rank_##T(data + ((st->offset[0] + k) * keys), search, upper)); \
+    return (k < st->nrows) ? k : st->nrows; \
+}
+
+define_stree_bound(uint32_t)
+define_stree_bound(uint64_t)
+
+/**
+ * Generic function to search for the first occurrence of an unsigned integer on an S+ tree.
+ *
+ * @param T Unsigned integer type, one of: uint32_t, uint64_t.
+ */
+#define define_stree_find_first(T) \
+/** Search for the first occurrence of an unsigned integer on an S+ tree.
+This is a drop-in replacement for col_find_first_T on the indexed column: same return value and same updates of first and last,
+except that the items outside the [first, last) range are never matched.
+@param st        S+ tree view.
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return item number if found or the original last if not found.
+ */ \
+static inline uint64_t stree_find_first_##T(const stree_t *st, uint64_t *first, uint64_t *last, T search) \
+{ \
+    const T *leaves = ((const T *)st->nodes + (st->offset[0] * STREE_KEYS(T))); \
+    const uint64_t notfound = *last; \
+    uint64_t pos = stree_bound_##T(st, search, false); \
+    pos = (pos < *first) ? *first : pos; \
+    pos = (pos > *last) ? *last : pos; \
+    *first = pos; \
+    *last = pos; \
+    if ((pos < notfound) && (leaves[pos] == search)) \
+    { \
+        return pos; \
+    } \
+    if (*first > 0) \
+    { \
+        --(*first); \
+    } \
+    return notfound; \
+}
+
+define_stree_find_first(uint32_t)
+define_stree_find_first(uint64_t)
+
+/**
+ * Generic function to search for the last occurrence of an unsigned integer on an S+ tree.
+ *
+ * @param T Unsigned integer type, one of: uint32_t, uint64_t.
+ */
+#define define_stree_find_last(T) \
+/** Search for the last occurrence of an unsigned integer on an S+ tree.
+This is a drop-in replacement for col_find_last_T on the indexed column: same return value and same updates of first and last,
+except that the items outside the [first, last) range are never matched.
+@param st        S+ tree view.
+@param first     Pointer to the element from where to start the search (min value = 0).
+@param last      Pointer to the element (up to but not including) where to end the search (max value = nrows).
+@param search    Unsigned number to search (type T).
+@return item number if found or the original last if not found.
+ */ \
+static inline uint64_t stree_find_last_##T(const stree_t *st, uint64_t *first, uint64_t *last, T search) \
+{ \
+    const T *leaves = ((const T *)st->nodes + (st->offset[0] * STREE_KEYS(T))); \
+    const uint64_t notfound = *last; \
+    const uint64_t start = *first; \
+    uint64_t pos = stree_bound_##T(st, search, true); \
+    pos = (pos < *first) ? *first : pos; \
+    pos = (pos > *last) ? *last : pos; \
+    *first = pos; \
+    *last = pos; \
+    if ((pos > start) && (leaves[(pos - 1)] == search)) \
+    { \
+        return (pos - 1); \
+    } \
+    if (*first > 0) \
+    { \
+        --(*first); \
+    } \
+    return notfound; \
+}
+
+define_stree_find_last(uint32_t)
+define_stree_find_last(uint64_t)
+
+#endif  // NUMKEY_STREE_H
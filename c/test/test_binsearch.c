@@ -957,6 +957,214 @@ define_test_find_last(le, uint16_t)
 define_test_find_last(le, uint32_t)
 define_test_find_last(le, uint64_t)
 
+#define define_test_find_range(O, T) \
+int test_find_range_##O##_##T(mmfile_t mf, uint64_t blklen) \
+{ \
+    int errors = 0; \
+    int i; \
+    uint8_t nbytes = (uint8_t)sizeof(T); \
+    uint8_t bitstart = ((nbytes >> 2) * 8); \
+    uint8_t bitend = ((8 * nbytes) - 1 - bitstart); \
+    uint64_t count, first, last, efirst, elast; \
+    for (i=0 ; i < TEST_DATA_SIZE; i++) \
+    { \
+        first = test_data_##O##_##T[i].first; \
+        last = test_data_##O##_##T[i].last; \
+        efirst = (test_data_##O##_##T[i].foundFirst < test_data_##O##_##T[i].last) ? test_data_##O##_##T[i].foundFirst : test_data_##O##_##T[i].foundFLast; \
+        elast = (test_data_##O##_##T[i].foundFirst < test_data_##O##_##T[i].last) ? (test_data_##O##_##T[i].foundLast + 1) : test_data_##O##_##T[i].foundFLast; \
+        count = find_range_##O##_##T(mf.src, blklen, test_data_##O##_##T[i].blkpos, &first, &last, test_data_##O##_##T[i].search); \
+        if ((first != efirst) || (last != elast) || (count != (elast - efirst))) \
+        { \
+            (void) fprintf(stderr, "%s (%d) Expected [%" PRIx64 ", %" PRIx64 "), got [%" PRIx64 ", %" PRIx64 ") %" PRIu64 "\n", __func__, i, efirst, elast, first, last, count); \
+            ++errors; \
+        } \
+        first = test_data_sub_##O##_##T[i].first; \
+        last = test_data_sub_##O##_##T[i].last; \
+        efirst = (test_data_sub_##O##_##T[i].foundFirst < test_data_sub_##O##_##T[i].last) ? test_data_sub_##O##_##T[i].foundFirst : test_data_sub_##O##_##T[i].foundFLast; \
+        elast = (test_data_sub_##O##_##T[i].foundFirst < test_data_sub_##O##_##T[i].last) ? (test_data_sub_##O##_##T[i].foundLast + 1) : test_data_sub_##O##_##T[i].foundFLast; \
+        count = find_range_sub_##O##_##T(mf.src, blklen, test_data_sub_##O##_##T[i].blkpos, bitstart, bitend, &first, &last, test_data_sub_##O##_##T[i].search); \
+        if ((first != efirst) || (last != elast) || (count != (elast - efirst))) \
+        { \
+            (void) fprintf(stderr, "%s SUB (%d) Expected [%" PRIx64 ", %" PRIx64 "), got [%" PRIx64 ", %" PRIx64 ") %" PRIu64 "\n", __func__, i, efirst, elast, first, last, count); \
+            ++errors; \
+        } \
+    } \
+    return errors; \
+}
+
+define_test_find_range(be, uint8_t)
+define_test_find_range(be, uint16_t)
+define_test_find_range(be, uint32_t)
+define_test_find_range(be, uint64_t)
+define_test_find_range(le, uint8_t)
+define_test_find_range(le, uint16_t)
+define_test_find_range(le, uint32_t)
+define_test_find_range(le, uint64_t)
+
+#define define_test_scan_run(O, T) \
+int test_scan_run_##O##_##T(mmfile_t mf, uint64_t blklen, uint64_t nrows) \
+{ \
+    int errors = 0; \
+    uint8_t nbytes = (uint8_t)sizeof(T); \
+    uint8_t bitstart = ((nbytes >> 2) * 8); \
+    uint8_t bitend = ((8 * nbytes) - 1 - bitstart); \
+    uint64_t i, pos, end, exp, count, out[4]; \
+    T search; \
+    for (i = 0; i < nrows; i++) \
+    { \
+        search = bytes_##O##_to_##T(mf.src, get_address(blklen, 0, i)); \
+        pos = exp = i; \
+        while ((exp < nrows) && (bytes_##O##_to_##T(mf.src, get_address(blklen, 0, exp)) == search)) \
+        { \
+            ++exp; \
+        } \
+        end = scan_run_##O##_##T(mf.src, blklen, 0, i, nrows, search); \
+        if (end != exp) \
+        { \
+            (void) fprintf(stderr, "%s (%" PRIu64 ") Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, exp, end); \
+            ++errors; \
+        } \
+        end = i; \
+        while ((count = fill_run_##O##_##T(mf.src, blklen, 0, &pos, nrows, search, out, 4)) > 0) \
+        { \
+            if (out[0] != end) \
+            { \
+                (void) fprintf(stderr, "%s FILL (%" PRIu64 ") Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, end, out[0]); \
+                ++errors; \
+            } \
+            end += count; \
+        } \
+        if ((pos != exp) || (end != pos)) \
+        { \
+            (void) fprintf(stderr, "%s FILL (%" PRIu64 ") Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, exp, pos); \
+            ++errors; \
+        } \
+        search = (T)((bytes_##O##_to_##T(mf.src, get_address(blklen, 0, i)) >> (((8 * nbytes) - 1) - bitend)) & (((T)1 << (bitend - bitstart)) ^ (((T)1 << (bitend - bitstart)) - 1))); \
+        exp = i; \
+        while ((exp < nrows) && (((bytes_##O##_to_##T(mf.src, get_address(blklen, 0, exp)) >> (((8 * nbytes) - 1) - bitend)) & (((T)1 << (bitend - bitstart)) ^ (((T)1 << (bitend - bitstart)) - 1))) == search)) \
+        { \
+            ++exp; \
+        } \
+        end = scan_run_sub_##O##_##T(mf.src, blklen, 0, bitstart, bitend, i, nrows, search); \
+        if (end != exp) \
+        { \
+            (void) fprintf(stderr, "%s SUB (%" PRIu64 ") Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, exp, end); \
+            ++errors; \
+        } \
+        pos = i; \
+        count = fill_run_sub_##O##_##T(mf.src, blklen, 0, bitstart, bitend, &pos, nrows, search, out, 4); \
+        if ((count == 0) || (out[0] != i) || (pos != (i + count))) \
+        { \
+            (void) fprintf(stderr, "%s FILL SUB (%" PRIu64 ") Unexpected count %" PRIu64 "\n", __func__, i, count); \
+            ++errors; \
+        } \
+        if ((bitend - bitstart) < ((8 * nbytes) - 1) && (scan_run_sub_##O##_##T(mf.src, blklen, 0, bitstart, bitend, i, nrows, (T)~(T)0) != i)) \
+        { \
+            (void) fprintf(stderr, "%s SUB (%" PRIu64 ") Expected no match for an out of mask value\n", __func__, i); \
+            ++errors; \
+        } \
+    } \
+    return errors; \
+}
+
+define_test_scan_run(be, uint8_t)
+define_test_scan_run(be, uint16_t)
+define_test_scan_run(be, uint32_t)
+define_test_scan_run(be, uint64_t)
+define_test_scan_run(le, uint8_t)
+define_test_scan_run(le, uint16_t)
+define_test_scan_run(le, uint32_t)
+define_test_scan_run(le, uint64_t)
+
+#define define_test_find_batch(O, T) \
+int test_find_batch_##O##_##T(mmfile_t mf, uint64_t blklen) \
+{ \
+    int errors = 0; \
+    int i; \
+    uint64_t ffound, lfound; \
+    for (i=0 ; i < TEST_DATA_SIZE; i++) \
+    { \
+        find_first_batch_##O##_##T(mf.src, blklen, test_data_##O##_##T[i].blkpos, test_data_##O##_##T[i].first, test_data_##O##_##T[i].last, &test_data_##O##_##T[i].search, &ffound, 1); \
+        if (ffound != test_data_##O##_##T[i].foundFirst) \
+        { \
+            (void) fprintf(stderr, "%s FIRST (%d) Expected found %" PRIx64 ", got %" PRIx64 "\n", __func__, i, test_data_##O##_##T[i].foundFirst, ffound); \
+            ++errors; \
+        } \
+        find_last_batch_##O##_##T(mf.src, blklen, test_data_##O##_##T[i].blkpos, test_data_##O##_##T[i].first, test_data_##O##_##T[i].last, &test_data_##O##_##T[i].search, &lfound, 1); \
+        if (lfound != test_data_##O##_##T[i].foundLast) \
+        { \
+            (void) fprintf(stderr, "%s LAST (%d) Expected found %" PRIx64 ", got %" PRIx64 "\n", __func__, i, test_data_##O##_##T[i].foundLast, lfound); \
+            ++errors; \
+        } \
+    } \
+    return errors; \
+}
+
+define_test_find_batch(be, uint8_t)
+define_test_find_batch(be, uint16_t)
+define_test_find_batch(be, uint32_t)
+define_test_find_batch(be, uint64_t)
+define_test_find_batch(le, uint8_t)
+define_test_find_batch(le, uint16_t)
+define_test_find_batch(le, uint32_t)
+define_test_find_batch(le, uint64_t)
+
+#define define_test_find_bl(O, T) \
+int test_find_bl_##O##_##T(mmfile_t mf, uint64_t blklen) \
+{ \
+    int errors = 0; \
+    int i; \
+    uint8_t nbytes = (uint8_t)sizeof(T); \
+    uint8_t bitstart = ((nbytes >> 2) * 8); \
+    uint8_t bitend = ((8 * nbytes) - 1 - bitstart); \
+    uint64_t found, first, last; \
+    for (i=0 ; i < TEST_DATA_SIZE; i++) \
+    { \
+        first = test_data_##O##_##T[i].first; \
+        last = test_data_##O##_##T[i].last; \
+        found = find_first_bl_##O##_##T(mf.src, blklen, test_data_##O##_##T[i].blkpos, &first, &last, test_data_##O##_##T[i].search); \
+        if ((found != test_data_##O##_##T[i].foundFirst) || (first != test_data_##O##_##T[i].foundFFirst) || (last != test_data_##O##_##T[i].foundFLast)) \
+        { \
+            (void) fprintf(stderr, "%s FIRST (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, i, test_data_##O##_##T[i].foundFirst, test_data_##O##_##T[i].foundFFirst, test_data_##O##_##T[i].foundFLast, found, first, last); \
+            ++errors; \
+        } \
+        first = test_data_##O##_##T[i].first; \
+        last = test_data_##O##_##T[i].last; \
+        found = find_last_bl_##O##_##T(mf.src, blklen, test_data_##O##_##T[i].blkpos, &first, &last, test_data_##O##_##T[i].search); \
+        if ((found != test_data_##O##_##T[i].foundLast) || (first != test_data_##O##_##T[i].foundLFirst) || (last != test_data_##O##_##T[i].foundLLast)) \
+        { \
+            (void) fprintf(stderr, "%s LAST (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, i, test_data_##O##_##T[i].foundLast, test_data_##O##_##T[i].foundLFirst, test_data_##O##_##T[i].foundLLast, found, first, last); \
+            ++errors; \
+        } \
+        first = test_data_sub_##O##_##T[i].first; \
+        last = test_data_sub_##O##_##T[i].last; \
+        found = find_first_bl_sub_##O##_##T(mf.src, blklen, test_data_sub_##O##_##T[i].blkpos, bitstart, bitend, &first, &last, test_data_sub_##O##_##T[i].search); \
+        if ((found != test_data_sub_##O##_##T[i].foundFirst) || (first != test_data_sub_##O##_##T[i].foundFFirst) || (last != test_data_sub_##O##_##T[i].foundFLast)) \
+        { \
+            (void) fprintf(stderr, "%s SUB FIRST (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, i, test_data_sub_##O##_##T[i].foundFirst, test_data_sub_##O##_##T[i].foundFFirst, test_data_sub_##O##_##T[i].foundFLast, found, first, last); \
+            ++errors; \
+        } \
+        first = test_data_sub_##O##_##T[i].first; \
+        last = test_data_sub_##O##_##T[i].last; \
+        found = find_last_bl_sub_##O##_##T(mf.src, blklen, test_data_sub_##O##_##T[i].blkpos, bitstart, bitend, &first, &last, test_data_sub_##O##_##T[i].search); \
+        if ((found != test_data_sub_##O##_##T[i].foundLast) || (first != test_data_sub_##O##_##T[i].foundLFirst) || (last != test_data_sub_##O##_##T[i].foundLLast)) \
+        { \
+            (void) fprintf(stderr, "%s SUB LAST (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, i, test_data_sub_##O##_##T[i].foundLast, test_data_sub_##O##_##T[i].foundLFirst, test_data_sub_##O##_##T[i].foundLLast, found, first, last); \
+            ++errors; \
+        } \
+    } \
+    return errors; \
+}
+
+define_test_find_bl(be, uint8_t)
+define_test_find_bl(be, uint16_t)
+define_test_find_bl(be, uint32_t)
+define_test_find_bl(be, uint64_t)
+define_test_find_bl(le, uint8_t)
+define_test_find_bl(le, uint16_t)
+define_test_find_bl(le, uint32_t)
+define_test_find_bl(le, uint64_t)
+
 // returns current time in nanoseconds
 uint64_t get_time()
 {
@@ -1087,6 +1295,35 @@ define_benchmark_find_last_sub(le, uint16_t)
 define_benchmark_find_last_sub(le, uint32_t)
 define_benchmark_find_last_sub(le, uint64_t)
 
+#define define_benchmark_find_first_bl(O, T) \
+void benchmark_find_first_bl_##O##_##T(mmfile_t mf, uint64_t blklen, uint64_t nrows) \
+{ \
+    uint64_t tstart, tend; \
+    uint64_t first = 0; \
+    uint64_t last = nrows; \
+    uint64_t found; \
+    int i; \
+    int size = 10000; \
+    tstart = get_time(); \
+    for (i=0 ; i < size; i++) \
+    { \
+        first = 0; \
+        last = nrows; \
+        found = find_first_bl_##O##_##T(mf.src, blklen, test_data_##O##_##T[4].blkpos, &first, &last, test_data_##O##_##T[4].search); \
+    } \
+    tend = get_time(); \
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/(uint64_t)(size*4), found); \
+}
+
+define_benchmark_find_first_bl(be, uint8_t)
+define_benchmark_find_first_bl(be, uint16_t)
+define_benchmark_find_first_bl(be, uint32_t)
+define_benchmark_find_first_bl(be, uint64_t)
+define_benchmark_find_first_bl(le, uint8_t)
+define_benchmark_find_first_bl(le, uint16_t)
+define_benchmark_find_first_bl(le, uint32_t)
+define_benchmark_find_first_bl(le, uint64_t)
+
 int main()
 {
     int errors = 0;
@@ -1150,6 +1387,42 @@ int main()
     errors += test_find_first_le_uint64_t(mf, blklen);
     errors += test_find_last_le_uint64_t(mf, blklen);
 
+    errors += test_find_batch_be_uint8_t(mf, blklen);
+    errors += test_find_batch_be_uint16_t(mf, blklen);
+    errors += test_find_batch_be_uint32_t(mf, blklen);
+    errors += test_find_batch_be_uint64_t(mf, blklen);
+    errors += test_find_batch_le_uint8_t(mf, blklen);
+    errors += test_find_batch_le_uint16_t(mf, blklen);
+    errors += test_find_batch_le_uint32_t(mf, blklen);
+    errors += test_find_batch_le_uint64_t(mf, blklen);
+
+    errors += test_find_bl_be_uint8_t(mf, blklen);
+    errors += test_find_bl_be_uint16_t(mf, blklen);
+    errors += test_find_bl_be_uint32_t(mf, blklen);
+    errors += test_find_bl_be_uint64_t(mf, blklen);
+    errors += test_find_bl_le_uint8_t(mf, blklen);
+    errors += test_find_bl_le_uint16_t(mf, blklen);
+    errors += test_find_bl_le_uint32_t(mf, blklen);
+    errors += test_find_bl_le_uint64_t(mf, blklen);
+
+    errors += test_find_range_be_uint8_t(mf, blklen);
+    errors += test_find_range_be_uint16_t(mf, blklen);
+    errors += test_find_range_be_uint32_t(mf, blklen);
+    errors += test_find_range_be_uint64_t(mf, blklen);
+    errors += test_find_range_le_uint8_t(mf, blklen);
+    errors += test_find_range_le_uint16_t(mf, blklen);
+    errors += test_find_range_le_uint32_t(mf, blklen);
+    errors += test_find_range_le_uint64_t(mf, blklen);
+
+    errors += test_scan_run_be_uint8_t(mf, blklen, nrows);
+    errors += test_scan_run_be_uint16_t(mf, blklen, nrows);
+    errors += test_scan_run_be_uint32_t(mf, blklen, nrows);
+    errors += test_scan_run_be_uint64_t(mf, blklen, nrows);
+    errors += test_scan_run_le_uint8_t(mf, blklen, nrows);
+    errors += test_scan_run_le_uint16_t(mf, blklen, nrows);
+    errors += test_scan_run_le_uint32_t(mf, blklen, nrows);
+    errors += test_scan_run_le_uint64_t(mf, blklen, nrows);
+
     benchmark_find_first_be_uint8_t(mf, blklen, nrows);
     benchmark_find_last_be_uint8_t(mf, blklen, nrows);
     benchmark_find_first_be_uint16_t(mf, blklen, nrows);
@@ -1186,6 +1459,15 @@ int main()
     benchmark_find_first_sub_le_uint64_t(mf, blklen, nrows);
     benchmark_find_last_sub_le_uint64_t(mf, blklen, nrows);
 
+    benchmark_find_first_bl_be_uint8_t(mf, blklen, nrows);
+    benchmark_find_first_bl_be_uint16_t(mf, blklen, nrows);
+    benchmark_find_first_bl_be_uint32_t(mf, blklen, nrows);
+    benchmark_find_first_bl_be_uint64_t(mf, blklen, nrows);
+    benchmark_find_first_bl_le_uint8_t(mf, blklen, nrows);
+    benchmark_find_first_bl_le_uint16_t(mf, blklen, nrows);
+    benchmark_find_first_bl_le_uint32_t(mf, blklen, nrows);
+    benchmark_find_first_bl_le_uint64_t(mf, blklen, nrows);
+
     int e = munmap_binfile(mf);
     if (e != 0)
     {
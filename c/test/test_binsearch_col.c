@@ -1,6 +1,7 @@
 // Nicola Asuni
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <errno.h>
@@ -584,6 +585,394 @@ define_test_col_find_last(uint16_t)
 define_test_col_find_last(uint32_t)
 define_test_col_find_last(uint64_t)
 
+#define define_test_col_find_bl(T) \
+int test_col_find_bl_##T(mmfile_t mf) \
+{ \
+    int errors = 0; \
+    int i; \
+    const T *src = get_src_offset_##T(mf.src, mf.index[typecolmap[sizeof(T)]]); \
+    uint8_t nbytes = (uint8_t)sizeof(T); \
+    uint8_t bitstart = ((nbytes >> 2) * 8); \
+    uint8_t bitend = ((8 * nbytes) - 1 - bitstart); \
+    uint64_t found, first, last, efound, efirst, elast; \
+    for (i=0 ; i < TEST_DATA_SIZE; i++) \
+    { \
+        first = test_col_data_##T[i].first; \
+        last = test_col_data_##T[i].last; \
+        found = col_find_first_bl_##T(src, &first, &last, test_col_data_##T[i].search); \
+        if ((found != test_col_data_##T[i].foundFirst) || (first != test_col_data_##T[i].foundFFirst) || (last != test_col_data_##T[i].foundFLast)) \
+        { \
+            (void) fprintf(stderr, "%s FIRST (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, i, test_col_data_##T[i].foundFirst, test_col_data_##T[i].foundFFirst, test_col_data_##T[i].foundFLast, found, first, last); \
+            ++errors; \
+        } \
+        first = test_col_data_##T[i].first; \
+        last = test_col_data_##T[i].last; \
+        found = col_find_last_bl_##T(src, &first, &last, test_col_data_##T[i].search); \
+        if ((found != test_col_data_##T[i].foundLast) || (first != test_col_data_##T[i].foundLFirst) || (last != test_col_data_##T[i].foundLLast)) \
+        { \
+            (void) fprintf(stderr, "%s LAST (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, i, test_col_data_##T[i].foundLast, test_col_data_##T[i].foundLFirst, test_col_data_##T[i].foundLLast, found, first, last); \
+            ++errors; \
+        } \
+        first = test_col_data_sub_##T[i].first; \
+        last = test_col_data_sub_##T[i].last; \
+        found = col_find_first_bl_sub_##T(src, bitstart, bitend, &first, &last, test_col_data_sub_##T[i].search); \
+        if ((found != test_col_data_sub_##T[i].foundFirst) || (first != test_col_data_sub_##T[i].foundFFirst) || (last != test_col_data_sub_##T[i].foundFLast)) \
+        { \
+            (void) fprintf(stderr, "%s SUB FIRST (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, i, test_col_data_sub_##T[i].foundFirst, test_col_data_sub_##T[i].foundFFirst, test_col_data_sub_##T[i].foundFLast, found, first, last); \
+            ++errors; \
+        } \
+        first = test_col_data_sub_##T[i].first; \
+        last = test_col_data_sub_##T[i].last; \
+        found = col_find_last_bl_sub_##T(src, bitstart, bitend, &first, &last, test_col_data_sub_##T[i].search); \
+        if ((found != test_col_data_sub_##T[i].foundLast) || (first != test_col_data_sub_##T[i].foundLFirst) || (last != test_col_data_sub_##T[i].foundLLast)) \
+        { \
+            (void) fprintf(stderr, "%s SUB LAST (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, i, test_col_data_sub_##T[i].foundLast, test_col_data_sub_##T[i].foundLFirst, test_col_data_sub_##T[i].foundLLast, found, first, last); \
+            ++errors; \
+        } \
+    } \
+    for (i=0 ; i < (2 * TEST_DATA_ITEMS); i++) \
+    { \
+        first = efirst = (uint64_t)(i % 7); \
+        last = elast = (TEST_DATA_ITEMS - (uint64_t)(i % 5)); \
+        efound = col_find_first_##T(src, &efirst, &elast, (T)(src[(i >> 1)] + (i & 1))); \
+        found = col_find_first_bl_##T(src, &first, &last, (T)(src[(i >> 1)] + (i & 1))); \
+        if ((found != efound) || (first != efirst) || (last != elast)) \
+        { \
+            (void) fprintf(stderr, "%s FIRST (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, i, efound, efirst, elast, found, first, last); \
+            ++errors; \
+        } \
+        first = efirst = (uint64_t)(i % 7); \
+        last = elast = (TEST_DATA_ITEMS - (uint64_t)(i % 5)); \
+        efound = col_find_last_##T(src, &efirst, &elast, (T)(src[(i >> 1)] + (i & 1))); \
+        found = col_find_last_bl_##T(src, &first, &last, (T)(src[(i >> 1)] + (i & 1))); \
+        if ((found != efound) || (first != efirst) || (last != elast)) \
+        { \
+            (void) fprintf(stderr, "%s LAST (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, i, efound, efirst, elast, found, first, last); \
+            ++errors; \
+        } \
+    } \
+    return errors; \
+}
+
+define_test_col_find_bl(uint8_t)
+define_test_col_find_bl(uint16_t)
+define_test_col_find_bl(uint32_t)
+define_test_col_find_bl(uint64_t)
+
+#define define_test_col_find_range(T) \
+int test_col_find_range_##T(mmfile_t mf) \
+{ \
+    int errors = 0; \
+    int i; \
+    const T *src = get_src_offset_##T(mf.src, mf.index[typecolmap[sizeof(T)]]); \
+    uint8_t nbytes = (uint8_t)sizeof(T); \
+    uint8_t bitstart = ((nbytes >> 2) * 8); \
+    uint8_t bitend = ((8 * nbytes) - 1 - bitstart); \
+    uint64_t count, first, last, efirst, elast; \
+    for (i=0 ; i < TEST_DATA_SIZE; i++) \
+    { \
+        first = test_col_data_##T[i].first; \
+        last = test_col_data_##T[i].last; \
+        efirst = (test_col_data_##T[i].foundFirst < test_col_data_##T[i].last) ? test_col_data_##T[i].foundFirst : test_col_data_##T[i].foundFLast; \
+        elast = (test_col_data_##T[i].foundFirst < test_col_data_##T[i].last) ? (test_col_data_##T[i].foundLast + 1) : test_col_data_##T[i].foundFLast; \
+        count = col_find_range_##T(src, &first, &last, test_col_data_##T[i].search); \
+        if ((first != efirst) || (last != elast) || (count != (elast - efirst))) \
+        { \
+            (void) fprintf(stderr, "%s (%d) Expected [%" PRIx64 ", %" PRIx64 "), got [%" PRIx64 ", %" PRIx64 ") %" PRIu64 "\n", __func__, i, efirst, elast, first, last, count); \
+            ++errors; \
+        } \
+        first = test_col_data_sub_##T[i].first; \
+        last = test_col_data_sub_##T[i].last; \
+        efirst = (test_col_data_sub_##T[i].foundFirst < test_col_data_sub_##T[i].last) ? test_col_data_sub_##T[i].foundFirst : test_col_data_sub_##T[i].foundFLast; \
+        elast = (test_col_data_sub_##T[i].foundFirst < test_col_data_sub_##T[i].last) ? (test_col_data_sub_##T[i].foundLast + 1) : test_col_data_sub_##T[i].foundFLast; \
+        count = col_find_range_sub_##T(src, bitstart, bitend, &first, &last, test_col_data_sub_##T[i].search); \
+        if ((first != efirst) || (last != elast) || (count != (elast - efirst))) \
+        { \
+            (void) fprintf(stderr, "%s SUB (%d) Expected [%" PRIx64 ", %" PRIx64 "), got [%" PRIx64 ", %" PRIx64 ") %" PRIu64 "\n", __func__, i, efirst, elast, first, last, count); \
+            ++errors; \
+        } \
+    } \
+    for (i=0 ; i < (2 * TEST_DATA_ITEMS); i++) \
+    { \
+        first = (uint64_t)(i % 7); \
+        last = (TEST_DATA_ITEMS - (uint64_t)(i % 5)); \
+        count = col_find_range_sub_##T(src, 0, (uint8_t)((8 * nbytes) - 5), &first, &last, (T)((src[(i >> 1)] >> 4) + (i & 1))); \
+        efirst = (uint64_t)(i % 7); \
+        elast = (TEST_DATA_ITEMS - (uint64_t)(i % 5)); \
+        while ((efirst < elast) && ((T)(src[efirst] >> 4) < (T)((src[(i >> 1)] >> 4) + (i & 1)))) \
+        { \
+            ++efirst; \
+        } \
+        while ((elast > efirst) && ((T)(src[(elast - 1)] >> 4) > (T)((src[(i >> 1)] >> 4) + (i & 1)))) \
+        { \
+            --elast; \
+        } \
+        if ((first != efirst) || (last != elast) || (count != (elast - efirst))) \
+        { \
+            (void) fprintf(stderr, "%s SCAN (%d) Expected [%" PRIx64 ", %" PRIx64 "), got [%" PRIx64 ", %" PRIx64 ") %" PRIu64 "\n", __func__, i, efirst, elast, first, last, count); \
+            ++errors; \
+        } \
+    } \
+    return errors; \
+}
+
+define_test_col_find_range(uint8_t)
+define_test_col_find_range(uint16_t)
+define_test_col_find_range(uint32_t)
+define_test_col_find_range(uint64_t)
+
+#define define_test_col_scan_run(T) \
+int test_col_scan_run_##T(mmfile_t mf) \
+{ \
+    int errors = 0; \
+    const T *src = get_src_offset_##T(mf.src, mf.index[typecolmap[sizeof(T)]]); \
+    uint8_t nbytes = (uint8_t)sizeof(T); \
+    uint8_t bitend = ((8 * nbytes) - 5); \
+    uint64_t i, pos, end, exp, count, out[3]; \
+    T search; \
+    for (i = 0; i < TEST_DATA_ITEMS; i++) \
+    { \
+        search = src[i]; \
+        exp = i; \
+        while ((exp < TEST_DATA_ITEMS) && (src[exp] == search)) \
+        { \
+            ++exp; \
+        } \
+        end = col_scan_run_##T(src, i, TEST_DATA_ITEMS, search); \
+        if (end != exp) \
+        { \
+            (void) fprintf(stderr, "%s (%" PRIu64 ") Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, exp, end); \
+            ++errors; \
+        } \
+        search = (T)(src[i] >> 4); \
+        exp = i; \
+        while ((exp < TEST_DATA_ITEMS) && ((T)(src[exp] >> 4) == search)) \
+        { \
+            ++exp; \
+        } \
+        end = col_scan_run_sub_##T(src, 0, bitend, i, TEST_DATA_ITEMS, search); \
+        if (end != exp) \
+        { \
+            (void) fprintf(stderr, "%s SUB (%" PRIu64 ") Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, exp, end); \
+            ++errors; \
+        } \
+        pos = i; \
+        end = i; \
+        while ((count = col_fill_run_sub_##T(src, 0, bitend, &pos, TEST_DATA_ITEMS, search, out, 3)) > 0) \
+        { \
+            if ((out[0] != end) || (out[(count - 1)] != (end + count - 1))) \
+            { \
+                (void) fprintf(stderr, "%s FILL SUB (%" PRIu64 ") Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, end, out[0]); \
+                ++errors; \
+            } \
+            end += count; \
+        } \
+        if ((pos != exp) || (end != pos)) \
+        { \
+            (void) fprintf(stderr, "%s FILL SUB (%" PRIu64 ") Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, exp, pos); \
+            ++errors; \
+        } \
+    } \
+    if (col_scan_run_sub_##T(src, 0, bitend, 0, TEST_DATA_ITEMS, (T)~(T)0) != 0) \
+    { \
+        (void) fprintf(stderr, "%s SUB Expected no match for an out of mask value\n", __func__); \
+        ++errors; \
+    } \
+    pos = 7; \
+    if ((col_fill_run_##T(src, &pos, 7, src[7], out, 3) != 0) || (pos != 7)) \
+    { \
+        (void) fprintf(stderr, "%s FILL Expected empty range\n", __func__); \
+        ++errors; \
+    } \
+    return errors; \
+}
+
+define_test_col_scan_run(uint8_t)
+define_test_col_scan_run(uint16_t)
+define_test_col_scan_run(uint32_t)
+define_test_col_scan_run(uint64_t)
+
+#define define_test_col_find_batch(T) \
+int test_col_find_batch_##T(mmfile_t mf) \
+{ \
+    int errors = 0; \
+    int i; \
+    const T *src = get_src_offset_##T(mf.src, mf.index[typecolmap[sizeof(T)]]); \
+    T search[TEST_DATA_SIZE]; \
+    uint64_t ffound[TEST_DATA_SIZE], lfound[TEST_DATA_SIZE], first, last, found; \
+    for (i=0 ; i < TEST_DATA_SIZE; i++) \
+    { \
+        col_find_first_batch_##T(src, test_col_data_##T[i].first, test_col_data_##T[i].last, &test_col_data_##T[i].search, &ffound[i], 1); \
+        if (ffound[i] != test_col_data_##T[i].foundFirst) \
+        { \
+            (void) fprintf(stderr, "%s FIRST (%d) Expected found %" PRIx64 ", got %" PRIx64 "\n", __func__, i, test_col_data_##T[i].foundFirst, ffound[i]); \
+            ++errors; \
+        } \
+        col_find_last_batch_##T(src, test_col_data_##T[i].first, test_col_data_##T[i].last, &test_col_data_##T[i].search, &lfound[i], 1); \
+        if (lfound[i] != test_col_data_##T[i].foundLast) \
+        { \
+            (void) fprintf(stderr, "%s LAST (%d) Expected found %" PRIx64 ", got %" PRIx64 "\n", __func__, i, test_col_data_##T[i].foundLast, lfound[i]); \
+            ++errors; \
+        } \
+        search[i] = test_col_data_##T[i].search; \
+    } \
+    col_find_first_batch_##T(src, 0, TEST_DATA_ITEMS, search, ffound, TEST_DATA_SIZE); \
+    col_find_last_batch_##T(src, 0, TEST_DATA_ITEMS, search, lfound, TEST_DATA_SIZE); \
+    for (i=0 ; i < TEST_DATA_SIZE; i++) \
+    { \
+        first = 0; \
+        last = TEST_DATA_ITEMS; \
+        found = col_find_first_##T(src, &first, &last, search[i]); \
+        if (ffound[i] != found) \
+        { \
+            (void) fprintf(stderr, "%s BATCH FIRST (%d) Expected found %" PRIx64 ", got %" PRIx64 "\n", __func__, i, found, ffound[i]); \
+            ++errors; \
+        } \
+        first = 0; \
+        last = TEST_DATA_ITEMS; \
+        found = col_find_last_##T(src, &first, &last, search[i]); \
+        if (lfound[i] != found) \
+        { \
+            (void) fprintf(stderr, "%s BATCH LAST (%d) Expected found %" PRIx64 ", got %" PRIx64 "\n", __func__, i, found, lfound[i]); \
+            ++errors; \
+        } \
+    } \
+    col_find_first_batch_##T(src, 7, 7, search, ffound, TEST_DATA_SIZE); \
+    col_find_last_batch_##T(src, 7, 7, search, lfound, TEST_DATA_SIZE); \
+    for (i=0 ; i < TEST_DATA_SIZE; i++) \
+    { \
+        if ((ffound[i] != 7) || (lfound[i] != 7)) \
+        { \
+            (void) fprintf(stderr, "%s EMPTY (%d) Expected not found, got %" PRIx64 " %" PRIx64 "\n", __func__, i, ffound[i], lfound[i]); \
+            ++errors; \
+        } \
+    } \
+    return errors; \
+}
+
+define_test_col_find_batch(uint8_t)
+define_test_col_find_batch(uint16_t)
+define_test_col_find_batch(uint32_t)
+define_test_col_find_batch(uint64_t)
+
+// returns the first row with a tuple not less (or greater if upper) than the key, scanning all the rows
+uint64_t test_tuple_bound(mmfile_t mf, const uint8_t *cols, uint8_t ncols, const uint64_t *key, bool upper)
+{
+    uint64_t i, v;
+    uint8_t c;
+    for (i = 0; i < TEST_DATA_ITEMS; i++)
+    {
+        for (c = 0; c < ncols; c++)
+        {
+            switch (mf.ctbytes[cols[c]])
+            {
+            case 1:
+                v = get_src_offset_uint8_t(mf.src, mf.index[cols[c]])[i];
+                break;
+            case 2:
+                v = get_src_offset_uint16_t(mf.src, mf.index[cols[c]])[i];
+                break;
+            case 4:
+                v = get_src_offset_uint32_t(mf.src, mf.index[cols[c]])[i];
+                break;
+            default:
+                v = get_src_offset_uint64_t(mf.src, mf.index[cols[c]])[i];
+                break;
+            }
+            if (v != key[c])
+            {
+                break;
+            }
+        }
+        if ((c < ncols) ? (v > key[c]) : !upper)
+        {
+            return i;
+        }
+    }
+    return TEST_DATA_ITEMS;
+}
+
+int test_col_find_range_cols(mmfile_t mf)
+{
+    int errors = 0;
+    const uint8_t cols[] = {0, 1, 2, 3};
+    uint64_t key[(2 * TEST_DATA_ITEMS * 4)];
+    uint64_t rfirst[(2 * TEST_DATA_ITEMS)], rlast[(2 * TEST_DATA_ITEMS)];
+    uint64_t i, first, last, efirst, elast, count;
+    uint8_t ncols;
+    for (ncols = 1; ncols <= 4; ncols++)
+    {
+        for (i = 0; i < (2 * TEST_DATA_ITEMS); i++)
+        {
+            key[((i * ncols) + 0)] = get_src_offset_uint8_t(mf.src, mf.index[0])[(i >> 1)];
+            if (ncols > 1)
+            {
+                key[((i * ncols) + 1)] = get_src_offset_uint16_t(mf.src, mf.index[1])[(i >> 1)];
+            }
+            if (ncols > 2)
+            {
+                key[((i * ncols) + 2)] = get_src_offset_uint32_t(mf.src, mf.index[2])[(i >> 1)];
+            }
+            if (ncols > 3)
+            {
+                key[((i * ncols) + 3)] = get_src_offset_uint64_t(mf.src, mf.index[3])[(i >> 1)];
+            }
+            key[((i * ncols) + (ncols - 1))] += (i & 1); // existing and next value of the last column
+        }
+        col_find_range_cols_batch(&mf, cols, ncols, key, 0, TEST_DATA_ITEMS, rfirst, rlast, (2 * TEST_DATA_ITEMS));
+        for (i = 0; i < (2 * TEST_DATA_ITEMS); i++)
+        {
+            efirst = test_tuple_bound(mf, cols, ncols, (key + (i * ncols)), false);
+            elast = test_tuple_bound(mf, cols, ncols, (key + (i * ncols)), true);
+            first = 0;
+            last = TEST_DATA_ITEMS;
+            count = col_find_range_cols(&mf, cols, ncols, (key + (i * ncols)), &first, &last);
+            if ((first != efirst) || (last != elast) || (count != (elast - efirst)))
+            {
+                (void) fprintf(stderr, "%s (%u, %" PRIu64 ") Expected [%" PRIu64 ", %" PRIu64 "), got [%" PRIu64 ", %" PRIu64 ")\n", __func__, ncols, i, efirst, elast, first, last);
+                ++errors;
+            }
+            if ((rfirst[i] != efirst) || (rlast[i] != elast))
+            {
+                (void) fprintf(stderr, "%s BATCH (%u, %" PRIu64 ") Expected [%" PRIu64 ", %" PRIu64 "), got [%" PRIu64 ", %" PRIu64 ")\n", __func__, ncols, i, efirst, elast, rfirst[i], rlast[i]);
+                ++errors;
+            }
+        }
+    }
+    key[0] = 0x100; // out of the uint8_t range
+    first = 0;
+    last = TEST_DATA_ITEMS;
+    if ((col_find_range_cols(&mf, cols, 1, key, &first, &last) != 0) || (first != last))
+    {
+        (void) fprintf(stderr, "%s Expected not found for an out of range value\n", __func__);
+        ++errors;
+    }
+    col_find_range_cols_batch(&mf, cols, 1, key, 0, TEST_DATA_ITEMS, rfirst, rlast, 1);
+    if (rfirst[0] != rlast[0])
+    {
+        (void) fprintf(stderr, "%s BATCH Expected not found for an out of range value\n", __func__);
+        ++errors;
+    }
+    const uint8_t badcols[] = {4}; // the file has 4 columns
+    mf.ctbytes[4] = mf.ctbytes[3]; // stale column definition after the last column
+    mf.index[4] = mf.index[3];
+    key[0] = *get_src_offset_uint64_t(mf.src, mf.index[3]);
+    first = 0;
+    last = TEST_DATA_ITEMS;
+    if ((col_find_range_cols(&mf, badcols, 1, key, &first, &last) != 0) || (first != last))
+    {
+        (void) fprintf(stderr, "%s Expected not found for an invalid column\n", __func__);
+        ++errors;
+    }
+    col_find_range_cols_batch(&mf, badcols, 1, key, 0, TEST_DATA_ITEMS, rfirst, rlast, 1);
+    if (rfirst[0] != rlast[0])
+    {
+        (void) fprintf(stderr, "%s BATCH Expected not found for an invalid column\n", __func__);
+        ++errors;
+    }
+    return errors;
+}
+
 // returns current time in nanoseconds
 uint64_t get_time()
 {
@@ -592,6 +981,66 @@ uint64_t get_time()
     return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
 }
 
+// The 128 bit searches must match the uint64_t column results when the 64 bit values are stored in either word.
+int test_col_find_uint128_t(mmfile_t mf)
+{
+    int errors = 0;
+    int i, w;
+    const uint64_t *col = get_src_offset_uint64_t(mf.src, mf.index[typecolmap[8]]);
+    uint64_t src[(2 * TEST_DATA_ITEMS)];
+    uint64_t ffound, lfound, first, last, numitems, counter, pos, shi, slo;
+    for (w = 0; w < 2; w++)
+    {
+        for (i=0 ; i < TEST_DATA_ITEMS; i++)
+        {
+            src[(2 * i) + w] = col[i];
+            src[(2 * i) + 1 - w] = 0;
+        }
+        for (i=0 ; i < TEST_DATA_SIZE; i++)
+        {
+            shi = (w == 1) ? test_col_data_uint64_t[i].search : 0;
+            slo = (w == 0) ? test_col_data_uint64_t[i].search : 0;
+            first = test_col_data_uint64_t[i].first;
+            last = test_col_data_uint64_t[i].last;
+            ffound = col_find_first_uint128_t(src, &first, &last, shi, slo);
+            if ((ffound != test_col_data_uint64_t[i].foundFirst) || (first != test_col_data_uint64_t[i].foundFFirst) || (last != test_col_data_uint64_t[i].foundFLast))
+            {
+                (void) fprintf(stderr, "%s FIRST %d (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, w, i, test_col_data_uint64_t[i].foundFirst, test_col_data_uint64_t[i].foundFFirst, test_col_data_uint64_t[i].foundFLast, ffound, first, last);
+                ++errors;
+            }
+            first = test_col_data_uint64_t[i].first;
+            last = test_col_data_uint64_t[i].last;
+            lfound = col_find_last_uint128_t(src, &first, &last, shi, slo);
+            if ((lfound != test_col_data_uint64_t[i].foundLast) || (first != test_col_data_uint64_t[i].foundLFirst) || (last != test_col_data_uint64_t[i].foundLLast))
+            {
+                (void) fprintf(stderr, "%s LAST %d (%d) Expected %" PRIx64 " [%" PRIx64 ", %" PRIx64 "], got %" PRIx64 " [%" PRIx64 ", %" PRIx64 "]\n", __func__, w, i, test_col_data_uint64_t[i].foundLast, test_col_data_uint64_t[i].foundLFirst, test_col_data_uint64_t[i].foundLLast, lfound, first, last);
+                ++errors;
+            }
+            numitems = (test_col_data_uint64_t[i].foundLast - test_col_data_uint64_t[i].foundFirst);
+            if (ffound <= test_col_data_uint64_t[i].last)
+            {
+                pos = ffound;
+                counter = 0;
+                while (col_has_next_uint128_t(src, &pos, test_col_data_uint64_t[i].last, shi, slo))
+                {
+                    counter++;
+                }
+                pos = lfound;
+                while (col_has_prev_uint128_t(src, test_col_data_uint64_t[i].first, &pos, shi, slo))
+                {
+                    counter++;
+                }
+                if (counter != (2 * numitems))
+                {
+                    (void) fprintf(stderr, "%s HAS_NEXT/PREV %d (%d) Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, w, i, (2 * numitems), counter);
+                    ++errors;
+                }
+            }
+        }
+    }
+    return errors;
+}
+
 #define define_benchmark_col_find_first(T) \
 void benchmark_col_find_first_##T(mmfile_t mf) \
 { \
@@ -702,6 +1151,214 @@ define_benchmark_col_find_last_sub(uint16_t)
 define_benchmark_col_find_last_sub(uint32_t)
 define_benchmark_col_find_last_sub(uint64_t)
 
+// shared synthetic column for the large benchmarks below (8 MB: larger than the L2 cache, small enough for a smoke test)
+#define TEST_BATCH_ITEMS 0x100000
+#define TEST_BATCH_SEARCHES 0x10000
+#define TEST_SMALL_ITEMS 0x1000 // fits in the L1/L2 cache
+#define TEST_DUP_ITEMS 4096 // number of duplicates of each value
+#define TEST_RUN_ITEMS (16 * TEST_DUP_ITEMS) // runs scanned repeatedly (fits in the L2 cache)
+
+uint64_t *benchmark_batch_data()
+{
+    uint64_t i;
+    uint64_t *src = (uint64_t *)malloc(TEST_BATCH_ITEMS * sizeof(uint64_t));
+    if (src != NULL)
+    {
+        for (i=0 ; i < TEST_BATCH_ITEMS; i++)
+        {
+            src[i] = (i * 3);
+        }
+    }
+    return src;
+}
+
+void benchmark_col_find_first_scalar_large(const uint64_t *src)
+{
+    uint64_t tstart, tend, first, last, i, sum = 0;
+    tstart = get_time();
+    for (i=0 ; i < TEST_BATCH_SEARCHES; i++)
+    {
+        first = 0;
+        last = TEST_BATCH_ITEMS;
+        sum += col_find_first_uint64_t(src, &first, &last, (((i * 0x9e3779b1) % TEST_BATCH_ITEMS) * 3));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/TEST_BATCH_SEARCHES, sum);
+}
+
+void benchmark_col_find_first_batch_large(const uint64_t *src)
+{
+    uint64_t tstart, tend, i, j, sum = 0;
+    uint64_t search[1024];
+    uint64_t out[1024];
+    tstart = get_time();
+    for (i=0 ; i < TEST_BATCH_SEARCHES; i += 1024)
+    {
+        for (j=0 ; j < 1024; j++)
+        {
+            search[j] = ((((i + j) * 0x9e3779b1) % TEST_BATCH_ITEMS) * 3);
+        }
+        col_find_first_batch_uint64_t(src, 0, TEST_BATCH_ITEMS, search, out, 1024);
+        for (j=0 ; j < 1024; j++)
+        {
+            sum += out[j];
+        }
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/TEST_BATCH_SEARCHES, sum);
+}
+
+void benchmark_col_find_first_bl_large(const uint64_t *src)
+{
+    uint64_t tstart, tend, first, last, i, sum = 0;
+    tstart = get_time();
+    for (i=0 ; i < TEST_BATCH_SEARCHES; i++)
+    {
+        first = 0;
+        last = TEST_BATCH_ITEMS;
+        sum += col_find_first_bl_uint64_t(src, &first, &last, (((i * 0x9e3779b1) % TEST_BATCH_ITEMS) * 3));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/TEST_BATCH_SEARCHES, sum);
+}
+
+void benchmark_col_find_first_scalar_small(const uint64_t *src)
+{
+    uint64_t tstart, tend, first, last, i, sum = 0;
+    tstart = get_time();
+    for (i=0 ; i < TEST_BATCH_SEARCHES; i++)
+    {
+        first = 0;
+        last = TEST_SMALL_ITEMS;
+        sum += col_find_first_uint64_t(src, &first, &last, (((i * 0x9e3779b1) % TEST_SMALL_ITEMS) * 3));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/TEST_BATCH_SEARCHES, sum);
+}
+
+void benchmark_col_find_first_bl_small(const uint64_t *src)
+{
+    uint64_t tstart, tend, first, last, i, sum = 0;
+    tstart = get_time();
+    for (i=0 ; i < TEST_BATCH_SEARCHES; i++)
+    {
+        first = 0;
+        last = TEST_SMALL_ITEMS;
+        sum += col_find_first_bl_uint64_t(src, &first, &last, (((i * 0x9e3779b1) % TEST_SMALL_ITEMS) * 3));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/TEST_BATCH_SEARCHES, sum);
+}
+
+void benchmark_col_find_first_last_dup(const uint64_t *src)
+{
+    uint64_t tstart, tend, first, last, i, sum = 0;
+    tstart = get_time();
+    for (i=0 ; i < TEST_BATCH_SEARCHES; i++)
+    {
+        first = 0;
+        last = TEST_BATCH_ITEMS;
+        sum += col_find_first_uint64_t(src, &first, &last, (((i * 0x9e3779b1) % TEST_BATCH_ITEMS) / TEST_DUP_ITEMS));
+        first = 0;
+        last = TEST_BATCH_ITEMS;
+        sum += col_find_last_uint64_t(src, &first, &last, (((i * 0x9e3779b1) % TEST_BATCH_ITEMS) / TEST_DUP_ITEMS));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/TEST_BATCH_SEARCHES, sum);
+}
+
+void benchmark_col_find_range_dup(const uint64_t *src)
+{
+    uint64_t tstart, tend, first, last, i, sum = 0;
+    tstart = get_time();
+    for (i=0 ; i < TEST_BATCH_SEARCHES; i++)
+    {
+        first = 0;
+        last = TEST_BATCH_ITEMS;
+        (void) col_find_range_uint64_t(src, &first, &last, (((i * 0x9e3779b1) % TEST_BATCH_ITEMS) / TEST_DUP_ITEMS));
+        sum += (first + (last - 1));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/TEST_BATCH_SEARCHES, sum);
+}
+
+void benchmark_col_has_next_run(const uint64_t *src)
+{
+    uint64_t tstart, tend, i, pos, sum = 0;
+    tstart = get_time();
+    for (i=0 ; i < (TEST_BATCH_ITEMS / 16); i += TEST_DUP_ITEMS)
+    {
+        pos = (i % TEST_RUN_ITEMS);
+        while (col_has_next_uint64_t(src, &pos, TEST_BATCH_ITEMS, src[(i % TEST_RUN_ITEMS)])) {}
+        sum += pos;
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/run (%" PRIx64 ")\n", __func__, (tend - tstart)/((TEST_BATCH_ITEMS / 16) / TEST_DUP_ITEMS), sum);
+}
+
+void benchmark_col_scan_run(const uint64_t *src)
+{
+    uint64_t tstart, tend, i, sum = 0;
+    tstart = get_time();
+    for (i=0 ; i < (TEST_BATCH_ITEMS / 16); i += TEST_DUP_ITEMS)
+    {
+        sum += col_scan_run_uint64_t(src, (i % TEST_RUN_ITEMS), TEST_BATCH_ITEMS, src[(i % TEST_RUN_ITEMS)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/run (%" PRIx64 ")\n", __func__, (tend - tstart)/((TEST_BATCH_ITEMS / 16) / TEST_DUP_ITEMS), sum);
+}
+
+// rebuilds the shared benchmark buffer as two columns: the caller must refill it before reusing it
+void benchmark_col_find_range_cols(uint64_t *src)
+{
+    uint64_t tstart, tend, first, last, i, j, sum = 0;
+    const uint8_t cols[] = {0, 1};
+    uint64_t key[(2 * 1024)];
+    uint64_t rfirst[1024], rlast[1024];
+    mmfile_t mf = {0};
+    mf.src = (uint8_t *)src; // first half: uint64_t column, second half: uint32_t column
+    mf.ncols = 2;
+    mf.ctbytes[0] = 8;
+    mf.ctbytes[1] = 4;
+    mf.index[0] = 0;
+    mf.index[1] = ((TEST_BATCH_ITEMS / 2) * sizeof(uint64_t));
+    uint64_t *c0 = src;
+    uint32_t *c1 = (uint32_t *)(src + (TEST_BATCH_ITEMS / 2));
+    for (i=0 ; i < (TEST_BATCH_ITEMS / 2); i++)
+    {
+        c0[i] = ((i / 8) * 3);
+        c1[i] = (uint32_t)((i % 8) * 5);
+    }
+    tstart = get_time();
+    for (i=0 ; i < TEST_BATCH_SEARCHES; i++)
+    {
+        key[0] = ((((i * 0x9e3779b1) % (TEST_BATCH_ITEMS / 2)) / 8) * 3);
+        key[1] = ((i % 8) * 5);
+        first = 0;
+        last = (TEST_BATCH_ITEMS / 2);
+        sum += col_find_range_cols(&mf, cols, 2, key, &first, &last) + first;
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/TEST_BATCH_SEARCHES, sum);
+    sum = 0;
+    tstart = get_time();
+    for (i=0 ; i < TEST_BATCH_SEARCHES; i += 1024)
+    {
+        for (j=0 ; j < 1024; j++)
+        {
+            key[(2 * j)] = (((((i + j) * 0x9e3779b1) % (TEST_BATCH_ITEMS / 2)) / 8) * 3);
+            key[((2 * j) + 1)] = (((i + j) % 8) * 5);
+        }
+        col_find_range_cols_batch(&mf, cols, 2, key, 0, (TEST_BATCH_ITEMS / 2), rfirst, rlast, 1024);
+        for (j=0 ; j < 1024; j++)
+        {
+            sum += (rlast[j] - rfirst[j]) + rfirst[j];
+        }
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s batch : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/TEST_BATCH_SEARCHES, sum);
+}
+
 int main()
 {
     int errors = 0;
@@ -746,6 +1403,28 @@ int main()
     errors += test_col_find_last_uint32_t(mf);
     errors += test_col_find_first_uint64_t(mf);
     errors += test_col_find_last_uint64_t(mf);
+    errors += test_col_find_batch_uint8_t(mf);
+    errors += test_col_find_batch_uint16_t(mf);
+    errors += test_col_find_batch_uint32_t(mf);
+    errors += test_col_find_batch_uint64_t(mf);
+
+    errors += test_col_find_bl_uint8_t(mf);
+    errors += test_col_find_bl_uint16_t(mf);
+    errors += test_col_find_bl_uint32_t(mf);
+    errors += test_col_find_bl_uint64_t(mf);
+
+    errors += test_col_find_range_uint8_t(mf);
+    errors += test_col_find_range_uint16_t(mf);
+    errors += test_col_find_range_uint32_t(mf);
+    errors += test_col_find_range_uint64_t(mf);
+
+    errors += test_col_scan_run_uint8_t(mf);
+    errors += test_col_scan_run_uint16_t(mf);
+    errors += test_col_scan_run_uint32_t(mf);
+    errors += test_col_scan_run_uint64_t(mf);
+
+    errors += test_col_find_range_cols(mf);
+    errors += test_col_find_uint128_t(mf);
 
     benchmark_col_find_first_uint8_t(mf);
     benchmark_col_find_last_uint8_t(mf);
@@ -765,6 +1444,27 @@ int main()
     benchmark_col_find_first_sub_uint64_t(mf);
     benchmark_col_find_last_sub_uint64_t(mf);
 
+    uint64_t i;
+    uint64_t *large = benchmark_batch_data();
+    if (large != NULL)
+    {
+        benchmark_col_find_first_scalar_small(large);
+        benchmark_col_find_first_bl_small(large);
+        benchmark_col_find_first_scalar_large(large);
+        benchmark_col_find_first_bl_large(large);
+        benchmark_col_find_first_batch_large(large);
+        for (i=0 ; i < TEST_BATCH_ITEMS; i++)
+        {
+            large[i] = (i / TEST_DUP_ITEMS);
+        }
+        benchmark_col_find_first_last_dup(large);
+        benchmark_col_find_range_dup(large);
+        benchmark_col_has_next_run(large);
+        benchmark_col_scan_run(large);
+        benchmark_col_find_range_cols(large);
+        free(large);
+    }
+
     int e = munmap_binfile(mf);
     if (e != 0)
     {
@@ -0,0 +1,212 @@
+// NumKey
+//
+// test_bitpack.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for bitpack
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/bitpack.h"
+#include "../src/numkey/numkey.h"
+
+#define TEST_BITPACK_ITEMS 1000000
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+static inline uint64_t xorshift64(uint64_t *s)
+{
+    *s ^= (*s << 13);
+    *s ^= (*s >> 7);
+    *s ^= (*s << 17);
+    return *s;
+}
+
+// generates a sorted column of NumKeys over a few countries with random gaps and some duplicates
+static inline uint64_t *test_keys(uint64_t nkeys)
+{
+    static const char *country[] = {"DE", "GB", "IT", "US"};
+    uint64_t *keys = (uint64_t *)malloc(((nkeys > 0) ? nkeys : 1) * sizeof(uint64_t));
+    uint64_t s = 0x9e3779b97f4a7c15, num = 0, i = 0, c = 0;
+    for (i = 0; i < nkeys; i++)
+    {
+        if ((i % (nkeys / 4 + 1)) == 0)
+        {
+            num = 440000000000;
+            c = (i / (nkeys / 4 + 1));
+        }
+        num += (xorshift64(&s) % 2000); // the gap is zero for some keys
+        keys[i] = (numkey(country[c], "", 0) | (num << NKBSHIFT_NUMBER) | 12);
+    }
+    return keys;
+}
+
+int test_bitpack_keys(const uint64_t *keys, uint64_t nkeys)
+{
+    int errors = 0;
+    uint64_t i = 0, size = 0, pos = 0, blk = 0, bsize = 0;
+    uint64_t buf[NKBITPACK_BLOCK];
+    bitpack_t bp;
+    uint8_t *blob = bitpack_build(keys, nkeys, &size);
+    if ((blob == NULL) || !bitpack_load(blob, size, &bp) || (bp.nkeys != nkeys))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Unable to build the compressed column\n", __func__, nkeys);
+        free(blob);
+        return 1;
+    }
+    for (blk = 0; blk < bp.nblocks; blk++)
+    {
+        bitpack_unpack_block(&bp, blk, buf);
+        bsize = bitpack_block_size(&bp, blk);
+        for (i = 0; i < bsize; i++)
+        {
+            if (buf[i] != keys[((blk * NKBITPACK_BLOCK) + i)])
+            {
+                (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected unpacked key %" PRIu64 " in block %" PRIu64 "\n", __func__, nkeys, i, blk);
+                ++errors;
+            }
+        }
+    }
+    for (i = 0; i < nkeys; i++)
+    {
+        if (bitpack_get(&bp, i) != keys[i])
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected key %" PRIu64 "\n", __func__, nkeys, i);
+            ++errors;
+        }
+        pos = bitpack_find_first(&bp, keys[i]);
+        if ((pos > i) || (keys[pos] != keys[i]) || ((pos > 0) && (keys[(pos - 1)] == keys[i])))
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected position %" PRIu64 " for key %" PRIu64 "\n", __func__, nkeys, pos, i);
+            ++errors;
+        }
+        if (((i == 0) || (keys[(i - 1)] < (keys[i] - 1))) && (keys[i] > 0) && (bitpack_find_first(&bp, (keys[i] - 1)) != nkeys))
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ") : Expected missing key before %" PRIu64 "\n", __func__, nkeys, i);
+            ++errors;
+        }
+    }
+    if ((nkeys > 0) && (keys[(nkeys - 1)] < UINT64_MAX) && (bitpack_find_first(&bp, (keys[(nkeys - 1)] + 1)) != nkeys))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Expected missing key after the last one\n", __func__, nkeys);
+        ++errors;
+    }
+    if (bitpack_load(blob, (size - 8), &bp))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Expected invalid blob size\n", __func__, nkeys);
+        ++errors;
+    }
+    free(blob);
+    return errors;
+}
+
+int test_bitpack()
+{
+    int errors = 0;
+    uint64_t *keys = test_keys(100000);
+    errors += test_bitpack_keys(keys, 0);
+    errors += test_bitpack_keys(keys, 1);
+    errors += test_bitpack_keys(keys, 129);
+    errors += test_bitpack_keys(keys, 100000);
+    uint64_t same[300];
+    uint64_t i = 0;
+    for (i = 0; i < 300; i++)
+    {
+        same[i] = ((i < 130) ? 0 : ((i < 260) ? 0x123456789abcdef0 : UINT64_MAX)); // 0 and 64 bit blocks
+    }
+    errors += test_bitpack_keys(same, 300);
+    free(keys);
+    return errors;
+}
+
+void benchmark_bitpack_find_first()
+{
+    uint64_t i = 0, size = 0, sum = 0;
+    uint64_t *keys = test_keys(TEST_BITPACK_ITEMS);
+    bitpack_t bp;
+    uint8_t *blob = bitpack_build(keys, TEST_BITPACK_ITEMS, &size);
+    if ((blob == NULL) || !bitpack_load(blob, size, &bp))
+    {
+        free(blob);
+        free(keys);
+        return;
+    }
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_BITPACK_ITEMS; i++)
+    {
+        sum += bitpack_find_first(&bp, keys[((i * 7919) % TEST_BITPACK_ITEMS)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%.2f bits/key, %" PRIu64 ")\n", __func__, (tend - tstart)/TEST_BITPACK_ITEMS, (double)(8 * size) / TEST_BITPACK_ITEMS, sum);
+    free(blob);
+    free(keys);
+}
+
+void benchmark_bitpack_unpack_block()
+{
+    uint64_t i = 0, size = 0, sum = 0;
+    uint64_t buf[NKBITPACK_BLOCK];
+    uint64_t *keys = test_keys(TEST_BITPACK_ITEMS);
+    bitpack_t bp;
+    uint8_t *blob = bitpack_build(keys, TEST_BITPACK_ITEMS, &size);
+    if ((blob == NULL) || !bitpack_load(blob, size, &bp))
+    {
+        free(blob);
+        free(keys);
+        return;
+    }
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < bp.nblocks; i++)
+    {
+        bitpack_unpack_block(&bp, i, buf);
+        sum += buf[(i % NKBITPACK_BLOCK)];
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/bp.nblocks, sum);
+    free(blob);
+    free(keys);
+}
+
+void benchmark_col_find_first_raw()
+{
+    uint64_t i = 0, first = 0, last = 0, sum = 0;
+    uint64_t *keys = test_keys(TEST_BITPACK_ITEMS);
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_BITPACK_ITEMS; i++)
+    {
+        first = 0;
+        last = TEST_BITPACK_ITEMS;
+        sum += col_find_first_uint64_t(keys, &first, &last, keys[((i * 7919) % TEST_BITPACK_ITEMS)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/TEST_BITPACK_ITEMS, sum);
+    free(keys);
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_bitpack();
+
+    benchmark_bitpack_find_first();
+    benchmark_bitpack_unpack_block();
+    benchmark_col_find_first_raw();
+
+    return errors;
+}
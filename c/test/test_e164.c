@@ -0,0 +1,187 @@
+// NumKey
+//
+// test_e164.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for e164
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/e164.h"
+
+typedef struct test_e164_data_t
+{
+    const char* number;
+    const char* digits;
+} test_e164_data_t;
+
+static const test_e164_data_t test_e164_data[] =
+{
+    {"", ""},
+    {"+", ""},
+    {"00", ""},
+    {"0", "0"},
+    {"012", "012"},
+    {"447946000018", "447946000018"},
+    {"+44 (0)20 7946-0018", "442079460018"},
+    {"0044 20 7946 0018", "442079460018"},
+    {" +1-212-555-0123", "12125550123"},
+    {"+1 (212) 555.0123", "12125550123"},
+    {"(0)", ""},
+    {"(0", "0"},
+    {"+39/06 1234 5678", "390612345678"},
+    {"+1 212 555 0123 ext. 45", "12125550123"},
+    {"+1 212#45", "1212"},
+};
+
+static const int k_e164_test_size = (int)(sizeof(test_e164_data) / sizeof(test_e164_data_t));
+
+typedef struct test_e164_country_data_t
+{
+    const char* number;
+    const char* country;
+    size_t cclen;
+} test_e164_country_data_t;
+
+static const test_e164_country_data_t test_e164_country_data[] =
+{
+    {"", "", 0},
+    {"0", "", 0},
+    {"4", "", 0},
+    {"35", "", 0},
+    {"4A", "", 0},
+    {"447946000018", "GB", 2},
+    {"12125550123", "US", 1},
+    {"14165550123", "CA", 1},
+    {"18765550123", "JM", 1},
+    {"1", "", 0},
+    {"12", "", 0},
+    {"121", "", 0},
+    {"1212", "US", 1},
+    {"77012345678", "KZ", 1},
+    {"76012345678", "KZ", 1},
+    {"74951234567", "RU", 1},
+    {"390612345678", "IT", 2},
+    {"886212345678", "TW", 3},
+    {"35312345678", "IE", 3},
+    {"80012345678", "", 0},
+    {"979123456", "", 0},
+    {"2471234", "SH", 3},
+    {"861012345678", "CN", 2},
+    {"99312345678", "TM", 3},
+};
+
+static const int k_e164_country_test_size = (int)(sizeof(test_e164_country_data) / sizeof(test_e164_country_data_t));
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+int test_e164_next_digit()
+{
+    int errors = 0;
+    int i = 0;
+    size_t pos = 0, len = 0, size = 0;
+    int d = 0;
+    char digits[32] = "";
+    for (i=0 ; i < k_e164_test_size; i++)
+    {
+        size = strlen(test_e164_data[i].number);
+        pos = e164_start(test_e164_data[i].number, size);
+        len = 0;
+        while ((d = e164_next_digit(test_e164_data[i].number, size, &pos)) >= 0)
+        {
+            digits[len++] = (char)('0' + d);
+        }
+        digits[len] = 0;
+        if (strcmp(digits, test_e164_data[i].digits) != 0)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected digits: expected %s, got %s\n", __func__, i, test_e164_data[i].digits, digits);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void benchmark_e164_next_digit()
+{
+    uint64_t tstart = 0, tend = 0;
+    int i = 0;
+    int size = 100000;
+    size_t pos = 0;
+    uint64_t sum = 0;
+    int d = 0;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        pos = e164_start("+44 (0)20 7946-0018", 19);
+        while ((d = e164_next_digit("+44 (0)20 7946-0018", 19, &pos)) >= 0)
+        {
+            sum += (uint64_t)d;
+        }
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/size, sum);
+}
+
+int test_e164_country()
+{
+    int errors = 0;
+    int i = 0;
+    size_t cclen = 0;
+    char country[3] = "";
+    for (i=0 ; i < k_e164_country_test_size; i++)
+    {
+        cclen = e164_country(test_e164_country_data[i].number, strlen(test_e164_country_data[i].number), country);
+        if (strcmp(country, test_e164_country_data[i].country) != 0)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected country: expected %s, got %s\n", __func__, i, test_e164_country_data[i].country, country);
+            ++errors;
+        }
+        if (cclen != test_e164_country_data[i].cclen)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected calling code length: expected %zu, got %zu\n", __func__, i, test_e164_country_data[i].cclen, cclen);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void benchmark_e164_country()
+{
+    uint64_t tstart = 0, tend = 0;
+    int i = 0;
+    int size = 100000;
+    uint64_t sum = 0;
+    char country[3] = "";
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        sum += e164_country(((i & 1) ? "447946000018" : "14165550123"), 11, country);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/size, sum);
+}
+
+int main()
+{
+    static int errors = 0;
+
+    errors += test_e164_next_digit();
+    errors += test_e164_country();
+
+    benchmark_e164_next_digit();
+    benchmark_e164_country();
+
+    return errors;
+}
@@ -0,0 +1,229 @@
+// NumKey
+//
+// test_eliasfano.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for eliasfano
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/eliasfano.h"
+#include "../src/numkey/numkey.h"
+#include "../src/numkey/set.h"
+
+#define TEST_EF_ITEMS 1000000
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+static inline uint64_t xorshift64(uint64_t *s)
+{
+    *s ^= (*s << 13);
+    *s ^= (*s >> 7);
+    *s ^= (*s << 17);
+    return *s;
+}
+
+// generates random NumKeys over a few countries, sorted and without duplicates
+static inline uint64_t *test_keys(uint64_t *nkeys)
+{
+    static const char *country[] = {"DE", "GB", "IT", "US"};
+    uint64_t *keys = (uint64_t *)malloc(((*nkeys > 0) ? *nkeys : 1) * sizeof(uint64_t));
+    uint64_t *tmp = (uint64_t *)malloc(((*nkeys > 0) ? *nkeys : 1) * sizeof(uint64_t));
+    uint64_t s = 0x9e3779b97f4a7c15, i = 0;
+    for (i = 0; i < *nkeys; i++)
+    {
+        keys[i] = (numkey(country[(xorshift64(&s) % 4)], "", 0) | ((440000000000 + (xorshift64(&s) % 100000000)) << NKBSHIFT_NUMBER) | 12);
+    }
+    sort_uint64_t(keys, tmp, (uint32_t)*nkeys);
+    *nkeys = (uint64_t)(unique_uint64_t(keys, *nkeys) - keys);
+    free(tmp);
+    return keys;
+}
+
+// returns the position of the first key greater or equal than the search key
+static inline uint64_t lower_bound(const uint64_t *keys, uint64_t nkeys, uint64_t search)
+{
+    uint64_t first = 0, last = nkeys, middle = 0;
+    while (first < last)
+    {
+        middle = get_middle_point(first, last);
+        if (keys[middle] < search)
+        {
+            first = (middle + 1);
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+int test_eliasfano_keys(const uint64_t *keys, uint64_t nkeys)
+{
+    int errors = 0;
+    uint64_t i = 0, size = 0, pos = 0, exp = 0;
+    int64_t d = 0;
+    eliasfano_t ef;
+    uint8_t *blob = eliasfano_build(keys, nkeys, &size);
+    if ((blob == NULL) || !eliasfano_load(blob, size, &ef) || (ef.nkeys != nkeys))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Unable to build the Elias-Fano column\n", __func__, nkeys);
+        free(blob);
+        return 1;
+    }
+    for (i = 0; i < nkeys; i++)
+    {
+        if (eliasfano_access(&ef, i) != keys[i])
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected key %" PRIu64 "\n", __func__, nkeys, i);
+            ++errors;
+        }
+        for (d = -1; d <= 1; d++)
+        {
+            if (((d < 0) && (keys[i] == 0)) || ((d > 0) && (keys[i] == UINT64_MAX)))
+            {
+                continue;
+            }
+            exp = lower_bound(keys, nkeys, (keys[i] + (uint64_t)d));
+            pos = eliasfano_next_geq(&ef, (keys[i] + (uint64_t)d));
+            if (pos != exp)
+            {
+                (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected next_geq for key %" PRIu64 " %+" PRId64 ": expected %" PRIu64 ", got %" PRIu64 "\n", __func__, nkeys, i, d, exp, pos);
+                ++errors;
+            }
+        }
+    }
+    if (eliasfano_rank(&ef, 0) != 0)
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected rank of 0\n", __func__, nkeys);
+        ++errors;
+    }
+    if (eliasfano_rank(&ef, UINT64_MAX) != lower_bound(keys, nkeys, UINT64_MAX))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected rank of the largest key\n", __func__, nkeys);
+        ++errors;
+    }
+    if (eliasfano_load(blob, (size - 8), &ef))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Expected invalid blob size\n", __func__, nkeys);
+        ++errors;
+    }
+    free(blob);
+    return errors;
+}
+
+int test_eliasfano()
+{
+    int errors = 0;
+    uint64_t nkeys = 100000;
+    uint64_t *keys = test_keys(&nkeys);
+    errors += test_eliasfano_keys(keys, 0);
+    errors += test_eliasfano_keys(keys, 1);
+    errors += test_eliasfano_keys(keys, 300);
+    errors += test_eliasfano_keys(keys, nkeys);
+    free(keys);
+    uint64_t dense[1000];
+    uint64_t i = 0;
+    for (i = 0; i < 1000; i++)
+    {
+        dense[i] = (i + (i / 3)); // small universe: no low bits
+    }
+    errors += test_eliasfano_keys(dense, 1000);
+    uint64_t edge[] = {0, 0, 5, 5, 5, 0x8000000000000000, UINT64_MAX, UINT64_MAX}; // duplicates and 63 low bits
+    errors += test_eliasfano_keys(edge, 8);
+    return errors;
+}
+
+void benchmark_eliasfano_next_geq()
+{
+    uint64_t i = 0, size = 0, sum = 0;
+    uint64_t nkeys = TEST_EF_ITEMS;
+    uint64_t *keys = test_keys(&nkeys);
+    eliasfano_t ef;
+    uint8_t *blob = eliasfano_build(keys, nkeys, &size);
+    if ((blob == NULL) || !eliasfano_load(blob, size, &ef))
+    {
+        free(blob);
+        free(keys);
+        return;
+    }
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < nkeys; i++)
+    {
+        sum += eliasfano_next_geq(&ef, keys[((i * 7919) % nkeys)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%.2f bits/key, %" PRIu64 ")\n", __func__, (tend - tstart)/nkeys, (double)(8 * size) / nkeys, sum);
+    free(blob);
+    free(keys);
+}
+
+void benchmark_eliasfano_access()
+{
+    uint64_t i = 0, size = 0, sum = 0;
+    uint64_t nkeys = TEST_EF_ITEMS;
+    uint64_t *keys = test_keys(&nkeys);
+    eliasfano_t ef;
+    uint8_t *blob = eliasfano_build(keys, nkeys, &size);
+    if ((blob == NULL) || !eliasfano_load(blob, size, &ef))
+    {
+        free(blob);
+        free(keys);
+        return;
+    }
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < nkeys; i++)
+    {
+        sum += eliasfano_access(&ef, ((i * 7919) % nkeys));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/nkeys, sum);
+    free(blob);
+    free(keys);
+}
+
+void benchmark_col_find_first_raw()
+{
+    uint64_t i = 0, first = 0, last = 0, sum = 0;
+    uint64_t nkeys = TEST_EF_ITEMS;
+    uint64_t *keys = test_keys(&nkeys);
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < nkeys; i++)
+    {
+        first = 0;
+        last = nkeys;
+        sum += col_find_first_uint64_t(keys, &first, &last, keys[((i * 7919) % nkeys)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/nkeys, sum);
+    free(keys);
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_eliasfano();
+
+    benchmark_eliasfano_next_geq();
+    benchmark_eliasfano_access();
+    benchmark_col_find_first_raw();
+
+    return errors;
+}
@@ -0,0 +1,193 @@
+// NumKey
+//
+// test_eytzinger.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for eytzinger
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/eytzinger.h"
+
+#define TEST_EYT_SEARCHES 100000
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+int test_eytzinger_rank()
+{
+    int errors = 0;
+    uint64_t n, k, r;
+    uint8_t *seen = (uint8_t *)calloc(1025, 1);
+    for (n = 1; n <= 1024; n++)
+    {
+        memset(seen, 0, n);
+        for (k = 1; k <= n; k++)
+        {
+            r = eytzinger_rank(k, n);
+            if ((r >= n) || seen[r])
+            {
+                (void) fprintf(stderr, "%s (%" PRIu64 ") : Invalid rank %" PRIu64 " for node %" PRIu64 "\n", __func__, n, r, k);
+                ++errors;
+                break;
+            }
+            seen[r] = 1;
+            // in-order: the left child precedes and the right child follows the node
+            if (((2 * k) <= n) && (eytzinger_rank((2 * k), n) >= r))
+            {
+                (void) fprintf(stderr, "%s (%" PRIu64 ") : Invalid left child rank for node %" PRIu64 "\n", __func__, n, k);
+                ++errors;
+            }
+            if (((2 * k + 1) <= n) && (eytzinger_rank((2 * k + 1), n) <= r))
+            {
+                (void) fprintf(stderr, "%s (%" PRIu64 ") : Invalid right child rank for node %" PRIu64 "\n", __func__, n, k);
+                ++errors;
+            }
+        }
+    }
+    free(seen);
+    return errors;
+}
+
+int test_eytzinger_col()
+{
+    int errors = 0;
+    uint64_t n, i, first, last, exp, found;
+    uint32_t src[600];
+    uint32_t eyt[600];
+    uint32_t search;
+    for (n = 0; n <= 600; n += 37)
+    {
+        for (i = 0; i < n; i++)
+        {
+            src[i] = (uint32_t)(10 * (i / 3)); // duplicates
+        }
+        eytzinger_col_build_uint32_t(src, n, eyt);
+        for (search = 0; search <= (uint32_t)(10 * (n / 3) + 10); search += 5)
+        {
+            first = 0;
+            last = n;
+            exp = col_find_first_uint32_t(src, &first, &last, search);
+            found = eytzinger_find_first_uint32_t(eyt, n, search);
+            if (found != exp)
+            {
+                (void) fprintf(stderr, "%s (%" PRIu64 ") : Expected %" PRIu64 ", got %" PRIu64 " for %" PRIu32 "\n", __func__, n, exp, found, search);
+                ++errors;
+            }
+        }
+    }
+    return errors;
+}
+
+int test_eytzinger_row(mmfile_t mf, uint64_t blklen, uint64_t nrows)
+{
+    int errors = 0;
+    uint64_t i, first, last, exp, found;
+    uint64_t *eyt64 = (uint64_t *)malloc(nrows * sizeof(uint64_t));
+    uint32_t *eyt32 = (uint32_t *)malloc(nrows * sizeof(uint32_t));
+    eytzinger_build_be_uint64_t(mf.src, blklen, 0, nrows, eyt64);
+    eytzinger_build_le_uint32_t(mf.src, blklen, 12, nrows, eyt32);
+    for (i = 0; i < nrows; i++)
+    {
+        uint64_t s64 = bytes_be_to_uint64_t(mf.src, get_address(blklen, 0, i));
+        first = 0;
+        last = nrows;
+        exp = find_first_be_uint64_t(mf.src, blklen, 0, &first, &last, s64);
+        found = eytzinger_find_first_uint64_t(eyt64, nrows, s64);
+        if (found != exp)
+        {
+            (void) fprintf(stderr, "%s BE64 (%" PRIu64 ") : Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, exp, found);
+            ++errors;
+        }
+        first = 0;
+        last = nrows;
+        exp = find_first_be_uint64_t(mf.src, blklen, 0, &first, &last, (s64 + 1));
+        found = eytzinger_find_first_uint64_t(eyt64, nrows, (s64 + 1));
+        if (found != exp)
+        {
+            (void) fprintf(stderr, "%s BE64 NEXT (%" PRIu64 ") : Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, exp, found);
+            ++errors;
+        }
+        uint32_t s32 = bytes_le_to_uint32_t(mf.src, get_address(blklen, 12, i));
+        first = 0;
+        last = nrows;
+        exp = find_first_le_uint32_t(mf.src, blklen, 12, &first, &last, s32);
+        found = eytzinger_find_first_uint32_t(eyt32, nrows, s32);
+        if (found != exp)
+        {
+            (void) fprintf(stderr, "%s LE32 (%" PRIu64 ") : Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, i, exp, found);
+            ++errors;
+        }
+    }
+    free(eyt64);
+    free(eyt32);
+    return errors;
+}
+
+void benchmark_eytzinger(mmfile_t mf, uint64_t blklen, uint64_t nrows)
+{
+    uint64_t tstart, tend, first, last, i, sum = 0;
+    uint64_t *eyt = (uint64_t *)malloc(nrows * sizeof(uint64_t));
+    if (eyt == NULL)
+    {
+        return;
+    }
+    eytzinger_build_be_uint64_t(mf.src, blklen, 0, nrows, eyt);
+    tstart = get_time();
+    for (i = 0; i < TEST_EYT_SEARCHES; i++)
+    {
+        first = 0;
+        last = nrows;
+        sum += find_first_be_uint64_t(mf.src, blklen, 0, &first, &last, bytes_be_to_uint64_t(mf.src, get_address(blklen, 0, ((i * 7919) % nrows))));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s find_first_be_uint64_t : %" PRIu64 " ns/op (%" PRIx64 ")\n", __func__, (tend - tstart) / TEST_EYT_SEARCHES, sum);
+    sum = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_EYT_SEARCHES; i++)
+    {
+        sum += eytzinger_find_first_uint64_t(eyt, nrows, bytes_be_to_uint64_t(mf.src, get_address(blklen, 0, ((i * 7919) % nrows))));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s eytzinger_find_first_uint64_t : %" PRIu64 " ns/op (%" PRIx64 ")\n", __func__, (tend - tstart) / TEST_EYT_SEARCHES, sum);
+    free(eyt);
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_eytzinger_rank();
+    errors += test_eytzinger_col();
+
+    char *file = "test_data.bin"; // file containing test data
+    uint64_t blklen = 16; // length of each binary block
+
+    mmfile_t mf = {0};
+    mf.ncols = 1;
+    mf.ctbytes[0] = 12;
+    mmap_binfile(file, &mf);
+    if ((mf.fd < 0) || (mf.size == 0) || (mf.src == MAP_FAILED))
+    {
+        (void) fprintf(stderr, "can't open %s for reading [%s]\n", file, strerror(errno));
+        return 1;
+    }
+    errors += test_eytzinger_row(mf, blklen, (mf.size / blklen));
+    benchmark_eytzinger(mf, blklen, (mf.size / blklen));
+    (void) munmap_binfile(mf);
+
+    return errors;
+}
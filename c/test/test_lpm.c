@@ -0,0 +1,337 @@
+// NumKey
+//
+// test_lpm.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for lpm
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/binsearch.h"
+#include "../src/numkey/lpm.h"
+#include "../src/numkey/numkey_map.h"
+#include "../src/numkey/set.h"
+
+#define TEST_LPM_PREFIXES 100000
+#define TEST_LPM_QUERIES  0x10000
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+static inline uint64_t xorshift64(uint64_t *s)
+{
+    *s ^= (*s << 13);
+    *s ^= (*s >> 7);
+    *s ^= (*s << 17);
+    return *s;
+}
+
+// random rate deck: nested prefixes of 1 to 9 digits under a few country codes
+typedef struct test_lpm_table_t
+{
+    uint64_t *prefix;
+    uint8_t *length;
+    uint64_t *value;
+    uint64_t n;
+} test_lpm_table_t;
+
+static inline void test_lpm_table(test_lpm_table_t *t, uint64_t n, uint64_t seed)
+{
+    static const char *cc[] = {"1", "44", "33", "49", "39", "7", "86", "91", "351", "880"};
+    char digits[16];
+    uint64_t s = seed, i = 0, k = 0;
+    size_t cclen = 0, len = 0;
+    t->prefix = (uint64_t *)malloc(n * sizeof(uint64_t));
+    t->length = (uint8_t *)malloc(n * sizeof(uint8_t));
+    t->value = (uint64_t *)malloc(n * sizeof(uint64_t));
+    t->n = n;
+    for (i = 0; i < n; i++)
+    {
+        const char *c = cc[(xorshift64(&s) % 10)];
+        cclen = strlen(c);
+        memcpy(digits, c, cclen);
+        len = cclen + (xorshift64(&s) % (10 - cclen));
+        for (k = cclen; k < len; k++)
+        {
+            digits[k] = (char)('0' + (xorshift64(&s) % 10));
+        }
+        t->prefix[i] = prefixkey(digits, len);
+        t->length[i] = (uint8_t)len;
+        t->value[i] = (i + 1);
+    }
+}
+
+static inline void test_lpm_table_free(test_lpm_table_t *t)
+{
+    free(t->prefix);
+    free(t->length);
+    free(t->value);
+}
+
+// returns the (prefixkey << 4 | length) code of a prefix
+static inline uint64_t test_lpm_code(uint64_t pk, uint8_t len)
+{
+    return (((pk - (pk % nk_pow10[(PKNUMMAXLEN - len)])) << 4) | len);
+}
+
+// sorted and unique prefix codes for the retry search
+static inline uint64_t *test_lpm_codes(const test_lpm_table_t *t, uint64_t *n)
+{
+    uint64_t *codes = (uint64_t *)malloc(t->n * sizeof(uint64_t));
+    uint64_t *tmp = (uint64_t *)malloc(t->n * sizeof(uint64_t));
+    uint64_t i = 0;
+    for (i = 0; i < t->n; i++)
+    {
+        codes[i] = test_lpm_code(t->prefix[i], t->length[i]);
+    }
+    sort_uint64_t(codes, tmp, (uint32_t)t->n);
+    *n = (uint64_t)(unique_uint64_t(codes, t->n) - codes);
+    free(tmp);
+    return codes;
+}
+
+// longest-prefix-match by retrying the search with progressively shorter prefixes
+static inline uint8_t test_lpm_retry(const uint64_t *codes, uint64_t n, uint64_t pk)
+{
+    int len = 0;
+    uint64_t first = 0, last = 0;
+    for (len = PKNUMMAXLEN; len >= 0; len--)
+    {
+        first = 0;
+        last = n;
+        if (col_find_first_uint64_t(codes, &first, &last, test_lpm_code(pk, (uint8_t)len)) < n)
+        {
+            return (uint8_t)len;
+        }
+    }
+    return NKLPM_NOMATCH;
+}
+
+int test_lpm_lookup()
+{
+    int errors = 0;
+    test_lpm_table_t t;
+    test_lpm_table(&t, 100000, 0x9e3779b97f4a7c15);
+    t.prefix[100] = t.prefix[200]; // duplicated prefix: the last one wins
+    t.length[100] = t.length[200];
+    uint64_t ncodes = 0;
+    uint64_t *codes = test_lpm_codes(&t, &ncodes);
+    uint64_t i = 0, size = 0, value = 0, expval = 0, s = 0x0123456789abcdef, pk = 0;
+    numkey_map_t map; // code -> value of the last duplicated prefix
+    numkey_map_init(&map, t.n);
+    for (i = 0; i < t.n; i++)
+    {
+        numkey_map_put(&map, test_lpm_code(t.prefix[i], t.length[i]), t.value[i]);
+    }
+    uint8_t len = 0, exp = 0;
+    lpm_t lpm;
+    uint8_t *blob = lpm_build(t.prefix, t.length, t.value, t.n, 4, &size);
+    if ((blob == NULL) || !lpm_load(blob, size, &lpm))
+    {
+        (void) fprintf(stderr, "%s : Unable to build the table\n", __func__);
+        free(blob);
+        free(codes);
+        numkey_map_free(&map);
+        test_lpm_table_free(&t);
+        return 1;
+    }
+    uint64_t *qpk = (uint64_t *)malloc(200000 * sizeof(uint64_t));
+    uint64_t *qval = (uint64_t *)calloc(200000, sizeof(uint64_t));
+    uint8_t *qlen = (uint8_t *)malloc(200000);
+    for (i = 0; i < 200000; i++)
+    {
+        // random numbers, half of them starting with a prefix of the table
+        pk = (xorshift64(&s) % nk_pow10[PKNUMMAXLEN]);
+        if (i & 1)
+        {
+            uint64_t k = (xorshift64(&s) % t.n);
+            uint64_t span = nk_pow10[(PKNUMMAXLEN - t.length[k])];
+            pk = (t.prefix[k] + (pk % span));
+        }
+        qpk[i] = pk;
+        exp = test_lpm_retry(codes, ncodes, pk);
+        expval = 0;
+        if (exp != NKLPM_NOMATCH)
+        {
+            numkey_map_get(&map, test_lpm_code(pk, exp), &expval);
+        }
+        value = 0;
+        len = lpm_lookup(&lpm, pk, &value);
+        if ((len != exp) || (value != expval))
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected match for %015" PRIu64 ": expected %u %" PRIu64 ", got %u %" PRIu64 "\n", __func__, i, pk, exp, expval, len, value);
+            ++errors;
+        }
+    }
+    lpm_lookup_batch(&lpm, qpk, 200000, qval, qlen);
+    for (i = 0; i < 200000; i++)
+    {
+        value = 0;
+        len = lpm_lookup(&lpm, qpk[i], &value);
+        if ((qlen[i] != len) || (qval[i] != value))
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected batch result\n", __func__, i);
+            ++errors;
+        }
+    }
+    if (lpm_lookup(&lpm, t.prefix[200], &value) != t.length[200] || (value != t.value[200]))
+    {
+        (void) fprintf(stderr, "%s : Expected the last duplicated prefix\n", __func__);
+        ++errors;
+    }
+    free(qpk);
+    free(qval);
+    free(qlen);
+    free(blob);
+    free(codes);
+    numkey_map_free(&map);
+    test_lpm_table_free(&t);
+    return errors;
+}
+
+int test_lpm_edge()
+{
+    int errors = 0;
+    uint64_t size = 0, value = 0;
+    lpm_t lpm;
+    uint8_t *blob = lpm_build(NULL, NULL, NULL, 0, 4, &size);
+    if ((blob == NULL) || !lpm_load(blob, size, &lpm) || (lpm_lookup(&lpm, 123, &value) != NKLPM_NOMATCH))
+    {
+        (void) fprintf(stderr, "%s : Unexpected match in the empty table\n", __func__);
+        ++errors;
+    }
+    free(blob);
+    const uint64_t prefix[] = {0, prefixkey("44", 2), prefixkey("4420", 4), prefixkey("999999999999999", 15)};
+    const uint8_t length[] = {0, 2, 4, 15};
+    const uint64_t val[] = {1, 2, 3, 4};
+    blob = lpm_build(prefix, length, val, 4, 4, &size);
+    if ((blob == NULL) || !lpm_load(blob, size, &lpm))
+    {
+        (void) fprintf(stderr, "%s : Unable to build the table\n", __func__);
+        free(blob);
+        return (errors + 1);
+    }
+    if ((lpm_lookup_number(&lpm, "442079460018", 12, &value) != 4) || (value != 3))
+    {
+        (void) fprintf(stderr, "%s : Expected match with 4420\n", __func__);
+        ++errors;
+    }
+    if ((lpm_lookup_number(&lpm, "441234", 6, &value) != 2) || (value != 2))
+    {
+        (void) fprintf(stderr, "%s : Expected match with 44\n", __func__);
+        ++errors;
+    }
+    if ((lpm_lookup_number(&lpm, "33123", 5, &value) != 0) || (value != 1))
+    {
+        (void) fprintf(stderr, "%s : Expected match with the default route\n", __func__);
+        ++errors;
+    }
+    if ((lpm_lookup_number(&lpm, "999999999999999", 15, &value) != 15) || (value != 4))
+    {
+        (void) fprintf(stderr, "%s : Expected match with the full number\n", __func__);
+        ++errors;
+    }
+    const uint64_t badpk[] = {nk_pow10[PKNUMMAXLEN], UINT64_MAX}; // not PrefixKeys (e.g. a raw NumKey)
+    uint64_t badval[] = {0, 0};
+    uint8_t badlen[] = {0, 0};
+    value = 0;
+    if ((lpm_lookup(&lpm, badpk[0], &value) != NKLPM_NOMATCH) || (lpm_lookup(&lpm, badpk[1], &value) != NKLPM_NOMATCH) || (value != 0))
+    {
+        (void) fprintf(stderr, "%s : Unexpected match for an invalid PrefixKey\n", __func__);
+        ++errors;
+    }
+    lpm_lookup_batch(&lpm, badpk, 2, badval, badlen);
+    if ((badlen[0] != NKLPM_NOMATCH) || (badlen[1] != NKLPM_NOMATCH) || (badval[0] != 0) || (badval[1] != 0))
+    {
+        (void) fprintf(stderr, "%s : Unexpected batch match for an invalid PrefixKey\n", __func__);
+        ++errors;
+    }
+    if (lpm_build(prefix, (const uint8_t *)"\x10", val, 1, 4, &size) != NULL)
+    {
+        (void) fprintf(stderr, "%s : Expected invalid length\n", __func__);
+        ++errors;
+    }
+    free(blob);
+    return errors;
+}
+
+static inline bool benchmark_lpm_setup(test_lpm_table_t *t, uint64_t **qpk, uint8_t **blob, lpm_t *lpm)
+{
+    uint64_t s = 0xfedcba9876543210, i = 0, k = 0, size = 0;
+    test_lpm_table(t, TEST_LPM_PREFIXES, 0x9e3779b97f4a7c15);
+    *qpk = (uint64_t *)malloc(TEST_LPM_QUERIES * sizeof(uint64_t));
+    for (i = 0; i < TEST_LPM_QUERIES; i++)
+    {
+        k = (xorshift64(&s) % t->n);
+        (*qpk)[i] = (t->prefix[k] + (xorshift64(&s) % nk_pow10[(PKNUMMAXLEN - t->length[k])]));
+    }
+    *blob = lpm_build(t->prefix, t->length, t->value, t->n, 4, &size);
+    return ((*blob != NULL) && lpm_load(*blob, size, lpm));
+}
+
+void benchmark_lpm_lookup()
+{
+    test_lpm_table_t t;
+    uint64_t *qpk = NULL, *qval = NULL, ncodes = 0;
+    uint8_t *blob = NULL, *qlen = NULL;
+    lpm_t lpm;
+    uint64_t i = 0, sum = 0, value = 0, tstart = 0, tend = 0;
+    if (!benchmark_lpm_setup(&t, &qpk, &blob, &lpm))
+    {
+        free(qpk);
+        free(blob);
+        test_lpm_table_free(&t);
+        return;
+    }
+    tstart = get_time();
+    for (i = 0; i < TEST_LPM_QUERIES; i++)
+    {
+        sum += lpm_lookup(&lpm, qpk[i], &value);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 " segments, %" PRIu64 ")\n", __func__, (tend - tstart)/TEST_LPM_QUERIES, lpm.nsegs, sum);
+    qval = (uint64_t *)malloc(TEST_LPM_QUERIES * sizeof(uint64_t));
+    qlen = (uint8_t *)malloc(TEST_LPM_QUERIES);
+    tstart = get_time();
+    lpm_lookup_batch(&lpm, qpk, TEST_LPM_QUERIES, qval, qlen);
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op\n", "benchmark_lpm_lookup_batch", (tend - tstart)/TEST_LPM_QUERIES);
+    uint64_t *codes = test_lpm_codes(&t, &ncodes);
+    sum = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_LPM_QUERIES; i++)
+    {
+        sum += test_lpm_retry(codes, ncodes, qpk[i]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", "benchmark_lpm_retry_find", (tend - tstart)/TEST_LPM_QUERIES, sum);
+    free(codes);
+    free(qval);
+    free(qlen);
+    free(qpk);
+    free(blob);
+    test_lpm_table_free(&t);
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_lpm_lookup();
+    errors += test_lpm_edge();
+
+    benchmark_lpm_lookup();
+
+    return errors;
+}
@@ -0,0 +1,272 @@
+// NumKey
+//
+// test_mmsample.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for mmsample
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/mmsample.h"
+
+#define TEST_SAMPLE_SEARCHES 100000
+
+static const uint64_t test_steps[] = {1, 2, 5, 16, 300};
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+// checks that a result on the narrowed range matches the result on the whole range
+int test_mmsample_check(const char *name, uint64_t step, uint64_t search, uint64_t exp, uint64_t nrows, uint64_t found, uint64_t last)
+{
+    if (((exp < nrows) && (found != exp)) || ((exp >= nrows) && (found < last)))
+    {
+        (void) fprintf(stderr, "%s (step %" PRIu64 ") %" PRIx64 " : Expected %" PRIu64 ", got %" PRIu64 "\n", name, step, search, exp, found);
+        return 1;
+    }
+    return 0;
+}
+
+int test_mmsample_row(mmfile_t mf, uint64_t blklen, uint64_t nrows)
+{
+    int errors = 0;
+    uint64_t s, i, d, k, v, first, last, exp, found, nlast, neq;
+    mmsample_t ms;
+    for (s = 0; s < (sizeof(test_steps) / sizeof(test_steps[0])); s++)
+    {
+        if (!mmsample_build_be_uint64_t(&ms, mf.src, blklen, 0, nrows, test_steps[s]))
+        {
+            return (errors + 1);
+        }
+        for (i = 0; i < nrows; i++)
+        {
+            for (d = 0; d < 2; d++)
+            {
+                v = (bytes_be_to_uint64_t(mf.src, get_address(blklen, 0, i)) + d); // existing and next value
+                first = 0;
+                last = nrows;
+                exp = find_first_be_uint64_t(mf.src, blklen, 0, &first, &last, v);
+                first = 0;
+                last = nrows;
+                mmsample_range(&ms, v, &first, &last);
+                neq = 0; // each sample equal to the search value extends the range by one step
+                for (k = 0; k < ms.nsamples; k++)
+                {
+                    neq += (ms.keys[k] == v);
+                }
+                if ((last - first) > ((neq + 1) * test_steps[s]))
+                {
+                    (void) fprintf(stderr, "%s (step %" PRIu64 ") : Range too large: %" PRIu64 "\n", __func__, test_steps[s], (last - first));
+                    ++errors;
+                }
+                nlast = last;
+                found = find_first_be_uint64_t(mf.src, blklen, 0, &first, &last, v);
+                errors += test_mmsample_check("FIRST", test_steps[s], v, exp, nrows, found, nlast);
+                first = 0;
+                last = nrows;
+                exp = find_last_be_uint64_t(mf.src, blklen, 0, &first, &last, v);
+                first = 0;
+                last = nrows;
+                mmsample_range(&ms, v, &first, &last);
+                nlast = last;
+                found = find_last_be_uint64_t(mf.src, blklen, 0, &first, &last, v);
+                errors += test_mmsample_check("LAST", test_steps[s], v, exp, nrows, found, nlast);
+                first = 0;
+                last = nrows;
+                found = mmsample_find_last_be_uint64_t(&ms, mf.src, blklen, 0, &first, &last, v);
+                errors += test_mmsample_check("MMSAMPLE LAST", test_steps[s], v, exp, (nrows + 1), found, 0); // exact match: a miss must return the original last
+                first = 0;
+                last = nrows;
+                exp = find_first_be_uint64_t(mf.src, blklen, 0, &first, &last, v);
+                first = 0;
+                last = nrows;
+                found = mmsample_find_first_be_uint64_t(&ms, mf.src, blklen, 0, &first, &last, v);
+                errors += test_mmsample_check("MMSAMPLE FIRST", test_steps[s], v, exp, (nrows + 1), found, 0); // exact match: a miss must return the original last
+            }
+        }
+        mmsample_free(&ms);
+    }
+    return errors;
+}
+
+int test_mmsample_col_sub(mmfile_t mf)
+{
+    int errors = 0;
+    uint64_t s, i, first, last, exp, found, nlast;
+    uint16_t v;
+    mmsample_t ms;
+    const uint16_t *src = get_src_offset_uint16_t(mf.src, mf.index[1]);
+    const uint8_t bitstart = 0;
+    const uint8_t bitend = 11;
+    for (s = 0; s < (sizeof(test_steps) / sizeof(test_steps[0])); s++)
+    {
+        if (!mmsample_col_build_sub_uint16_t(&ms, src, bitstart, bitend, mf.nrows, test_steps[s]))
+        {
+            return (errors + 1);
+        }
+        for (i = 0; i < mf.nrows; i++)
+        {
+            v = (uint16_t)(src[i] >> 4);
+            first = 0;
+            last = mf.nrows;
+            exp = col_find_first_sub_uint16_t(src, bitstart, bitend, &first, &last, v);
+            first = 0;
+            last = mf.nrows;
+            mmsample_range(&ms, v, &first, &last);
+            nlast = last;
+            found = col_find_first_sub_uint16_t(src, bitstart, bitend, &first, &last, v);
+            errors += test_mmsample_check("SUB FIRST", test_steps[s], v, exp, mf.nrows, found, nlast);
+            first = 0;
+            last = mf.nrows;
+            exp = col_find_last_sub_uint16_t(src, bitstart, bitend, &first, &last, v);
+            first = 0;
+            last = mf.nrows;
+            mmsample_range(&ms, v, &first, &last);
+            nlast = last;
+            found = col_find_last_sub_uint16_t(src, bitstart, bitend, &first, &last, v);
+            errors += test_mmsample_check("SUB LAST", test_steps[s], v, exp, mf.nrows, found, nlast);
+            first = 0;
+            last = mf.nrows;
+            found = mmsample_col_find_last_sub_uint16_t(&ms, src, bitstart, bitend, &first, &last, v);
+            errors += test_mmsample_check("MMSAMPLE SUB LAST", test_steps[s], v, exp, (mf.nrows + 1), found, 0); // exact match: a miss must return the original last
+            first = 0;
+            last = mf.nrows;
+            exp = col_find_first_sub_uint16_t(src, bitstart, bitend, &first, &last, v);
+            first = 0;
+            last = mf.nrows;
+            found = mmsample_col_find_first_sub_uint16_t(&ms, src, bitstart, bitend, &first, &last, v);
+            errors += test_mmsample_check("MMSAMPLE SUB FIRST", test_steps[s], v, exp, (mf.nrows + 1), found, 0); // exact match: a miss must return the original last
+        }
+        mmsample_free(&ms);
+    }
+    return errors;
+}
+
+int test_mmsample_step()
+{
+    int errors = 0;
+    mmsample_t ms;
+    uint64_t keys[] = {1, 5, 9};
+    if ((mmsample_step(1000, MMSAMPLE_MAXBYTES) != 1) || (mmsample_step(32768, MMSAMPLE_MAXBYTES) != 1) || (mmsample_step(32769, MMSAMPLE_MAXBYTES) != 2))
+    {
+        (void) fprintf(stderr, "%s : Unexpected step\n", __func__);
+        ++errors;
+    }
+    mmsample_init(&ms, keys, 21, 10);
+    uint64_t first = 0, last = 21;
+    mmsample_range(&ms, 5, &first, &last);
+    if ((first != 0) || (last != 20))
+    {
+        (void) fprintf(stderr, "%s : Unexpected range [%" PRIu64 ", %" PRIu64 ")\n", __func__, first, last);
+        ++errors;
+    }
+    first = 0;
+    last = 21;
+    mmsample_range(&ms, 7, &first, &last);
+    if ((first != 10) || (last != 20))
+    {
+        (void) fprintf(stderr, "%s : Unexpected range [%" PRIu64 ", %" PRIu64 ")\n", __func__, first, last);
+        ++errors;
+    }
+    first = 15;
+    last = 21;
+    mmsample_range(&ms, 3, &first, &last);
+    if ((first != 10) || (last != 10))
+    {
+        (void) fprintf(stderr, "%s : Unexpected empty range [%" PRIu64 ", %" PRIu64 ")\n", __func__, first, last);
+        ++errors;
+    }
+    mmsample_init(&ms, NULL, 0, 0);
+    first = 0;
+    last = 0;
+    mmsample_range(&ms, 3, &first, &last);
+    if ((first != 0) || (last != 0))
+    {
+        (void) fprintf(stderr, "%s : Unexpected range for empty samples\n", __func__);
+        ++errors;
+    }
+    return errors;
+}
+
+void benchmark_mmsample_find_first(mmfile_t mf, uint64_t blklen, uint64_t nrows, uint64_t step)
+{
+    uint64_t tstart, tend, first, last, i, sum = 0;
+    mmsample_t ms;
+    if (!mmsample_build_be_uint64_t(&ms, mf.src, blklen, 0, nrows, step))
+    {
+        return;
+    }
+    tstart = get_time();
+    for (i = 0; i < TEST_SAMPLE_SEARCHES; i++)
+    {
+        first = 0;
+        last = nrows;
+        sum += find_first_be_uint64_t(mf.src, blklen, 0, &first, &last, bytes_be_to_uint64_t(mf.src, get_address(blklen, 0, ((i * 7919) % nrows))));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s find_first_be_uint64_t : %" PRIu64 " ns/op (%" PRIx64 ")\n", __func__, (tend - tstart) / TEST_SAMPLE_SEARCHES, sum);
+    sum = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_SAMPLE_SEARCHES; i++)
+    {
+        first = 0;
+        last = nrows;
+        sum += mmsample_find_first_be_uint64_t(&ms, mf.src, blklen, 0, &first, &last, bytes_be_to_uint64_t(mf.src, get_address(blklen, 0, ((i * 7919) % nrows))));
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s mmsample_find_first_be_uint64_t : %" PRIu64 " ns/op (step %" PRIu64 ", %" PRIx64 ")\n", __func__, (tend - tstart) / TEST_SAMPLE_SEARCHES, ms.step, sum);
+    mmsample_free(&ms);
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_mmsample_step();
+
+    char *file = "test_data.bin"; // file containing test data
+    uint64_t blklen = 16; // length of each binary block
+    mmfile_t mf = {0};
+    mf.ncols = 1;
+    mf.ctbytes[0] = 12;
+    mmap_binfile(file, &mf);
+    if ((mf.fd < 0) || (mf.size == 0) || (mf.src == MAP_FAILED))
+    {
+        (void) fprintf(stderr, "can't open %s for reading [%s]\n", file, strerror(errno));
+        return 1;
+    }
+    errors += test_mmsample_row(mf, blklen, (mf.size / blklen));
+    benchmark_mmsample_find_first(mf, blklen, (mf.size / blklen), 16);
+    (void) munmap_binfile(mf);
+
+    char *colfile = "test_data_col.bin"; // file containing test data in column format
+    mmfile_t mfc = {0};
+    mfc.ncols = 4;
+    mfc.ctbytes[0] = 1;
+    mfc.ctbytes[1] = 2;
+    mfc.ctbytes[2] = 4;
+    mfc.ctbytes[3] = 8;
+    mmap_binfile(colfile, &mfc);
+    if ((mfc.fd < 0) || (mfc.size == 0) || (mfc.src == MAP_FAILED))
+    {
+        (void) fprintf(stderr, "can't open %s for reading [%s]\n", colfile, strerror(errno));
+        return 1;
+    }
+    errors += test_mmsample_col_sub(mfc);
+    (void) munmap_binfile(mfc);
+
+    return errors;
+}
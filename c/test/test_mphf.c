@@ -0,0 +1,194 @@
+// NumKey
+//
+// test_mphf.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for mphf
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/mphf.h"
+
+#define TEST_MPHF_ITEMS 200000
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+// generates a sorted set of unique NumKeys
+static inline uint64_t *test_keys(uint64_t nkeys)
+{
+    uint64_t *keys = (uint64_t *)malloc(nkeys * sizeof(uint64_t));
+    uint64_t i = 0;
+    for (i = 0; i < nkeys; i++)
+    {
+        keys[i] = (numkey("GB", "", 0) | ((447000000000 + (i * 37)) << NKBSHIFT_NUMBER) | 12);
+    }
+    return keys;
+}
+
+int test_mphf_nkeys(uint64_t nkeys, bool storekeys)
+{
+    int errors = 0;
+    uint64_t i = 0, idx = 0, size = 0;
+    uint64_t *keys = test_keys(nkeys + 1);
+    uint8_t *seen = (uint8_t *)calloc((nkeys + 1), 1);
+    mphf_t mph;
+    uint8_t *blob = mphf_build(keys, nkeys, storekeys, &size);
+    if ((blob == NULL) || !mphf_load(blob, size, &mph))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Unable to build the MPHF\n", __func__, nkeys);
+        free(keys);
+        free(seen);
+        free(blob);
+        return 1;
+    }
+    for (i = 0; i < nkeys; i++)
+    {
+        idx = mphf_index(&mph, keys[i]);
+        if ((idx >= nkeys) || seen[idx])
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected index %" PRIu64 " for key %" PRIu64 "\n", __func__, nkeys, idx, i);
+            ++errors;
+            continue;
+        }
+        seen[idx] = 1;
+    }
+    if (storekeys && (mphf_index(&mph, keys[nkeys]) != nkeys))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Expected missing key\n", __func__, nkeys);
+        ++errors;
+    }
+    idx = mphf_index(&mph, UINT64_MAX); // larger than any key, it must not read past the fallback keys
+    if ((idx > nkeys) || (storekeys && (idx != nkeys)))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Unexpected index %" PRIu64 " for a key larger than any key\n", __func__, nkeys, idx);
+        ++errors;
+    }
+    if (mphf_load(blob, (size - 8), &mph))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ") : Expected invalid blob size\n", __func__, nkeys);
+        ++errors;
+    }
+    free(blob);
+    free(keys);
+    free(seen);
+    return errors;
+}
+
+int test_mphf()
+{
+    int errors = 0;
+    errors += test_mphf_nkeys(0, true);
+    errors += test_mphf_nkeys(1, true);
+    errors += test_mphf_nkeys(2, false);
+    errors += test_mphf_nkeys(1000, true);
+    errors += test_mphf_nkeys(TEST_MPHF_ITEMS, true);
+    errors += test_mphf_nkeys(TEST_MPHF_ITEMS, false);
+    return errors;
+}
+
+int test_mphf_file()
+{
+    int errors = 0;
+    uint64_t i = 0, size = 0;
+    uint64_t *keys = test_keys(1000);
+    uint8_t *blob = mphf_build(keys, 1000, true, &size);
+    const char *file = "test_mphf.bin";
+    FILE *f = fopen(file, "wb");
+    if ((f == NULL) || (fwrite(blob, 1, size, f) != size))
+    {
+        (void) fprintf(stderr, "%s : Unable to write %s\n", __func__, file);
+        ++errors;
+    }
+    if (f != NULL)
+    {
+        fclose(f);
+    }
+    free(blob);
+    mmfile_t mf = {0};
+    mmap_binfile(file, &mf);
+    mphf_t mph;
+    if ((mf.src == MAP_FAILED) || !mphf_load(mf.src, mf.size, &mph))
+    {
+        (void) fprintf(stderr, "%s : Unable to load %s\n", __func__, file);
+        free(keys);
+        return (errors + 1);
+    }
+    for (i = 0; i < 1000; i++)
+    {
+        if (mph.keys[mphf_index(&mph, keys[i])] != keys[i])
+        {
+            (void) fprintf(stderr, "%s : Unexpected index for key %" PRIu64 "\n", __func__, i);
+            ++errors;
+        }
+    }
+    munmap_binfile(mf);
+    (void) remove(file);
+    free(keys);
+    return errors;
+}
+
+void benchmark_mphf_index()
+{
+    uint64_t i = 0, size = 0, sum = 0;
+    uint64_t *keys = test_keys(TEST_MPHF_ITEMS);
+    uint8_t *blob = mphf_build(keys, TEST_MPHF_ITEMS, true, &size);
+    mphf_t mph;
+    if ((blob == NULL) || !mphf_load(blob, size, &mph))
+    {
+        free(blob);
+        free(keys);
+        return;
+    }
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_MPHF_ITEMS; i++)
+    {
+        sum += mphf_index(&mph, keys[((i * 7919) % TEST_MPHF_ITEMS)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%.2f bits/key, %" PRIu64 " levels, %" PRIu64 ")\n", __func__, (tend - tstart)/TEST_MPHF_ITEMS, (double)(64 * (mph.nwords + mph.nranks)) / TEST_MPHF_ITEMS, mph.nlevels, sum);
+    free(blob);
+    free(keys);
+}
+
+void benchmark_col_find_first()
+{
+    uint64_t i = 0, first = 0, last = 0, sum = 0;
+    uint64_t *keys = test_keys(TEST_MPHF_ITEMS);
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_MPHF_ITEMS; i++)
+    {
+        first = 0;
+        last = TEST_MPHF_ITEMS;
+        sum += col_find_first_uint64_t(keys, &first, &last, keys[((i * 7919) % TEST_MPHF_ITEMS)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/TEST_MPHF_ITEMS, sum);
+    free(keys);
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_mphf();
+    errors += test_mphf_file();
+
+    benchmark_mphf_index();
+    benchmark_col_find_first();
+
+    return errors;
+}
@@ -772,6 +772,274 @@ void benchmark_numkey()
     (void) fprintf(stdout, " * %s : %lu ns/op\n", __func__, (tend - tstart)/size);
 }
 
+int test_numkey_batch()
+{
+    int errors = 0;
+    int i = 0;
+    const char *country[k_numkey_test_size + 1];
+    const char *number[k_numkey_test_size + 1];
+    size_t numsize[k_numkey_test_size + 1];
+    uint64_t nk[k_numkey_test_size + 1];
+    for (i=0 ; i < k_numkey_test_size; i++)
+    {
+        country[i] = test_numkey_data[i].country;
+        number[i] = test_numkey_data[i].number;
+        numsize[i] = strlen(test_numkey_data[i].number);
+    }
+    country[k_numkey_test_size] = "XX";
+    number[k_numkey_test_size] = "9876543210987654321";
+    numsize[k_numkey_test_size] = 19;
+    numkey_batch(country, number, numsize, nk, k_numkey_test_size + 1);
+    for (i=0 ; i < k_numkey_test_size; i++)
+    {
+        if (nk[i] != test_numkey_data[i].nk)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected numkey: expected 0x%016" PRIx64 ", got 0x%016" PRIx64 "\n", __func__, i, test_numkey_data[i].nk, nk[i]);
+            ++errors;
+        }
+    }
+    if (nk[k_numkey_test_size] != 0xc61ee0c29f50cb10)
+    {
+        (void) fprintf(stderr, "%s: Unexpected numkey: expected 0xc61ee0c29f50cb10, got 0x%016" PRIx64 "\n", __func__, nk[k_numkey_test_size]);
+        ++errors;
+    }
+    return errors;
+}
+
+void benchmark_numkey_batch()
+{
+    uint64_t tstart = 0, tend = 0;
+    int i = 0;
+    int size = 100000;
+    const char *country[k_numkey_test_size];
+    const char *number[k_numkey_test_size];
+    size_t numsize[k_numkey_test_size];
+    uint64_t nk[k_numkey_test_size];
+    for (i=0 ; i < k_numkey_test_size; i++)
+    {
+        country[i] = test_numkey_data[i].country;
+        number[i] = test_numkey_data[i].number;
+        numsize[i] = strlen(test_numkey_data[i].number);
+    }
+    tstart = get_time();
+    for (i=0 ; i < size; i += k_numkey_test_size)
+    {
+        numkey_batch(country, number, numsize, nk, k_numkey_test_size);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/size, nk[0]);
+}
+
+int test_numkey_checked()
+{
+    typedef struct test_checked_data_t
+    {
+        const char* country;
+        const char* number;
+        uint8_t status;
+    } test_checked_data_t;
+    static const test_checked_data_t test_checked_data[] =
+    {
+        {"ZZ", "601469829912013", NKSTATUS_OK},
+        {"AA", "0", NKSTATUS_OK},
+        {"XX", "9876543210987654321", NKSTATUS_LONG},
+        {"zz", "601469829912013", NKSTATUS_ECOUNTRY},
+        {"Z@", "601469829912013", NKSTATUS_ECOUNTRY},
+        {"Z[", "601469829912013", NKSTATUS_ECOUNTRY},
+        {"", "601469829912013", NKSTATUS_ECOUNTRY},
+        {"ZZ", "", NKSTATUS_EEMPTY},
+        {"ZZ", "60146982991201/", NKSTATUS_EDIGIT},
+        {"ZZ", ":01469829912013", NKSTATUS_EDIGIT},
+        {"ZZ", "6014 6982", NKSTATUS_EDIGIT},
+        {"ZZ", "+6", NKSTATUS_EDIGIT},
+        {"ZZ", "\xb6", NKSTATUS_EDIGIT},
+        {"XX", "a876543210987654321", NKSTATUS_EDIGIT},
+        {"XX", "987654321098765432a", NKSTATUS_EDIGIT},
+    };
+    static const int k_checked_size = (int)(sizeof(test_checked_data) / sizeof(test_checked_data_t));
+    int errors = 0;
+    int i = 0;
+    uint64_t nk = 0, exp = 0;
+    uint8_t status = 0;
+    const char *country[k_numkey_test_size];
+    const char *number[k_numkey_test_size];
+    size_t numsize[k_numkey_test_size];
+    uint64_t nks[k_numkey_test_size];
+    uint8_t st[k_numkey_test_size];
+    for (i=0 ; i < k_checked_size; i++)
+    {
+        status = numkey_checked(test_checked_data[i].country, test_checked_data[i].number, strlen(test_checked_data[i].number), &nk);
+        if (status != test_checked_data[i].status)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected status: expected %" PRIu8 ", got %" PRIu8 "\n", __func__, i, test_checked_data[i].status, status);
+            ++errors;
+        }
+        exp = (status > NKSTATUS_OK && status < NKSTATUS_LONG) ? 0 : numkey(test_checked_data[i].country, test_checked_data[i].number, strlen(test_checked_data[i].number));
+        if (nk != exp)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected numkey: expected 0x%016" PRIx64 ", got 0x%016" PRIx64 "\n", __func__, i, exp, nk);
+            ++errors;
+        }
+    }
+    for (i=0 ; i < k_numkey_test_size; i++)
+    {
+        country[i] = test_numkey_data[i].country;
+        number[i] = test_numkey_data[i].number;
+        numsize[i] = strlen(test_numkey_data[i].number);
+    }
+    number[1] = "0x";
+    size_t nok = numkey_checked_batch(country, number, numsize, nks, st, k_numkey_test_size);
+    if (nok != (size_t)(k_numkey_test_size - 1))
+    {
+        (void) fprintf(stderr, "%s: Unexpected number of valid items: expected %d, got %zu\n", __func__, (k_numkey_test_size - 1), nok);
+        ++errors;
+    }
+    if ((st[1] != NKSTATUS_EDIGIT) || (nks[1] != 0))
+    {
+        (void) fprintf(stderr, "%s: Unexpected status %" PRIu8 " for invalid item\n", __func__, st[1]);
+        ++errors;
+    }
+    for (i=2 ; i < k_numkey_test_size; i++)
+    {
+        if ((st[i] != NKSTATUS_OK) || (nks[i] != test_numkey_data[i].nk))
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected numkey: expected 0x%016" PRIx64 ", got 0x%016" PRIx64 "\n", __func__, i, test_numkey_data[i].nk, nks[i]);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void benchmark_numkey_checked_batch()
+{
+    uint64_t tstart = 0, tend = 0;
+    int i = 0;
+    int size = 100000;
+    const char *country[k_numkey_test_size];
+    const char *number[k_numkey_test_size];
+    size_t numsize[k_numkey_test_size];
+    uint64_t nk[k_numkey_test_size];
+    uint8_t status[k_numkey_test_size];
+    size_t nok = 0;
+    for (i=0 ; i < k_numkey_test_size; i++)
+    {
+        country[i] = test_numkey_data[i].country;
+        number[i] = test_numkey_data[i].number;
+        numsize[i] = strlen(test_numkey_data[i].number);
+    }
+    tstart = get_time();
+    for (i=0 ; i < size; i += k_numkey_test_size)
+    {
+        nok += numkey_checked_batch(country, number, numsize, nk, status, k_numkey_test_size);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%zu)\n", __func__, (tend - tstart)/size, nok);
+}
+
+int test_numkey_norm()
+{
+    typedef struct test_norm_data_t
+    {
+        const char* number;
+        const char* digits;
+    } test_norm_data_t;
+    static const test_norm_data_t test_norm_data[] =
+    {
+        {"+44 (0)20 7946-0018", "442079460018"},
+        {"0044 20 7946 0018", "442079460018"},
+        {"+1-212-555-0123", "12125550123"},
+        {"601469829912013", "601469829912013"},
+        {"", ""},
+        {"+98 7654-3210 9876 54321", "9876543210987654321"},
+    };
+    int errors = 0;
+    int i = 0;
+    uint64_t nk = 0, exp = 0;
+    size_t len = 0;
+    for (i=0 ; i < 6; i++)
+    {
+        len = numkey_norm("ZZ", test_norm_data[i].number, strlen(test_norm_data[i].number), &nk);
+        exp = numkey("ZZ", test_norm_data[i].digits, strlen(test_norm_data[i].digits));
+        if (len != strlen(test_norm_data[i].digits))
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected length: expected %zu, got %zu\n", __func__, i, strlen(test_norm_data[i].digits), len);
+            ++errors;
+        }
+        if (nk != exp)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected numkey: expected 0x%016" PRIx64 ", got 0x%016" PRIx64 "\n", __func__, i, exp, nk);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void benchmark_numkey_norm()
+{
+    uint64_t tstart = 0, tend = 0;
+    uint64_t nk = 0;
+    int i = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        numkey_norm("GB", "+44 (0)20 7946-0018", 19, &nk);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/size, nk);
+}
+
+int test_numkey_e164()
+{
+    typedef struct test_e164_data_t
+    {
+        const char* number;
+        const char* country;
+    } test_e164_data_t;
+    static const test_e164_data_t test_e164_data[] =
+    {
+        {"447946000018", "GB"},
+        {"12125550123", "US"},
+        {"14165550123", "CA"},
+        {"77012345678", "KZ"},
+        {"74951234567", "RU"},
+        {"886212345678", "TW"},
+        {"80012345678", ""},
+        {"1", ""},
+        {"12", ""},
+        {"120", ""},
+    };
+    int errors = 0;
+    int i = 0;
+    uint64_t nk = 0, exp = 0;
+    for (i=0 ; i < 10; i++)
+    {
+        nk = numkey_e164(test_e164_data[i].number, strlen(test_e164_data[i].number));
+        exp = (test_e164_data[i].country[0] == 0) ? 0 : numkey(test_e164_data[i].country, test_e164_data[i].number, strlen(test_e164_data[i].number));
+        if (nk != exp)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected numkey: expected 0x%016" PRIx64 ", got 0x%016" PRIx64 "\n", __func__, i, exp, nk);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void benchmark_numkey_e164()
+{
+    uint64_t tstart = 0, tend = 0;
+    uint64_t nk = 0;
+    int i = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        nk ^= numkey_e164("447946000018", 12);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/size, nk);
+}
+
 int test_decode_numkey()
 {
     int errors = 0;
@@ -812,6 +1080,82 @@ int test_decode_numkey_long()
     return errors;
 }
 
+// reference decoder using divisions
+size_t decode_number_div(uint64_t nk, char *number)
+{
+    size_t size = (size_t)(nk & NKBMASK_LENGTH);
+    uint64_t num = ((nk & NKBMASK_NUMBER) >> NKBSHIFT_NUMBER);
+    int i = 0;
+    for (i = (int)(size - 1); i >= 0; i--)
+    {
+        number[i] = (char)((num % 10) + '0');
+        num = (num / 10);
+    }
+    number[size] = 0;
+    return size;
+}
+
+int test_decode_number_random()
+{
+    int errors = 0;
+    int i = 0;
+    uint64_t nk = 0x9e3779b97f4a7c15;
+    char exp[NKSLENGTH_NUMBER] = "";
+    char num[NKSLENGTH_NUMBER] = "";
+    for (i=0 ; i < 1000000; i++)
+    {
+        nk ^= (nk << 13);
+        nk ^= (nk >> 7);
+        nk ^= (nk << 17);
+        decode_number_div(nk, exp);
+        decode_number(nk, num);
+        if (strcmp(num, exp) != 0)
+        {
+            (void) fprintf(stderr, "%s (0x%016" PRIx64 "): Unexpected number: expected %s, got %s\n", __func__, nk, exp, num);
+            ++errors;
+        }
+    }
+    nk = (NKBMASK_NUMBER | NKBMASK_LENGTH);
+    decode_number_div(nk, exp);
+    decode_number(nk, num);
+    if (strcmp(num, exp) != 0)
+    {
+        (void) fprintf(stderr, "%s (0x%016" PRIx64 "): Unexpected number: expected %s, got %s\n", __func__, nk, exp, num);
+        ++errors;
+    }
+    return errors;
+}
+
+void benchmark_decode_number()
+{
+    char num[NKSLENGTH_NUMBER] = "";
+    uint64_t tstart = 0, tend = 0;
+    int i = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        decode_number((0xd6a23089b8e15cdf + (uint64_t)i), num);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%s)\n", __func__, (tend - tstart)/size, num);
+}
+
+void benchmark_decode_number_div()
+{
+    char num[NKSLENGTH_NUMBER] = "";
+    uint64_t tstart = 0, tend = 0;
+    int i = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        decode_number_div((0xd6a23089b8e15cdf + (uint64_t)i), num);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%s)\n", __func__, (tend - tstart)/size, num);
+}
+
 void benchmark_decode_numkey()
 {
     numkey_t h = {0};
@@ -827,6 +1171,64 @@ void benchmark_decode_numkey()
     (void) fprintf(stdout, " * %s : %lu ns/op\n", __func__, (tend - tstart)/size);
 }
 
+int test_decode_numkey_batch()
+{
+    int errors = 0;
+    int i = 0;
+    uint64_t nk[k_numkey_test_size];
+    uint16_t country[k_numkey_test_size];
+    uint8_t length[k_numkey_test_size];
+    char number[k_numkey_test_size * NKNUMSTRIDE];
+    uint16_t ck = 0;
+    for (i=0 ; i < k_numkey_test_size; i++)
+    {
+        nk[i] = test_numkey_data[i].nk;
+    }
+    decode_numkey_batch(nk, k_numkey_test_size, country, length, number);
+    for (i=0 ; i < k_numkey_test_size; i++)
+    {
+        ck = (uint16_t)((test_numkey_data[i].country[0] << 8) | test_numkey_data[i].country[1]);
+        if (country[i] != ck)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected country: expected 0x%04" PRIx16 ", got 0x%04" PRIx16 "\n", __func__, i, ck, country[i]);
+            ++errors;
+        }
+        if (length[i] != strlen(test_numkey_data[i].number))
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected length: expected %zu, got %" PRIu8 "\n", __func__, i, strlen(test_numkey_data[i].number), length[i]);
+            ++errors;
+        }
+        if (strcmp(&number[i * NKNUMSTRIDE], test_numkey_data[i].number) != 0)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected number: expected %s, got %s\n", __func__, i, test_numkey_data[i].number, &number[i * NKNUMSTRIDE]);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void benchmark_decode_numkey_batch()
+{
+    uint64_t nk[k_numkey_test_size];
+    uint16_t country[k_numkey_test_size];
+    uint8_t length[k_numkey_test_size];
+    char number[k_numkey_test_size * NKNUMSTRIDE];
+    uint64_t tstart = 0, tend = 0;
+    int i = 0;
+    int size = 100000;
+    for (i=0 ; i < k_numkey_test_size; i++)
+    {
+        nk[i] = test_numkey_data[i].nk;
+    }
+    tstart = get_time();
+    for (i=0 ; i < size; i += k_numkey_test_size)
+    {
+        decode_numkey_batch(nk, k_numkey_test_size, country, length, number);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%s)\n", __func__, (tend - tstart)/size, number);
+}
+
 int test_compare_numkey_country()
 {
     typedef struct test_compare_data_t
@@ -869,6 +1271,201 @@ void benchmark_compare_numkey_country()
     (void) fprintf(stdout, " * %s : %lu ns/op\n", __func__, (tend - tstart)/size);
 }
 
+int test_numkey_country_range()
+{
+    static const char *countries[4] = {"DE", "GB", "GD", "US"};
+    int errors = 0;
+    int i = 0, c = 0;
+    uint64_t s = 0x9e3779b97f4a7c15;
+    uint64_t lo = 0, hi = 0, llo = 0, lhi = 0, plo = 0, phi = 0, nk = 0;
+    size_t size = 0, j = 0;
+    bool match = false, inrange = false;
+    char number[NKSLENGTH_NUMBER] = "";
+    for (i=0 ; i < 100000; i++)
+    {
+        s ^= (s << 13);
+        s ^= (s >> 7);
+        s ^= (s << 17);
+        size = (size_t)(1 + ((s >> 8) % NKNUMMAXLEN));
+        for (j = 0; j < size; j++)
+        {
+            number[j] = (char)('0' + ((s >> (j * 4)) % ((j & 1) ? 3 : 10)));
+        }
+        c = (int)((s >> 60) & 3);
+        nk = numkey(countries[c], number, size);
+        numkey_country_range("GB", &lo, &hi);
+        match = (c == 1);
+        inrange = ((nk >= lo) && (nk <= hi));
+        if (match != inrange)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected country range for %s %.*s\n", __func__, i, countries[c], (int)size, number);
+            ++errors;
+        }
+        if (!numkey_country_length_range("GB", 6, &llo, &lhi))
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected invalid length range\n", __func__, i);
+            ++errors;
+        }
+        match = ((c == 1) && (size == 6));
+        inrange = ((nk >= llo) && (nk <= lhi) && ((nk & NKBMASK_LENGTH) == 6));
+        if (match != inrange)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected length range for %s %.*s\n", __func__, i, countries[c], (int)size, number);
+            ++errors;
+        }
+        if (numkey_country_prefix_range("GB", "20", 2, size, &plo, &phi) != (size >= 2))
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected prefix range validity\n", __func__, i);
+            ++errors;
+        }
+        match = ((c == 1) && (size >= 2) && (number[0] == '2') && (number[1] == '0'));
+        inrange = ((size >= 2) && (nk >= plo) && (nk <= phi) && ((nk & NKBMASK_LENGTH) == size));
+        if (match != inrange)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected prefix range for %s %.*s\n", __func__, i, countries[c], (int)size, number);
+            ++errors;
+        }
+    }
+    // tight bounds
+    numkey_country_prefix_range("GB", "20", 2, 4, &plo, &phi);
+    if ((plo != numkey("GB", "2000", 4)) || (phi != numkey("GB", "2099", 4)))
+    {
+        (void) fprintf(stderr, "%s : Unexpected prefix range bounds: %016" PRIx64 " %016" PRIx64 "\n", __func__, plo, phi);
+        ++errors;
+    }
+    numkey_country_length_range("GB", 3, &llo, &lhi);
+    if ((llo != numkey("GB", "000", 3)) || (lhi != numkey("GB", "999", 3)))
+    {
+        (void) fprintf(stderr, "%s : Unexpected length range bounds: %016" PRIx64 " %016" PRIx64 "\n", __func__, llo, lhi);
+        ++errors;
+    }
+    if (numkey_country_length_range("GB", 16, &llo, &lhi) || numkey_country_prefix_range("GB", "123", 3, 2, &plo, &phi) || numkey_country_prefix_range("GB", "1", 1, 0, &plo, &phi))
+    {
+        (void) fprintf(stderr, "%s : Expected invalid ranges\n", __func__);
+        ++errors;
+    }
+    return errors;
+}
+
+void benchmark_numkey_country_prefix_range()
+{
+    uint64_t tstart = 0, tend = 0;
+    uint64_t lo = 0, hi = 0, sum = 0;
+    int i = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        numkey_country_prefix_range("GB", "2079", 4, (size_t)(10 + (i & 1)), &lo, &hi);
+        sum += (hi - lo);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/size, sum);
+}
+
+int test_numkey_lex()
+{
+    int errors = 0;
+    int i = 0, exp = 0, res = 0;
+    uint64_t s = 0x0123456789abcdef;
+    uint64_t nka = 0, nkb = 0, lo = 0, hi = 0;
+    size_t sa = 0, sb = 0, j = 0;
+    bool match = false, inrange = false;
+    char na[NKSLENGTH_NUMBER] = "", nb[NKSLENGTH_NUMBER] = "";
+    numkey_t h = {{0}, {0}};
+    if (numkey_lex("GB", "4420", 4) != (numkey("GB", "", 0) | ((uint64_t)442000000000000 << NKBSHIFT_NUMBER) | 4))
+    {
+        (void) fprintf(stderr, "%s : Unexpected numkey_lex code\n", __func__);
+        ++errors;
+    }
+    if (numkey_lex("GB", "1234567890123456", 16) != numkey_lex("GB", "123456789012345", 15) - 15)
+    {
+        (void) fprintf(stderr, "%s : Unexpected long numkey_lex code\n", __func__);
+        ++errors;
+    }
+    if (!numkey_lex_prefix_range("GB", "", 0, &lo, &hi) || (lo != numkey("GB", "", 0)) || (hi != (numkey("GB", "", 0) | 0x0038d7ea4c67ffff)))
+    {
+        (void) fprintf(stderr, "%s : Unexpected empty prefix range\n", __func__);
+        ++errors;
+    }
+    if (numkey_lex_prefix_range("GB", "1234567890123456", 16, &lo, &hi))
+    {
+        (void) fprintf(stderr, "%s : Expected invalid prefix range\n", __func__);
+        ++errors;
+    }
+    for (i=0 ; i < 100000; i++)
+    {
+        s ^= (s << 13);
+        s ^= (s >> 7);
+        s ^= (s << 17);
+        sa = (size_t)(1 + ((s >> 4) % NKNUMMAXLEN));
+        sb = (size_t)(1 + ((s >> 8) % NKNUMMAXLEN));
+        for (j = 0; j < NKNUMMAXLEN; j++)
+        {
+            na[j] = (char)('0' + ((s >> (j * 2)) & 3));
+            nb[j] = (char)('0' + ((s >> (j * 3)) & 3));
+        }
+        na[sa] = 0;
+        nb[sb] = 0;
+        nka = numkey_lex("IT", na, sa);
+        nkb = numkey_lex("IT", nb, sb);
+        decode_numkey_lex(nka, &h);
+        if ((strcmp(h.country, "IT") != 0) || (strcmp(h.number, na) != 0))
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected decoded number: expected %s, got %s\n", __func__, i, na, h.number);
+            ++errors;
+        }
+        exp = strcmp(na, nb);
+        exp = (exp > 0) - (exp < 0);
+        res = (nka > nkb) - (nka < nkb);
+        if (res != exp)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected order for %s - %s: expected %d, got %d\n", __func__, i, na, nb, exp, res);
+            ++errors;
+        }
+        numkey_lex_prefix_range("IT", nb, (sb >> 1), &lo, &hi);
+        match = (strncmp(na, nb, (sb >> 1)) == 0) && (sa >= (sb >> 1));
+        inrange = ((nka >= lo) && (nka <= hi));
+        if (match != inrange)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected prefix range for %s - %.*s\n", __func__, i, na, (int)(sb >> 1), nb);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void benchmark_numkey_lex()
+{
+    uint64_t tstart = 0, tend = 0;
+    uint64_t nk = 0;
+    int i = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        nk ^= numkey_lex("GB", "447911123456", 12);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/size, nk);
+}
+
+void benchmark_decode_numkey_lex()
+{
+    numkey_t h = {{0}, {0}};
+    uint64_t nk = numkey_lex("GB", "447911123456", 12);
+    uint64_t tstart = 0, tend = 0;
+    int i = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        decode_numkey_lex((nk ^ (uint64_t)(i & 0x10)), &h);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%s)\n", __func__, (tend - tstart)/size, h.number);
+}
+
 int test_numkey_hex()
 {
     int errors = 0;
@@ -946,15 +1543,33 @@ int main()
 
     errors += test_numkey();
     errors += test_numkey_long();
+    errors += test_numkey_batch();
+    errors += test_numkey_checked();
+    errors += test_numkey_norm();
+    errors += test_numkey_e164();
     errors += test_decode_numkey();
     errors += test_decode_numkey_long();
+    errors += test_decode_number_random();
+    errors += test_decode_numkey_batch();
     errors += test_compare_numkey_country();
+    errors += test_numkey_country_range();
+    errors += test_numkey_lex();
     errors += test_numkey_hex();
     errors += test_parse_numkey_hex();
 
     benchmark_numkey();
+    benchmark_numkey_batch();
+    benchmark_numkey_checked_batch();
+    benchmark_numkey_norm();
+    benchmark_numkey_e164();
     benchmark_decode_numkey();
+    benchmark_decode_number();
+    benchmark_decode_number_div();
+    benchmark_decode_numkey_batch();
     benchmark_compare_numkey_country();
+    benchmark_numkey_country_prefix_range();
+    benchmark_numkey_lex();
+    benchmark_decode_numkey_lex();
     benchmark_numkey_hex();
     benchmark_parse_numkey_hex();
 
@@ -0,0 +1,285 @@
+// NumKey
+//
+// test_numkey128.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for numkey128
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/numkey128.h"
+
+static const int k_numkey128_test_size = 9;
+
+typedef struct test_numkey128_data_t
+{
+    const char* country;
+    const char* number;
+    uint64_t    hi;
+    uint64_t    lo;
+    const char* decoded;
+} test_numkey128_data_t;
+
+static const test_numkey128_data_t test_numkey128_data[] =
+{
+    {"ZZ", "", 0xd680000000000000, 0x0000000000000000, ""},
+    {"AA", "0", 0x0840000000000000, 0x0000000000000001, "0"},
+    {"IT", "0039", 0x4d00000000000000, 0x00000000000004e4, "0039"},
+    {"GB", "447911123456", 0x3880000000000000, 0x00000d0932ab400c, "447911123456"},
+    {"US", "123456789012345", 0xacc0000000000000, 0x000e0910c1bbef2f, "123456789012345"},
+    {"DE", "1234567890123456", 0x2140000000000000, 0x008c5aa791575810, "1234567890123456"},
+    {"XX", "9999999999999999999999999999999", 0xc6000fc6f7c40458, 0x122964cfffffffff, "9999999999999999999999999999999"},
+    {"ZZ", "0000000000000000000000000000001", 0xd680000000000000, 0x000000000000003f, "0000000000000000000000000000001"},
+    {"FR", "12345678901234567890123456789012345", 0x348008f5b0a00f0e, 0x976c11fe3c5bef20, ""},
+};
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+static inline uint64_t xorshift64(uint64_t *s)
+{
+    *s ^= (*s << 13);
+    *s ^= (*s >> 7);
+    *s ^= (*s << 17);
+    return *s;
+}
+
+// generates a random number string with the specified length
+static inline void random_number(uint64_t *s, char *number, size_t size)
+{
+    size_t i = 0;
+    for (i = 0; i < size; i++)
+    {
+        number[i] = (char)('0' + (xorshift64(s) % 10));
+    }
+    number[size] = 0;
+}
+
+// compares country, numeric value and length of two number strings
+static inline int compare_numbers(const char *ca, const char *na, const char *cb, const char *nb)
+{
+    int c = strcmp(ca, cb);
+    if (c != 0)
+    {
+        return (c > 0) - (c < 0);
+    }
+    size_t la = strlen(na), lb = strlen(nb);
+    const char *va = na, *vb = nb;
+    while (*va == '0')
+    {
+        va++;
+    }
+    while (*vb == '0')
+    {
+        vb++;
+    }
+    size_t sa = strlen(va), sb = strlen(vb);
+    if (sa != sb)
+    {
+        return (sa > sb) ? 1 : -1;
+    }
+    c = strcmp(va, vb);
+    if (c != 0)
+    {
+        return (c > 0) - (c < 0);
+    }
+    return (la > lb) - (la < lb);
+}
+
+int test_numkey128()
+{
+    int errors = 0;
+    int i = 0;
+    numkey128_t nk;
+    for (i=0 ; i < k_numkey128_test_size; i++)
+    {
+        nk = numkey128(test_numkey128_data[i].country, test_numkey128_data[i].number, strlen(test_numkey128_data[i].number));
+        if ((nk.hi != test_numkey128_data[i].hi) || (nk.lo != test_numkey128_data[i].lo))
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected numkey128: expected 0x%016" PRIx64 "%016" PRIx64 ", got 0x%016" PRIx64 "%016" PRIx64 "\n", __func__, i, test_numkey128_data[i].hi, test_numkey128_data[i].lo, nk.hi, nk.lo);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+int test_decode_numkey128()
+{
+    int errors = 0;
+    int i = 0;
+    numkey128_t nk;
+    numkey128_data_t h = {{0}, {0}};
+    for (i=0 ; i < k_numkey128_test_size; i++)
+    {
+        nk.hi = test_numkey128_data[i].hi;
+        nk.lo = test_numkey128_data[i].lo;
+        decode_numkey128(nk, &h);
+        if (strcmp(h.country, test_numkey128_data[i].country) != 0)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected country: expected %s, got %s\n", __func__, i, test_numkey128_data[i].country, h.country);
+            ++errors;
+        }
+        if (strcmp(h.number, test_numkey128_data[i].decoded) != 0)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected number: expected %s, got %s\n", __func__, i, test_numkey128_data[i].decoded, h.number);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+int test_numkey128_random()
+{
+    int errors = 0;
+    int i = 0;
+    uint64_t s = 0x9e3779b97f4a7c15;
+    size_t size = 0;
+    char number[NK128SLENGTH_NUMBER] = "";
+    char decoded[NK128SLENGTH_NUMBER] = "";
+    numkey128_t nk, nk64;
+    for (i=0 ; i < 100000; i++)
+    {
+        size = (size_t)(1 + (xorshift64(&s) % NK128NUMMAXLEN));
+        random_number(&s, number, size);
+        nk = numkey128("AB", number, size);
+        decode_number128(nk, decoded);
+        if (strcmp(number, decoded) != 0)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected number: expected %s, got %s\n", __func__, i, number, decoded);
+            ++errors;
+        }
+        if (size <= NKNUMMAXLEN)
+        {
+            nk64 = numkey128_from_numkey(numkey("AB", number, size));
+            if ((nk64.hi != nk.hi) || (nk64.lo != nk.lo))
+            {
+                (void) fprintf(stderr, "%s (%d): Unexpected numkey128_from_numkey for %s\n", __func__, i, number);
+                ++errors;
+            }
+        }
+    }
+    return errors;
+}
+
+int test_compare_numkey128()
+{
+    int errors = 0;
+    int i = 0;
+    uint64_t s = 0x0123456789abcdef;
+    size_t sa = 0, sb = 0;
+    char na[NK128SLENGTH_NUMBER] = "", nb[NK128SLENGTH_NUMBER] = "";
+    const char *ca = NULL, *cb = NULL;
+    int exp = 0, res = 0;
+    for (i=0 ; i < 100000; i++)
+    {
+        ca = (xorshift64(&s) & 1) ? "GB" : "US";
+        cb = (xorshift64(&s) & 1) ? "GB" : "US";
+        sa = (size_t)(1 + (xorshift64(&s) % NK128NUMMAXLEN));
+        sb = (size_t)(1 + (xorshift64(&s) % NK128NUMMAXLEN));
+        random_number(&s, na, sa);
+        if ((sa > 1) && (xorshift64(&s) & 1))
+        {
+            na[0] = '0'; // same value with an extra leading zero to exercise the length ordering
+            sb = (sa - 1);
+            memcpy(nb, na + 1, sa);
+        }
+        else
+        {
+            random_number(&s, nb, sb);
+        }
+        exp = compare_numbers(ca, na, cb, nb);
+        res = compare_numkey128(numkey128(ca, na, sa), numkey128(cb, nb, sb));
+        if (res != exp)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected order for %s %s - %s %s: expected %d, got %d\n", __func__, i, ca, na, cb, nb, exp, res);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+int test_numkey128_hex()
+{
+    int errors = 0;
+    int i = 0;
+    char hex[33] = "";
+    numkey128_t nk;
+    for (i=0 ; i < k_numkey128_test_size; i++)
+    {
+        nk.hi = test_numkey128_data[i].hi;
+        nk.lo = test_numkey128_data[i].lo;
+        if (numkey128_hex(nk, hex) != 32)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected hex length\n", __func__, i);
+            ++errors;
+        }
+        nk = parse_numkey128_hex(hex);
+        if ((nk.hi != test_numkey128_data[i].hi) || (nk.lo != test_numkey128_data[i].lo))
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected parsed code for %s\n", __func__, i, hex);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void benchmark_numkey128()
+{
+    uint64_t tstart = 0, tend = 0;
+    numkey128_t nk;
+    uint64_t sum = 0;
+    int i = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        nk = numkey128("XX", "1234567890123456789012345", 25);
+        sum += nk.lo;
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/size, sum);
+}
+
+void benchmark_decode_numkey128()
+{
+    numkey128_t nk = numkey128("XX", "1234567890123456789012345", 25);
+    numkey128_data_t h = {{0}, {0}};
+    uint64_t tstart = 0, tend = 0;
+    int i = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        nk.lo ^= ((uint64_t)(i & 1) << 5);
+        decode_numkey128(nk, &h);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%s)\n", __func__, (tend - tstart)/size, h.number);
+}
+
+int main()
+{
+    static int errors = 0;
+
+    errors += test_numkey128();
+    errors += test_decode_numkey128();
+    errors += test_numkey128_random();
+    errors += test_compare_numkey128();
+    errors += test_numkey128_hex();
+
+    benchmark_numkey128();
+    benchmark_decode_numkey128();
+
+    return errors;
+}
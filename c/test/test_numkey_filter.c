@@ -0,0 +1,270 @@
+// NumKey
+//
+// test_numkey_filter.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for numkey_filter
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/binsearch.h"
+#include "../src/numkey/numkey_filter.h"
+
+#define TEST_FILTER_ITEMS 200000
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+// generates a sorted set of NumKeys: the even numbers are in the set, the odd ones are not
+static inline uint64_t *test_keys(uint64_t nkeys, uint64_t odd)
+{
+    uint64_t *keys = (uint64_t *)malloc(((nkeys > 0) ? nkeys : 1) * sizeof(uint64_t));
+    uint64_t i = 0;
+    for (i = 0; i < nkeys; i++)
+    {
+        keys[i] = (numkey("US", "", 0) | ((12125550000 + (i * 2) + odd) << NKBSHIFT_NUMBER) | 11);
+    }
+    return keys;
+}
+
+int test_numkey_filter_nkeys(uint64_t nkeys, uint8_t fpbits, uint64_t maxfp)
+{
+    int errors = 0;
+    uint64_t i = 0, size = 0, fp = 0;
+    uint64_t *keys = test_keys(nkeys, 0);
+    uint64_t *miss = test_keys(nkeys, 1);
+    numkey_filter_t f;
+    uint8_t *blob = numkey_filter_build(keys, nkeys, fpbits, &size);
+    if ((blob == NULL) || !numkey_filter_load(blob, size, &f))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ", %u) : Unable to build the filter\n", __func__, nkeys, fpbits);
+        free(keys);
+        free(miss);
+        free(blob);
+        return 1;
+    }
+    for (i = 0; i < nkeys; i++)
+    {
+        if (!numkey_filter_has(&f, keys[i]))
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ", %u) : Unexpected false negative for key %" PRIu64 "\n", __func__, nkeys, fpbits, i);
+            ++errors;
+        }
+        fp += numkey_filter_has(&f, miss[i]);
+    }
+    if (fp > maxfp)
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ", %u) : Too many false positives: %" PRIu64 "\n", __func__, nkeys, fpbits, fp);
+        ++errors;
+    }
+    if (numkey_filter_load(blob, (size - 8), &f))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ", %u) : Expected invalid blob size\n", __func__, nkeys, fpbits);
+        ++errors;
+    }
+    free(blob);
+    free(keys);
+    free(miss);
+    return errors;
+}
+
+int test_numkey_filter()
+{
+    int errors = 0;
+    errors += test_numkey_filter_nkeys(0, 8, 0);
+    errors += test_numkey_filter_nkeys(1, 8, 1);
+    errors += test_numkey_filter_nkeys(1000, 8, 20);
+    errors += test_numkey_filter_nkeys(TEST_FILTER_ITEMS, 8, (TEST_FILTER_ITEMS / 200));
+    errors += test_numkey_filter_nkeys(TEST_FILTER_ITEMS, 16, (TEST_FILTER_ITEMS / 20000));
+    uint64_t size = 0;
+    if (numkey_filter_build(NULL, 0, 32, &size) != NULL)
+    {
+        (void) fprintf(stderr, "%s : Expected invalid fingerprint size\n", __func__);
+        ++errors;
+    }
+    return errors;
+}
+
+int test_numkey_filter_duplicates()
+{
+    int errors = 0;
+    uint64_t keys[] = {1, 2, 2, 2, 3, 5, 5, 8};
+    uint64_t i = 0, size = 0;
+    numkey_filter_t f;
+    uint8_t *blob = numkey_filter_build(keys, 8, 16, &size);
+    if ((blob == NULL) || !numkey_filter_load(blob, size, &f) || (f.nkeys != 5))
+    {
+        (void) fprintf(stderr, "%s : Unable to build the filter\n", __func__);
+        free(blob);
+        return 1;
+    }
+    for (i = 0; i < 8; i++)
+    {
+        if (!numkey_filter_has(&f, keys[i]))
+        {
+            (void) fprintf(stderr, "%s : Unexpected false negative for key %" PRIu64 "\n", __func__, keys[i]);
+            ++errors;
+        }
+    }
+    free(blob);
+    return errors;
+}
+
+int test_numkey_filter_contains()
+{
+    int errors = 0;
+    uint64_t i = 0, size = 0, count = 0, exp = 0;
+    uint64_t *keys = test_keys(1000, 0);
+    uint64_t *query = test_keys(1003, 0);
+    bool found[1003];
+    for (i = 0; i < 1003; i += 3)
+    {
+        query[i] |= ((uint64_t)1 << NKBSHIFT_NUMBER); // odd number, not in the set
+    }
+    uint8_t *blob = numkey_filter_build(keys, 1000, 8, &size);
+    const char *file = "test_numkey_filter.bin";
+    FILE *fo = fopen(file, "wb");
+    if ((fo == NULL) || (fwrite(blob, 1, size, fo) != size))
+    {
+        (void) fprintf(stderr, "%s : Unable to write %s\n", __func__, file);
+        ++errors;
+    }
+    if (fo != NULL)
+    {
+        fclose(fo);
+    }
+    free(blob);
+    mmfile_t mf = {0};
+    mmap_binfile(file, &mf);
+    numkey_filter_t f;
+    if ((mf.src == MAP_FAILED) || !numkey_filter_load(mf.src, mf.size, &f))
+    {
+        (void) fprintf(stderr, "%s : Unable to load %s\n", __func__, file);
+        free(keys);
+        free(query);
+        return (errors + 1);
+    }
+    count = numkey_filter_contains(&f, query, 1003, found);
+    for (i = 0; i < 1003; i++)
+    {
+        if (found[i] != numkey_filter_has(&f, query[i]))
+        {
+            (void) fprintf(stderr, "%s : Unexpected result for key %" PRIu64 "\n", __func__, i);
+            ++errors;
+        }
+        exp += found[i];
+    }
+    if ((count != exp) || (count < 666))
+    {
+        (void) fprintf(stderr, "%s : Unexpected count: %" PRIu64 "\n", __func__, count);
+        ++errors;
+    }
+    munmap_binfile(mf);
+    (void) remove(file);
+    free(keys);
+    free(query);
+    return errors;
+}
+
+void benchmark_numkey_filter_has()
+{
+    uint64_t i = 0, size = 0, sum = 0;
+    uint64_t *keys = test_keys(TEST_FILTER_ITEMS, 0);
+    uint64_t *miss = test_keys(TEST_FILTER_ITEMS, 1);
+    numkey_filter_t f;
+    uint8_t *blob = numkey_filter_build(keys, TEST_FILTER_ITEMS, 8, &size);
+    if ((blob == NULL) || !numkey_filter_load(blob, size, &f))
+    {
+        free(blob);
+        free(keys);
+        free(miss);
+        return;
+    }
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_FILTER_ITEMS; i++)
+    {
+        sum += numkey_filter_has(&f, miss[((i * 7919) % TEST_FILTER_ITEMS)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/TEST_FILTER_ITEMS, sum);
+    free(blob);
+    free(keys);
+    free(miss);
+}
+
+void benchmark_numkey_filter_contains()
+{
+    uint64_t i = 0, size = 0, sum = 0;
+    uint64_t *keys = test_keys(TEST_FILTER_ITEMS, 0);
+    uint64_t *miss = test_keys(TEST_FILTER_ITEMS, 1);
+    bool *found = (bool *)malloc(TEST_FILTER_ITEMS * sizeof(bool));
+    numkey_filter_t f;
+    uint8_t *blob = numkey_filter_build(keys, TEST_FILTER_ITEMS, 8, &size);
+    if ((blob == NULL) || (found == NULL) || !numkey_filter_load(blob, size, &f))
+    {
+        free(blob);
+        free(keys);
+        free(miss);
+        free(found);
+        return;
+    }
+    for (i = 0; i < TEST_FILTER_ITEMS; i++)
+    {
+        keys[i] = miss[((i * 7919) % TEST_FILTER_ITEMS)];
+    }
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    sum = numkey_filter_contains(&f, keys, TEST_FILTER_ITEMS, found);
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/TEST_FILTER_ITEMS, sum);
+    free(blob);
+    free(keys);
+    free(miss);
+    free(found);
+}
+
+void benchmark_col_find_first_miss()
+{
+    uint64_t i = 0, first = 0, last = 0, sum = 0;
+    uint64_t *keys = test_keys(TEST_FILTER_ITEMS, 0);
+    uint64_t *miss = test_keys(TEST_FILTER_ITEMS, 1);
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_FILTER_ITEMS; i++)
+    {
+        first = 0;
+        last = (TEST_FILTER_ITEMS - 1); // the search may read keys[last]: stay within the array as the misses are above all keys
+        sum += col_find_first_uint64_t(keys, &first, &last, miss[((i * 7919) % TEST_FILTER_ITEMS)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/TEST_FILTER_ITEMS, sum);
+    free(keys);
+    free(miss);
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_numkey_filter();
+    errors += test_numkey_filter_duplicates();
+    errors += test_numkey_filter_contains();
+
+    benchmark_numkey_filter_has();
+    benchmark_numkey_filter_contains();
+    benchmark_col_find_first_miss();
+
+    return errors;
+}
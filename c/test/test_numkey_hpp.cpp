@@ -0,0 +1,215 @@
+// NumKey
+//
+// test_numkey_hpp.cpp
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for the C++ interface
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include "../src/numkey/numkey.hpp"
+
+using namespace nk;
+
+// compile-time keys
+constexpr NumKey k_gb_mobile = make_numkey("GB", "447911123456");
+constexpr NumKey k_us_long = make_numkey("US", "1234567890123456");
+constexpr PrefixKey k_uk_prefix = make_prefixkey("4479");
+constexpr CountryKey k_gb = make_countrykey("GB");
+
+static_assert(k_gb_mobile.value() == 0x388006849955a00c);
+static_assert(length(k_gb_mobile) == 12);
+static_assert(number(k_gb_mobile) == 447911123456);
+static_assert(length(k_us_long) == 0);
+static_assert(number(k_us_long) == 234567890123456);
+static_assert(k_uk_prefix.value() == 447900000000000);
+static_assert(k_gb.value() == 0x4742);
+static_assert(country(k_gb_mobile) == k_gb);
+static_assert(country_code(k_gb)[0] == 'G' && country_code(k_gb)[1] == 'B' && country_code(k_gb)[2] == 0);
+static_assert(number_string(make_numkey("IT", "0039"))[0] == '0' && number_string(make_numkey("IT", "0039"))[3] == '9');
+static_assert(country_range("GB").first <= k_gb_mobile && k_gb_mobile <= country_range("GB").second);
+static_assert(!std::is_convertible_v<NumKey, PrefixKey> && !std::is_convertible_v<uint64_t, NumKey>);
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+// the constexpr keys can be used as case labels
+int route(NumKey nk)
+{
+    switch (nk.value())
+    {
+    case k_gb_mobile.value():
+        return 1;
+    case make_numkey("US", "12125550123").value():
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+int test_constexpr_runtime()
+{
+    int errors = 0;
+    static const char *const data[][2] =
+    {
+        {"GB", "447911123456"},
+        {"US", "12125550123"},
+        {"IT", "0039"},
+        {"ZZ", ""},
+        {"FR", "1234567890123456789"},
+    };
+    for (const auto &d : data)
+    {
+        const NumKey nk = make_numkey(d[0], d[1]);
+        if (nk.value() != ::numkey(d[0], d[1], std::strlen(d[1])))
+        {
+            (void) std::fprintf(stderr, "%s: Unexpected numkey for %s %s\n", __func__, d[0], d[1]);
+            ++errors;
+        }
+        if (make_prefixkey(d[1]).value() != ::prefixkey(d[1], std::strlen(d[1])))
+        {
+            (void) std::fprintf(stderr, "%s: Unexpected prefixkey for %s\n", __func__, d[1]);
+            ++errors;
+        }
+        if (make_countrykey(d[0]).value() != ::countrykey(d[0]))
+        {
+            (void) std::fprintf(stderr, "%s: Unexpected countrykey for %s\n", __func__, d[0]);
+            ++errors;
+        }
+        numkey_t h{};
+        ::decode_numkey(nk.value(), &h);
+        if ((std::strcmp(number_string(nk).data(), h.number) != 0) || (std::strcmp(country_code(country(nk)).data(), h.country) != 0))
+        {
+            (void) std::fprintf(stderr, "%s: Unexpected decoded values for %s %s\n", __func__, d[0], d[1]);
+            ++errors;
+        }
+    }
+    if ((route(k_gb_mobile) != 1) || (route(make_numkey("US", "12125550123")) != 2) || (route(NumKey()) != 0))
+    {
+        (void) std::fprintf(stderr, "%s: Unexpected route\n", __func__);
+        ++errors;
+    }
+    return errors;
+}
+
+int test_span_batch()
+{
+    int errors = 0;
+    const char *const country[] = {"US", "GB", "IT", "GB", "DE"};
+    const char *const number[] = {"12125550123", "447911123456", "0039", "447911123456", "4930123456"};
+    const std::size_t numsize[] = {11, 12, 4, 12, 10};
+    std::vector<NumKey> nk(5), tmp(5);
+    if (encode(country, number, numsize, nk) != 5)
+    {
+        (void) std::fprintf(stderr, "%s: Unexpected number of encoded items\n", __func__);
+        return 1;
+    }
+    for (std::size_t i = 0; i < 5; i++)
+    {
+        if (nk[i] != make_numkey(country[i], number[i]))
+        {
+            (void) std::fprintf(stderr, "%s (%zu): Unexpected batch numkey\n", __func__, i);
+            ++errors;
+        }
+    }
+    std::vector<CountryKey> ck(5);
+    std::vector<uint8_t> len(5);
+    std::vector<char> num(5 * NKNUMSTRIDE);
+    decode(nk, ck, len, num);
+    for (std::size_t i = 0; i < 5; i++)
+    {
+        if ((ck[i] != make_countrykey(country[i])) || (len[i] != numsize[i]) || (std::strncmp(&num[i * NKNUMSTRIDE], number[i], numsize[i]) != 0))
+        {
+            (void) std::fprintf(stderr, "%s (%zu): Unexpected batch decoded values\n", __func__, i);
+            ++errors;
+        }
+    }
+    const std::vector<NumKey> unsorted(nk);
+    if ((sort(std::span<NumKey>(nk), std::span<NumKey>(tmp).first(4)) != 0) || (nk != unsorted))
+    {
+        (void) std::fprintf(stderr, "%s: Expected no sort with a small temporary span\n", __func__);
+        ++errors;
+    }
+    if (sort(std::span<NumKey>(nk), std::span<NumKey>(tmp)) != 5)
+    {
+        (void) std::fprintf(stderr, "%s: Unexpected number of sorted keys\n", __func__);
+        ++errors;
+    }
+    for (std::size_t i = 1; i < 5; i++)
+    {
+        if (nk[i - 1] > nk[i])
+        {
+            (void) std::fprintf(stderr, "%s (%zu): Unexpected sort order\n", __func__, i);
+            ++errors;
+        }
+    }
+    const std::span<const NumKey> keys(nk);
+    auto ff = find_first(keys, k_gb_mobile);
+    auto fl = find_last(keys, k_gb_mobile);
+    if (!ff || !fl || (*ff != 1) || (*fl != 2))
+    {
+        (void) std::fprintf(stderr, "%s: Unexpected find results\n", __func__);
+        ++errors;
+    }
+    if (find_first(keys, make_numkey("GB", "1")) || find_last(keys, make_numkey("ZZ", "1")))
+    {
+        (void) std::fprintf(stderr, "%s: Unexpected find results for missing keys\n", __func__);
+        ++errors;
+    }
+    const NumKey k_min(0), k_max(UINT64_MAX);
+    if (find_first(keys, k_min) || find_last(keys, k_min) || find_first(keys, k_max) || find_last(keys, k_max))
+    {
+        (void) std::fprintf(stderr, "%s: Unexpected find results for keys outside the range\n", __func__);
+        ++errors;
+    }
+    if (find_first(keys, keys.front()).value_or(5) != 0 || find_last(keys, keys.back()).value_or(0) != 4)
+    {
+        (void) std::fprintf(stderr, "%s: Unexpected find results for the boundary keys\n", __func__);
+        ++errors;
+    }
+    const std::span<const NumKey> empty;
+    if (find_first(empty, k_gb_mobile) || find_last(empty, k_gb_mobile))
+    {
+        (void) std::fprintf(stderr, "%s: Unexpected find results on an empty span\n", __func__);
+        ++errors;
+    }
+    return errors;
+}
+
+void benchmark_make_numkey()
+{
+    uint64_t tstart = 0, tend = 0;
+    uint64_t sum = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (int i = 0; i < size; i++)
+    {
+        sum += make_numkey("GB", ((i & 1) ? "447911123456" : "447911123457")).value();
+    }
+    tend = get_time();
+    (void) std::fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIx64 ")\n", __func__, (tend - tstart)/size, sum);
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_constexpr_runtime();
+    errors += test_span_batch();
+
+    benchmark_make_numkey();
+
+    return errors;
+}
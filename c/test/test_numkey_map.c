@@ -0,0 +1,186 @@
+// NumKey
+//
+// test_numkey_map.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for numkey_map
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/numkey_map.h"
+
+#define TEST_MAP_ITEMS 100000
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+// generates NumKeys for consecutive numbers of the same country and length (worst case for naive hashing)
+static inline uint64_t test_key(uint64_t i)
+{
+    return (numkey("GB", "", 0) | ((447911000000 + i) << NKBSHIFT_NUMBER) | 12);
+}
+
+int test_numkey_map()
+{
+    int errors = 0;
+    uint64_t i = 0, v = 0;
+    numkey_map_t m;
+    if (!numkey_map_init(&m, 0))
+    {
+        (void) fprintf(stderr, "%s : Unable to allocate the map\n", __func__);
+        return 1;
+    }
+    for (i = 0; i < TEST_MAP_ITEMS; i++)
+    {
+        if (!numkey_map_put(&m, test_key(i), i))
+        {
+            (void) fprintf(stderr, "%s : Unable to insert %" PRIu64 "\n", __func__, i);
+            ++errors;
+        }
+    }
+    for (i = 0; i < TEST_MAP_ITEMS; i += 2)
+    {
+        numkey_map_put(&m, test_key(i), (i * 3)); // update
+    }
+    if (m.size != TEST_MAP_ITEMS)
+    {
+        (void) fprintf(stderr, "%s : Expected size %d, got %" PRIu64 "\n", __func__, TEST_MAP_ITEMS, m.size);
+        ++errors;
+    }
+    for (i = 0; i < TEST_MAP_ITEMS; i++)
+    {
+        if (!numkey_map_get(&m, test_key(i), &v) || (v != ((i & 1) ? i : (i * 3))))
+        {
+            (void) fprintf(stderr, "%s : Unexpected value for %" PRIu64 ": %" PRIu64 "\n", __func__, i, v);
+            ++errors;
+        }
+    }
+    if (numkey_map_get(&m, test_key(TEST_MAP_ITEMS), &v) || numkey_map_get(&m, numkey("US", "447911000000", 12), &v))
+    {
+        (void) fprintf(stderr, "%s : Unexpected value for a missing key\n", __func__);
+        ++errors;
+    }
+    for (i = 0; i < TEST_MAP_ITEMS; i += 3)
+    {
+        if (!numkey_map_del(&m, test_key(i)))
+        {
+            (void) fprintf(stderr, "%s : Unable to delete %" PRIu64 "\n", __func__, i);
+            ++errors;
+        }
+    }
+    if (numkey_map_del(&m, test_key(0)))
+    {
+        (void) fprintf(stderr, "%s : Unexpected deletion of a missing key\n", __func__);
+        ++errors;
+    }
+    // reinsert over the tombstones
+    for (i = TEST_MAP_ITEMS; i < (2 * TEST_MAP_ITEMS); i++)
+    {
+        numkey_map_put(&m, test_key(i), i);
+    }
+    for (i = 0; i < (2 * TEST_MAP_ITEMS); i++)
+    {
+        bool found = numkey_map_get(&m, test_key(i), &v);
+        bool deleted = ((i < TEST_MAP_ITEMS) && ((i % 3) == 0));
+        if (found == deleted)
+        {
+            (void) fprintf(stderr, "%s : Unexpected presence of %" PRIu64 "\n", __func__, i);
+            ++errors;
+        }
+    }
+    if ((m.used * 8) > (m.capacity * 7))
+    {
+        (void) fprintf(stderr, "%s : Unexpected load: %" PRIu64 " / %" PRIu64 "\n", __func__, m.used, m.capacity);
+        ++errors;
+    }
+    numkey_map_free(&m);
+    return errors;
+}
+
+// the hash of consecutive numbers must be evenly spread over the low bits used as bucket index
+int test_numkey_hash()
+{
+    int errors = 0;
+    static uint32_t buckets[1024];
+    uint64_t i = 0;
+    uint32_t max = 0;
+    memset(buckets, 0, sizeof(buckets));
+    for (i = 0; i < TEST_MAP_ITEMS; i++)
+    {
+        buckets[(numkey_hash(test_key(i)) & 1023)]++;
+    }
+    for (i = 0; i < 1024; i++)
+    {
+        if (buckets[i] > max)
+        {
+            max = buckets[i];
+        }
+    }
+    if (max > (2 * (TEST_MAP_ITEMS / 1024)))
+    {
+        (void) fprintf(stderr, "%s : Unexpected bucket size %" PRIu32 "\n", __func__, max);
+        ++errors;
+    }
+    return errors;
+}
+
+void benchmark_numkey_map_get()
+{
+    numkey_map_t m;
+    uint64_t i = 0, v = 0, sum = 0;
+    numkey_map_init(&m, 0);
+    for (i = 0; i < TEST_MAP_ITEMS; i++)
+    {
+        numkey_map_put(&m, test_key(i), i);
+    }
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_MAP_ITEMS; i++)
+    {
+        numkey_map_get(&m, test_key(((i * 7919) % TEST_MAP_ITEMS)), &v);
+        sum += v;
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/TEST_MAP_ITEMS, sum);
+    numkey_map_free(&m);
+}
+
+void benchmark_numkey_map_put()
+{
+    numkey_map_t m;
+    uint64_t i = 0;
+    numkey_map_init(&m, 0);
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_MAP_ITEMS; i++)
+    {
+        numkey_map_put(&m, test_key(i), i);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/TEST_MAP_ITEMS, m.capacity);
+    numkey_map_free(&m);
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_numkey_hash();
+    errors += test_numkey_map();
+
+    benchmark_numkey_map_put();
+    benchmark_numkey_map_get();
+
+    return errors;
+}
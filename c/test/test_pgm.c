@@ -0,0 +1,181 @@
+// NumKey
+//
+// test_pgm.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for pgm
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/pgm.h"
+#include "../src/numkey/numkey.h"
+#include "../src/numkey/set.h"
+
+#define TEST_PGM_ITEMS 1000000
+#define TEST_PGM_SEARCHES 100000
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+static inline uint64_t xorshift64(uint64_t *s)
+{
+    *s ^= (*s << 13);
+    *s ^= (*s >> 7);
+    *s ^= (*s << 17);
+    return *s;
+}
+
+// generates sorted random NumKeys over a few countries and number blocks, with some duplicates
+static inline uint64_t *test_keys(uint64_t nkeys)
+{
+    static const char *country[] = {"DE", "GB", "IT", "US"};
+    uint64_t *keys = (uint64_t *)malloc(((nkeys > 0) ? nkeys : 1) * sizeof(uint64_t));
+    uint64_t *tmp = (uint64_t *)malloc(((nkeys > 0) ? nkeys : 1) * sizeof(uint64_t));
+    uint64_t s = 0x9e3779b97f4a7c15, i = 0;
+    for (i = 0; i < nkeys; i++)
+    {
+        keys[i] = (numkey(country[(xorshift64(&s) % 4)], "", 0) | ((440000000000 + ((xorshift64(&s) % 8) * 10000000000) + (xorshift64(&s) % 100000000)) << NKBSHIFT_NUMBER) | 12);
+        if ((i > 0) && ((xorshift64(&s) % 10) == 0))
+        {
+            keys[i] = keys[(i - 1)];
+        }
+    }
+    sort_uint64_t(keys, tmp, (uint32_t)nkeys);
+    free(tmp);
+    return keys;
+}
+
+int test_pgm_keys(const uint64_t *keys, uint64_t nkeys, uint64_t epsilon)
+{
+    int errors = 0;
+    uint64_t i = 0, size = 0, first = 0, last = 0, exp = 0, pos = 0;
+    pgm_t pgm;
+    uint8_t *blob = pgm_build(keys, nkeys, epsilon, &size);
+    if ((blob == NULL) || !pgm_load(blob, size, &pgm) || (pgm.nrows != nkeys))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ", %" PRIu64 ") : Unable to build the model\n", __func__, nkeys, epsilon);
+        free(blob);
+        return 1;
+    }
+    for (i = 0; i < nkeys; i++)
+    {
+        first = 0;
+        last = nkeys;
+        exp = col_find_first_uint64_t(keys, &first, &last, keys[i]);
+        pos = pgm_find_first(&pgm, keys, keys[i]);
+        if (pos != exp)
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ", %" PRIu64 ") : Expected %" PRIu64 ", got %" PRIu64 " for row %" PRIu64 "\n", __func__, nkeys, epsilon, exp, pos, i);
+            ++errors;
+        }
+        pgm_range(&pgm, keys[i], &first, &last);
+        if ((last - first) > ((2 * epsilon) + 3))
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ", %" PRIu64 ") : Window too large: %" PRIu64 "\n", __func__, nkeys, epsilon, (last - first));
+            ++errors;
+        }
+        if (((i + 1) < nkeys) && ((keys[i] + 1) < keys[(i + 1)]) && (pgm_find_first(&pgm, keys, (keys[i] + 1)) != nkeys))
+        {
+            (void) fprintf(stderr, "%s (%" PRIu64 ", %" PRIu64 ") : Expected not found after row %" PRIu64 "\n", __func__, nkeys, epsilon, i);
+            ++errors;
+        }
+    }
+    if ((nkeys > 0) && (keys[0] > 0) && (pgm_find_first(&pgm, keys, 0) != nkeys))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ", %" PRIu64 ") : Expected not found for 0\n", __func__, nkeys, epsilon);
+        ++errors;
+    }
+    if ((nkeys > 0) && (keys[(nkeys - 1)] < UINT64_MAX) && (pgm_find_first(&pgm, keys, (keys[(nkeys - 1)] + 1)) != nkeys))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ", %" PRIu64 ") : Expected not found after the last key\n", __func__, nkeys, epsilon);
+        ++errors;
+    }
+    if (pgm_load(blob, (size - 8), &pgm))
+    {
+        (void) fprintf(stderr, "%s (%" PRIu64 ", %" PRIu64 ") : Expected invalid blob size\n", __func__, nkeys, epsilon);
+        ++errors;
+    }
+    free(blob);
+    return errors;
+}
+
+int test_pgm()
+{
+    int errors = 0;
+    uint64_t nkeys = 100000;
+    uint64_t *keys = test_keys(nkeys);
+    errors += test_pgm_keys(keys, 0, 16);
+    errors += test_pgm_keys(keys, 1, 16);
+    errors += test_pgm_keys(keys, nkeys, 0);
+    errors += test_pgm_keys(keys, nkeys, 1);
+    errors += test_pgm_keys(keys, nkeys, 16);
+    errors += test_pgm_keys(keys, nkeys, 64);
+    free(keys);
+    uint64_t edge[] = {0, 0, 0, 0, 0, 1, 2, 3, 1000, 0x8000000000000000, UINT64_MAX - 1};
+    errors += test_pgm_keys(edge, 11, 0);
+    errors += test_pgm_keys(edge, 11, 2);
+    return errors;
+}
+
+void benchmark_pgm_find_first(const uint64_t *keys, uint64_t nkeys, uint64_t epsilon)
+{
+    uint64_t i = 0, size = 0, sum = 0;
+    pgm_t pgm;
+    uint8_t *blob = pgm_build(keys, nkeys, epsilon, &size);
+    if ((blob == NULL) || !pgm_load(blob, size, &pgm))
+    {
+        free(blob);
+        return;
+    }
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_PGM_SEARCHES; i++)
+    {
+        sum += pgm_find_first(&pgm, keys, keys[((i * 7919) % nkeys)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s (epsilon %" PRIu64 ") : %" PRIu64 " ns/op (%" PRIu64 " segments, %" PRIu64 " bytes, %" PRIu64 ")\n", __func__, epsilon, (tend - tstart) / TEST_PGM_SEARCHES, pgm.nsegs, size, sum);
+    free(blob);
+}
+
+void benchmark_col_find_first(const uint64_t *keys, uint64_t nkeys)
+{
+    uint64_t i = 0, first = 0, last = 0, sum = 0;
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_PGM_SEARCHES; i++)
+    {
+        first = 0;
+        last = nkeys;
+        sum += col_find_first_uint64_t(keys, &first, &last, keys[((i * 7919) % nkeys)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %" PRIu64 " ns/op (%" PRIu64 ")\n", __func__, (tend - tstart) / TEST_PGM_SEARCHES, sum);
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_pgm();
+
+    uint64_t *keys = test_keys(TEST_PGM_ITEMS);
+    benchmark_col_find_first(keys, TEST_PGM_ITEMS);
+    benchmark_pgm_find_first(keys, TEST_PGM_ITEMS, 16);
+    benchmark_pgm_find_first(keys, TEST_PGM_ITEMS, 64);
+    benchmark_pgm_find_first(keys, TEST_PGM_ITEMS, 256);
+    free(keys);
+
+    return errors;
+}
@@ -81,13 +81,67 @@ void benchmark_prefixkey()
     (void) fprintf(stdout, " * %s : %lu ns/op\n", __func__, (tend - tstart)/size);
 }
 
+int test_prefixkey_norm()
+{
+    typedef struct test_norm_data_t
+    {
+        const char* number;
+        const char* digits;
+    } test_norm_data_t;
+    static const test_norm_data_t test_norm_data[] =
+    {
+        {"+44 (0)20 7946-0018", "442079460018"},
+        {"0044 20", "4420"},
+        {"+1-212-", "1212"},
+        {"", ""},
+        {"+1 234 567 890 123 456 789", "123456789012345"},
+    };
+    int errors = 0;
+    int i = 0;
+    uint64_t pk = 0, exp = 0;
+    size_t len = 0;
+    for (i=0 ; i < 5; i++)
+    {
+        len = prefixkey_norm(test_norm_data[i].number, strlen(test_norm_data[i].number), &pk);
+        exp = prefixkey(test_norm_data[i].digits, strlen(test_norm_data[i].digits));
+        if (len != strlen(test_norm_data[i].digits))
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected length: expected %zu, got %zu\n", __func__, i, strlen(test_norm_data[i].digits), len);
+            ++errors;
+        }
+        if (pk != exp)
+        {
+            (void) fprintf(stderr, "%s (%d): Unexpected prefixkey: expected 0x%016" PRIx64 ", got 0x%016" PRIx64 "\n", __func__, i, exp, pk);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void benchmark_prefixkey_norm()
+{
+    uint64_t tstart = 0, tend = 0;
+    uint64_t pk = 0;
+    int i = 0;
+    int size = 100000;
+    tstart = get_time();
+    for (i=0 ; i < size; i++)
+    {
+        prefixkey_norm("+44 (0)20 7946-0018", 19, &pk);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op (%" PRIu64 ")\n", __func__, (tend - tstart)/size, pk);
+}
+
 int main()
 {
     static int errors = 0;
 
     errors += test_prefixkey();
+    errors += test_prefixkey_norm();
 
     benchmark_prefixkey();
+    benchmark_prefixkey_norm();
 
     return errors;
 }
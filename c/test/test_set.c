@@ -59,6 +59,46 @@ void benchmark_sort_uint64_t()
     (void) fprintf(stdout, " * %s : %lu ns/op\n", __func__, (tend - tstart)/nitems);
 }
 
+int test_sort_uint128_t()
+{
+    int errors = 0;
+    // pairs of {lo, hi} words
+    uint64_t arr[20] = {8,1, 1,9, 9,1, 3,0, 2,0xff00000000000000, 7,1, 4,9, 0,0, 5,0xff00000000000000, 6,0};
+    uint64_t exp[20] = {0,0, 3,0, 6,0, 7,1, 8,1, 9,1, 1,9, 4,9, 2,0xff00000000000000, 5,0xff00000000000000};
+    uint64_t tmp[20];
+    sort_uint128_t(arr, tmp, 10);
+    uint32_t i = 0;
+    for(i = 0; i < 20; i++)
+    {
+        if (arr[i] != exp[i])
+        {
+            (void) fprintf(stderr, "%s (%" PRIu32 ") : Expected %" PRIx64 ", got %" PRIx64 "\n", __func__, i, exp[i], arr[i]);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void benchmark_sort_uint128_t()
+{
+    const uint32_t nitems = 100000;
+    uint64_t *arr = (uint64_t *)malloc(sizeof(uint64_t) * 2 * nitems);
+    uint64_t *tmp = (uint64_t *)malloc(sizeof(uint64_t) * 2 * nitems);
+    uint32_t i = 0;
+    for (i = 0; i < nitems; i++)
+    {
+        arr[(2 * i)] = ((uint64_t)(nitems - i) * 0x9e3779b97f4a7c15);
+        arr[(2 * i) + 1] = (0x4600000000000000 | (nitems - i));
+    }
+    uint64_t tstart = 0, tend = 0;
+    tstart = get_time();
+    sort_uint128_t(arr, tmp, nitems);
+    tend = get_time();
+    (void) fprintf(stdout, " * %s : %lu ns/op\n", __func__, (tend - tstart)/nitems);
+    free(arr);
+    free(tmp);
+}
+
 int test_order_uint64_t()
 {
     int errors = 0;
@@ -165,6 +205,35 @@ int test_unique_uint64_t_zero()
     return errors;
 }
 
+int test_unique_uint128_t()
+{
+    int errors = 0;
+    uint64_t arr[16] = {0,0, 1,0, 1,0, 1,0, 0,1, 0,1, 2,1, 2,1};
+    uint64_t exp[8] = {0,0, 1,0, 0,1, 2,1};
+    uint64_t *p = unique_uint128_t(arr, 8);
+    uint64_t n = (uint64_t)(p - arr);
+    if (n != 8)
+    {
+        (void) fprintf(stderr, "%s : Expected 8, got %" PRIu64 "\n", __func__, n);
+        return 1;
+    }
+    uint64_t i = 0;
+    for(i = 0; i < n; i++)
+    {
+        if (arr[i] != exp[i])
+        {
+            (void) fprintf(stderr, "%s : Expected %" PRIu64 ", got %" PRIu64 "\n", __func__, exp[i], arr[i]);
+            ++errors;
+        }
+    }
+    if (unique_uint128_t(arr, 0) != arr)
+    {
+        (void) fprintf(stderr, "%s : Expected empty array\n", __func__);
+        ++errors;
+    }
+    return errors;
+}
+
 int test_intersection_uint64_t()
 {
     int errors = 0;
@@ -248,15 +317,18 @@ int main()
     int errors = 0;
 
     errors += test_sort_uint64_t();
+    errors += test_sort_uint128_t();
     errors += test_order_uint64_t();
     errors += test_reverse_uint64_t();
     errors += test_unique_uint64_t();
     errors += test_unique_uint64_t_zero();
+    errors += test_unique_uint128_t();
     errors += test_intersection_uint64_t();
     errors += test_union_uint64_t();
     errors += test_union_uint64_t_ba();
 
     benchmark_sort_uint64_t();
+    benchmark_sort_uint128_t();
 
     return errors;
 }
\ No newline at end of file
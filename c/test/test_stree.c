@@ -0,0 +1,199 @@
+// NumKey
+//
+// test_stree.c
+//
+// @category   Tools
+// @author     Nicola Asuni
+// @license    see LICENSE file
+// @link       https://github.com/Vonage/numkey
+
+// Test for stree
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/numkey/stree.h"
+
+#define TEST_STREE_SEARCHES 100000
+
+// returns current time in nanoseconds
+uint64_t get_time()
+{
+    struct timespec t;
+    (void) timespec_get(&t, TIME_UTC);
+    return (((uint64_t)t.tv_sec * 1000000000) + (uint64_t)t.tv_nsec);
+}
+
+#define define_test_stree_compare(T) \
+int test_stree_compare_##T(const stree_t *st, const T *src, uint64_t first, uint64_t last, T search) \
+{ \
+    int errors = 0; \
+    uint64_t cfirst = first, clast = last, sfirst = first, slast = last; \
+    uint64_t exp = col_find_first_##T(src, &cfirst, &clast, search); \
+    uint64_t found = stree_find_first_##T(st, &sfirst, &slast, search); \
+    bool outside = ((last < st->nrows) && (src[last] == search)); /* col_find_first_T may match the item after the range */ \
+    if (!outside && ((found != exp) || (sfirst != cfirst) || (slast != clast))) \
+    { \
+        (void) fprintf(stderr, "%s FIRST [%" PRIu64 ", %" PRIu64 ") %" PRIx64 " : Expected %" PRIu64 " (%" PRIu64 ", %" PRIu64 "), got %" PRIu64 " (%" PRIu64 ", %" PRIu64 ")\n", __func__, first, last, (uint64_t)search, exp, cfirst, clast, found, sfirst, slast); \
+        ++errors; \
+    } \
+    if ((first >= last) || ((first > 0) && (src[(first - 1)] == search))) \
+    { \
+        return errors; /* col_find_last_T may match the item before the range */ \
+    } \
+    cfirst = first; \
+    clast = last; \
+    sfirst = first; \
+    slast = last; \
+    exp = col_find_last_##T(src, &cfirst, &clast, search); \
+    found = stree_find_last_##T(st, &sfirst, &slast, search); \
+    if ((found != exp) || (sfirst != cfirst) || (slast != clast)) \
+    { \
+        (void) fprintf(stderr, "%s LAST [%" PRIu64 ", %" PRIu64 ") %" PRIx64 " : Expected %" PRIu64 " (%" PRIu64 ", %" PRIu64 "), got %" PRIu64 " (%" PRIu64 ", %" PRIu64 ")\n", __func__, first, last, (uint64_t)search, exp, cfirst, clast, found, sfirst, slast); \
+        ++errors; \
+    } \
+    return errors; \
+}
+
+define_test_stree_compare(uint32_t)
+define_test_stree_compare(uint64_t)
+
+#define define_test_stree_file(T) \
+int test_stree_file_##T(mmfile_t mf, uint8_t col) \
+{ \
+    int errors = 0; \
+    uint64_t i, size = 0; \
+    stree_t st; \
+    const T *src = get_src_offset_##T(mf.src, mf.index[col]); \
+    uint8_t *blob = stree_build_mmfile_##T(&mf, col, &size); \
+    if ((blob == NULL) || !stree_load(blob, size, &st) || (st.nrows != mf.nrows)) \
+    { \
+        (void) fprintf(stderr, "%s : Unable to build the S+ tree\n", __func__); \
+        free(blob); \
+        return 1; \
+    } \
+    for (i = 0; i < mf.nrows; i++) \
+    { \
+        errors += test_stree_compare_##T(&st, src, 0, mf.nrows, src[i]); \
+        errors += test_stree_compare_##T(&st, src, 0, mf.nrows, (T)(src[i] + 1)); \
+        errors += test_stree_compare_##T(&st, src, (i / 2), (mf.nrows - (i / 3)), src[i]); \
+    } \
+    if (stree_build_mmfile_##T(&mf, 0, &size) != NULL) \
+    { \
+        (void) fprintf(stderr, "%s : Expected NULL for a column of a different type\n", __func__); \
+        ++errors; \
+    } \
+    free(blob); \
+    return errors; \
+}
+
+define_test_stree_file(uint32_t)
+define_test_stree_file(uint64_t)
+
+#define define_test_stree_random(T) \
+int test_stree_random_##T() \
+{ \
+    int errors = 0; \
+    uint64_t n, i, size = 0; \
+    T src[3000]; \
+    stree_t st; \
+    for (n = 0; n <= 3000; n += 149) \
+    { \
+        for (i = 0; i < n; i++) \
+        { \
+            src[i] = (T)(10 * (i / 3)); /* duplicates across the nodes */ \
+        } \
+        if (n > 1) \
+        { \
+            src[(n - 1)] = (T)(~(T)0); \
+        } \
+        uint8_t *blob = stree_build_##T(src, n, &size); \
+        if ((blob == NULL) || !stree_load(blob, size, &st)) \
+        { \
+            (void) fprintf(stderr, "%s (%" PRIu64 ") : Unable to build the S+ tree\n", __func__, n); \
+            free(blob); \
+            return (errors + 1); \
+        } \
+        for (i = 0; i < ((10 * (n / 3)) + 10); i += 5) \
+        { \
+            errors += test_stree_compare_##T(&st, src, 0, n, (T)i); \
+            errors += test_stree_compare_##T(&st, src, (n / 4), (n - (n / 4)), (T)i); \
+        } \
+        errors += test_stree_compare_##T(&st, src, 0, n, (T)(~(T)0)); \
+        if (stree_load(blob, (size - STREE_NODEBYTES), &st)) \
+        { \
+            (void) fprintf(stderr, "%s (%" PRIu64 ") : Expected invalid blob size\n", __func__, n); \
+            ++errors; \
+        } \
+        free(blob); \
+    } \
+    return errors; \
+}
+
+define_test_stree_random(uint32_t)
+define_test_stree_random(uint64_t)
+
+void benchmark_stree_find_first(mmfile_t mf, uint8_t col)
+{
+    uint64_t tstart, tend, first, last, i, size = 0, sum = 0;
+    stree_t st;
+    const uint64_t *src = get_src_offset_uint64_t(mf.src, mf.index[col]);
+    uint8_t *blob = stree_build_mmfile_uint64_t(&mf, col, &size);
+    if ((blob == NULL) || !stree_load(blob, size, &st))
+    {
+        free(blob);
+        return;
+    }
+    tstart = get_time();
+    for (i = 0; i < TEST_STREE_SEARCHES; i++)
+    {
+        first = 0;
+        last = mf.nrows;
+        sum += col_find_first_uint64_t(src, &first, &last, src[((i * 7919) % mf.nrows)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s col_find_first_uint64_t : %" PRIu64 " ns/op (%" PRIx64 ")\n", __func__, (tend - tstart) / TEST_STREE_SEARCHES, sum);
+    sum = 0;
+    tstart = get_time();
+    for (i = 0; i < TEST_STREE_SEARCHES; i++)
+    {
+        first = 0;
+        last = mf.nrows;
+        sum += stree_find_first_uint64_t(&st, &first, &last, src[((i * 7919) % mf.nrows)]);
+    }
+    tend = get_time();
+    (void) fprintf(stdout, " * %s stree_find_first_uint64_t : %" PRIu64 " ns/op (%" PRIx64 ")\n", __func__, (tend - tstart) / TEST_STREE_SEARCHES, sum);
+    free(blob);
+}
+
+int main()
+{
+    int errors = 0;
+
+    char *file = "test_data_col.bin"; // file containing test data
+
+    mmfile_t mf = {0};
+    mf.ncols = 4;
+    mf.ctbytes[0] = 1;
+    mf.ctbytes[1] = 2;
+    mf.ctbytes[2] = 4;
+    mf.ctbytes[3] = 8;
+    mmap_binfile(file, &mf);
+    if ((mf.fd < 0) || (mf.size == 0) || (mf.src == MAP_FAILED))
+    {
+        (void) fprintf(stderr, "can't open %s for reading [%s]\n", file, strerror(errno));
+        return 1;
+    }
+    errors += test_stree_file_uint32_t(mf, 2);
+    errors += test_stree_file_uint64_t(mf, 3);
+    benchmark_stree_find_first(mf, 3);
+    (void) munmap_binfile(mf);
+
+    errors += test_stree_random_uint32_t();
+    errors += test_stree_random_uint64_t();
+
+    return errors;
+}